@@ -0,0 +1,177 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#include "CCDBSnapshot.h"
+
+#include <algorithm>
+#include <map>
+#include <string>
+
+#include <TDirectory.h>
+#include <TTree.h>
+
+void CCDBSnapshot::init(o2::ccdb::BasicCCDBManager* ccdb, int mode, std::string const& bundleFileName)
+{
+  close();
+  mCCDB = ccdb;
+  mMode = mode;
+  mBundleFileName = bundleFileName;
+  mIndex.clear();
+  mRunCache.clear();
+  mNRecorded = 0;
+  mRunNumber = -1;
+  mRunDuration = {0, 0};
+  if (mMode == kDirect) {
+    return;
+  }
+  if (mBundleFileName.empty()) {
+    LOGF(fatal, "CCDBSnapshot: no bundle file given");
+  }
+
+  // opening the bundle must not change the current directory, where the tasks create their histograms
+  TDirectory::TContext context;
+  if (mMode == kRecord) {
+    mFile.reset(TFile::Open(mBundleFileName.c_str(), "RECREATE"));
+    if (!mFile || mFile->IsZombie()) {
+      LOGF(fatal, "CCDBSnapshot: bundle %s could not be created", mBundleFileName.c_str());
+    }
+    LOGF(info, "CCDBSnapshot: recording CCDB objects from %s to %s", mCCDB->getURL().c_str(), mBundleFileName.c_str());
+    return;
+  }
+
+  if (mMode != kReplay) {
+    LOGF(fatal, "CCDBSnapshot: unknown mode %d", mMode);
+  }
+  mFile.reset(TFile::Open(mBundleFileName.c_str(), "READ"));
+  if (!mFile || mFile->IsZombie()) {
+    LOGF(fatal, "CCDBSnapshot: bundle %s could not be opened", mBundleFileName.c_str());
+  }
+  TTree* index = mFile->Get<TTree>("ccdbIndex");
+  if (!index) {
+    LOGF(fatal, "CCDBSnapshot: bundle %s has no index", mBundleFileName.c_str());
+  }
+  std::string* key = nullptr;
+  std::string* objectName = nullptr;
+  Long64_t validFrom = 0;
+  Long64_t validUntil = 0;
+  index->SetBranchAddress("key", &key);
+  index->SetBranchAddress("objectName", &objectName);
+  index->SetBranchAddress("validFrom", &validFrom);
+  index->SetBranchAddress("validUntil", &validUntil);
+  for (Long64_t i = 0; i < index->GetEntries(); i++) {
+    index->GetEntry(i);
+    Entry entry;
+    entry.validFrom = validFrom;
+    entry.validUntil = validUntil;
+    entry.objectName = *objectName;
+    mIndex[*key].push_back(entry);
+  }
+  for (auto& [path, entries] : mIndex) {
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.validFrom < b.validFrom; });
+  }
+  LOGF(info, "CCDBSnapshot: replaying %lld CCDB objects from %s", static_cast<long long>(index->GetEntries()), mBundleFileName.c_str());
+  delete index;
+}
+
+void CCDBSnapshot::close()
+{
+  if (!mFile) {
+    return;
+  }
+  if (mMode == kRecord) {
+    TDirectory::TContext context(mFile.get());
+    TTree index("ccdbIndex", "Index of the recorded CCDB objects");
+    std::string key;
+    std::string objectName;
+    Long64_t validFrom = 0;
+    Long64_t validUntil = 0;
+    index.Branch("key", &key);
+    index.Branch("objectName", &objectName);
+    index.Branch("validFrom", &validFrom);
+    index.Branch("validUntil", &validUntil);
+    for (const auto& [entryKey, entries] : mIndex) {
+      for (const auto& entry : entries) {
+        key = entryKey;
+        objectName = entry.objectName;
+        validFrom = entry.validFrom;
+        validUntil = entry.validUntil;
+        index.Fill();
+      }
+    }
+    index.Write();
+    LOGF(info, "CCDBSnapshot: %lld CCDB objects recorded to %s", static_cast<long long>(index.GetEntries()), mBundleFileName.c_str());
+  }
+  mRunCache.clear();
+  mIndex.clear(); // releases the replayed objects
+  mFile->Close();
+  mFile.reset();
+}
+
+void CCDBSnapshot::setRun(int runNumber)
+{
+  if (runNumber == mRunNumber) {
+    return;
+  }
+  mRunNumber = runNumber;
+  if (mMode == kRecord) {
+    mRunDuration = mCCDB->getRunDuration(runNumber, false);
+  }
+}
+
+std::string CCDBSnapshot::makeKey(std::string const& path, std::map<std::string, std::string> const& metadata)
+{
+  std::string key = path;
+  for (const auto& [name, value] : metadata) {
+    key += ";" + name + "=" + value;
+  }
+  return key;
+}
+
+CCDBSnapshot::Entry* CCDBSnapshot::findEntry(std::string const& key, int64_t timestamp)
+{
+  auto found = mIndex.find(key);
+  if (found == mIndex.end()) {
+    return nullptr;
+  }
+  auto& entries = found->second;
+  auto next = std::upper_bound(entries.begin(), entries.end(), timestamp, [](int64_t ts, const Entry& entry) { return ts < entry.validFrom; });
+  if (next == entries.begin()) {
+    return nullptr;
+  }
+  --next;
+  return (timestamp < next->validUntil) ? &(*next) : nullptr;
+}
+
+std::string CCDBSnapshot::addEntry(std::string const& key, std::map<std::string, std::string> const& headers, int64_t timestamp)
+{
+  Entry entry;
+  auto validFrom = headers.find("Valid-From");
+  auto validUntil = headers.find("Valid-Until");
+  if (validFrom != headers.end() && validUntil != headers.end() && std::stoll(validFrom->second) <= timestamp && timestamp < std::stoll(validUntil->second)) {
+    entry.validFrom = std::stoll(validFrom->second);
+    entry.validUntil = std::stoll(validUntil->second);
+  } else if (mRunDuration.first <= timestamp && timestamp < mRunDuration.second) {
+    LOGF(warning, "CCDBSnapshot: no validity for %s at timestamp %lld, the object is recorded for run %d", key.c_str(), static_cast<long long>(timestamp), mRunNumber);
+    entry.validFrom = mRunDuration.first;
+    entry.validUntil = mRunDuration.second;
+  } else {
+    LOGF(warning, "CCDBSnapshot: no validity for %s at timestamp %lld outside of the run set with setRun, the object is recorded for this timestamp only", key.c_str(), static_cast<long long>(timestamp));
+    entry.validFrom = timestamp;
+    entry.validUntil = timestamp + 1;
+  }
+  entry.objectName = "object_" + std::to_string(mNRecorded++);
+
+  auto& entries = mIndex[key];
+  auto position = std::upper_bound(entries.begin(), entries.end(), entry.validFrom, [](int64_t ts, const Entry& other) { return ts < other.validFrom; });
+  entries.insert(position, entry);
+  LOGF(info, "CCDBSnapshot: recording %s valid in [%lld, %lld) as %s", key.c_str(), static_cast<long long>(entry.validFrom), static_cast<long long>(entry.validUntil), entry.objectName.c_str());
+  return entry.objectName;
+}
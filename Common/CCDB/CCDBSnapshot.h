@@ -0,0 +1,135 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#ifndef COMMON_CCDB_CCDBSNAPSHOT_H_
+#define COMMON_CCDB_CCDBSNAPSHOT_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <TClass.h>
+#include <TFile.h>
+
+#include "CCDB/BasicCCDBManager.h"
+#include "Framework/Logger.h"
+
+// Records the CCDB objects fetched by a task into a local bundle (a ROOT file) and replays them from it without
+// network access, for reproducible local running and benchmarks.
+//
+// In record mode, every object is fetched through the CCDB manager as usual and written once per validity interval
+// to the bundle, together with its path, metadata and validity. In replay mode, the index of the bundle is read at
+// initialisation and the objects are read on first use and kept in memory. In direct mode, calls are forwarded to
+// the CCDB manager.
+//
+// getForRun keeps the object found at the first request of a run for the whole run, replacing the per-run caches
+// of the tasks.
+//
+// The validity of a recorded object is taken from the headers returned with it by the CCDB manager. If they are missing,
+// the object is recorded for the run given with setRun (or to getForRun), so that it is written once per run and not
+// once per timestamp.
+class CCDBSnapshot
+{
+ public:
+  enum Mode { kDirect = 0, // objects are fetched from the CCDB
+              kRecord,     // objects are fetched from the CCDB and written to the bundle
+              kReplay };   // objects are read from the bundle only
+
+  CCDBSnapshot() = default;
+  CCDBSnapshot(const CCDBSnapshot&) = delete;
+  CCDBSnapshot& operator=(const CCDBSnapshot&) = delete;
+  ~CCDBSnapshot() { close(); }
+
+  void init(o2::ccdb::BasicCCDBManager* ccdb, int mode, std::string const& bundleFileName);
+  // writes the index of a recorded bundle and closes it, called also at destruction
+  void close();
+  int getMode() const { return mMode; }
+  // run of the following requests, its duration is the validity of recorded objects without validity in their headers
+  void setRun(int runNumber);
+
+  template <typename T>
+  T* getSpecific(std::string const& path, int64_t timestamp, std::map<std::string, std::string> const& metadata = {})
+  {
+    if (mMode == kDirect) {
+      return mCCDB->getSpecific<T>(path, timestamp, metadata);
+    }
+    std::string key = makeKey(path, metadata);
+    Entry* entry = findEntry(key, timestamp);
+    if (mMode == kReplay) {
+      if (!entry) {
+        LOGF(fatal, "CCDBSnapshot: no object for %s at timestamp %lld in bundle %s", key.c_str(), static_cast<long long>(timestamp), mBundleFileName.c_str());
+      }
+      if (!entry->object) {
+        TClass* cl = TClass::GetClass<T>();
+        void* object = mFile->GetObjectChecked(entry->objectName.c_str(), cl);
+        if (!object) {
+          LOGF(fatal, "CCDBSnapshot: object %s for %s could not be read from bundle %s", entry->objectName.c_str(), key.c_str(), mBundleFileName.c_str());
+        }
+        entry->object = std::shared_ptr<void>(object, [cl](void* ptr) { cl->Destructor(ptr); });
+      }
+      return static_cast<T*>(entry->object.get());
+    }
+
+    // record mode: the object is owned by the CCDB manager, its validity is in the headers of the same request
+    std::map<std::string, std::string> headers;
+    T* object = mCCDB->getSpecific<T>(path, timestamp, metadata, &headers);
+    if (object && !entry) {
+      std::string objectName = addEntry(key, headers, timestamp);
+      mFile->WriteObjectAny(object, TClass::GetClass<T>(), objectName.c_str());
+    }
+    return object;
+  }
+
+  template <typename T>
+  T* getForTimeStamp(std::string const& path, int64_t timestamp)
+  {
+    return getSpecific<T>(path, timestamp);
+  }
+
+  template <typename T>
+  T* getForRun(std::string const& path, int runNumber, int64_t timestamp, std::map<std::string, std::string> const& metadata = {})
+  {
+    auto& cached = mRunCache[makeKey(path, metadata)];
+    if (cached.first != runNumber || !cached.second) {
+      setRun(runNumber);
+      cached = {runNumber, getSpecific<T>(path, timestamp, metadata)};
+    }
+    return static_cast<T*>(cached.second);
+  }
+
+ private:
+  struct Entry {
+    int64_t validFrom = 0;
+    int64_t validUntil = 0; // exclusive
+    std::string objectName;
+    std::shared_ptr<void> object; // only in replay mode
+  };
+
+  static std::string makeKey(std::string const& path, std::map<std::string, std::string> const& metadata);
+  Entry* findEntry(std::string const& key, int64_t timestamp);
+  std::string addEntry(std::string const& key, std::map<std::string, std::string> const& headers, int64_t timestamp);
+
+  int mMode = kDirect;
+  o2::ccdb::BasicCCDBManager* mCCDB = nullptr;
+  int mRunNumber = -1;
+  std::pair<int64_t, int64_t> mRunDuration = {0, 0}; // start and end of mRunNumber, only in record mode
+  std::string mBundleFileName;
+  std::unique_ptr<TFile> mFile;
+  int mNRecorded = 0;
+  std::unordered_map<std::string, std::vector<Entry>> mIndex;    // entries per path and metadata, sorted by validity
+  std::unordered_map<std::string, std::pair<int, void*>> mRunCache; // run number and object per path and metadata
+};
+
+#endif // COMMON_CCDB_CCDBSNAPSHOT_H_
@@ -0,0 +1,140 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file BcLookup.h
+/// \brief Sorted per-DF global BC lookup for exact, closest and range searches
+
+#ifndef COMMON_CORE_BCLOOKUP_H_
+#define COMMON_CORE_BCLOOKUP_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace bclookup
+{
+/// Global BCs of a DF (e.g. the BCs with a given trigger or detector signal) with a value per BC (e.g. the index of
+/// the BC or of the FT0 row, or a struct with the side information needed by the searches). Replaces
+/// std::map<globalBC, value> for the lookups done once per collision or candidate:
+///
+///   lookup.clear();
+///   for (auto const& ft0 : ft0s) { if (isTVX(ft0)) { lookup.add(ft0.bc().globalBC(), ft0.globalIndex()); } }
+///   lookup.build();
+///   int pos = lookup.findClosest(globalBC);
+///   if (pos >= 0) { auto ft0 = ft0s.iteratorAt(lookup.getValue(pos)); int64_t dist = globalBC - lookup.getGlobalBC(pos); }
+///
+/// The BCs are kept in two sorted arrays (BCs and values), so the searches are binary searches, the neighbours of an
+/// entry in time are the entries at pos - 1 and pos + 1 and a range of BCs is a range of positions. As for a map
+/// filled with lookup[bc] = value, the last value added for a BC is kept. The buffers are reused between DFs if the
+/// lookup is a member of the task.
+template <typename T = int32_t>
+class BcLookup
+{
+ public:
+  void clear()
+  {
+    mGlobalBCs.clear();
+    mValues.clear();
+  }
+
+  void reserve(std::size_t n)
+  {
+    mGlobalBCs.reserve(n);
+    mValues.reserve(n);
+  }
+
+  /// Adds an entry, the entries are searchable after build()
+  void add(int64_t globalBC, T const& value)
+  {
+    mGlobalBCs.push_back(globalBC);
+    mValues.push_back(value);
+  }
+
+  /// Sorts the entries by BC and keeps the last value added for each BC
+  void build()
+  {
+    const std::size_t n = mGlobalBCs.size();
+    if (std::is_sorted(mGlobalBCs.begin(), mGlobalBCs.end()) &&
+        std::adjacent_find(mGlobalBCs.begin(), mGlobalBCs.end()) == mGlobalBCs.end()) {
+      return; // typical case: tables sorted by BC, one row per BC
+    }
+    mOrder.resize(n);
+    std::iota(mOrder.begin(), mOrder.end(), 0);
+    std::stable_sort(mOrder.begin(), mOrder.end(), [this](std::size_t a, std::size_t b) { return mGlobalBCs[a] < mGlobalBCs[b]; });
+    mSortedGlobalBCs.clear();
+    mSortedValues.clear();
+    for (std::size_t i = 0; i < n; i++) {
+      const std::size_t entry = mOrder[i];
+      if (!mSortedGlobalBCs.empty() && mSortedGlobalBCs.back() == mGlobalBCs[entry]) {
+        mSortedValues.back() = mValues[entry]; // same BC, later entry wins
+      } else {
+        mSortedGlobalBCs.push_back(mGlobalBCs[entry]);
+        mSortedValues.push_back(mValues[entry]);
+      }
+    }
+    mGlobalBCs.swap(mSortedGlobalBCs);
+    mValues.swap(mSortedValues);
+  }
+
+  int size() const { return mGlobalBCs.size(); }
+  bool empty() const { return mGlobalBCs.empty(); }
+  int64_t getGlobalBC(int pos) const { return mGlobalBCs[pos]; }
+  T const& getValue(int pos) const { return mValues[pos]; }
+  T& getValue(int pos) { return mValues[pos]; }
+
+  /// Position of globalBC, -1 if not found
+  int find(int64_t globalBC) const
+  {
+    int pos = lowerBound(globalBC);
+    return (pos < size() && mGlobalBCs[pos] == globalBC) ? pos : -1;
+  }
+
+  /// Position of the first entry with BC >= globalBC (size() if none)
+  int lowerBound(int64_t globalBC) const
+  {
+    return std::lower_bound(mGlobalBCs.begin(), mGlobalBCs.end(), globalBC) - mGlobalBCs.begin();
+  }
+
+  /// Position of the first entry with BC > globalBC (size() if none)
+  int upperBound(int64_t globalBC) const
+  {
+    return std::upper_bound(mGlobalBCs.begin(), mGlobalBCs.end(), globalBC) - mGlobalBCs.begin();
+  }
+
+  /// Position of the entry closest in BC to globalBC, the later one if two are equally close, -1 if empty
+  int findClosest(int64_t globalBC) const
+  {
+    if (empty()) {
+      return -1;
+    }
+    int pos = lowerBound(globalBC);
+    if (pos == size()) {
+      return pos - 1;
+    }
+    if (pos > 0 && globalBC - mGlobalBCs[pos - 1] < mGlobalBCs[pos] - globalBC) {
+      return pos - 1;
+    }
+    return pos;
+  }
+
+ private:
+  std::vector<int64_t> mGlobalBCs;
+  std::vector<T> mValues;
+  // build() buffers
+  std::vector<std::size_t> mOrder;
+  std::vector<int64_t> mSortedGlobalBCs;
+  std::vector<T> mSortedValues;
+};
+} // namespace bclookup
+
+#endif // COMMON_CORE_BCLOOKUP_H_
@@ -0,0 +1,73 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file CalibrationLookup.cxx
+/// \brief Flat look-up objects compiled from histogram and graph calibrations
+
+#include "Common/Core/CalibrationLookup.h"
+
+#include <TAxis.h>
+#include <TGraph.h>
+#include <TH1.h>
+
+#include "Framework/Logger.h"
+
+CalibrationAxis::CalibrationAxis(const TAxis* axis) : mNbins(axis->GetNbins()),
+                                                      mMin(axis->GetXmin()),
+                                                      mMax(axis->GetXmax())
+{
+  if (axis->IsVariableBinSize()) {
+    mEdges.assign(axis->GetXbins()->GetArray(), axis->GetXbins()->GetArray() + mNbins + 1);
+  }
+  // the bin centers are taken from the axis itself, so that the interpolation uses exactly the same values
+  mCenters.resize(mNbins + 2);
+  for (int bin = 0; bin <= mNbins + 1; bin++) {
+    mCenters[bin] = axis->GetBinCenter(bin);
+  }
+}
+
+CalibrationHistogram::CalibrationHistogram(const TH1* hist)
+{
+  if (!hist) {
+    LOGF(fatal, "CalibrationHistogram: no histogram given");
+  }
+  mDimension = hist->GetDimension();
+  mAxes[0] = CalibrationAxis(hist->GetXaxis());
+  if (mDimension > 1) {
+    mAxes[1] = CalibrationAxis(hist->GetYaxis());
+  }
+  if (mDimension > 2) {
+    mAxes[2] = CalibrationAxis(hist->GetZaxis());
+  }
+  mStrideY = hist->GetNbinsX() + 2;
+  mStrideZ = mStrideY * (hist->GetNbinsY() + 2);
+  long nCells = mStrideZ * (hist->GetNbinsZ() + 2);
+  // virtual GetBinContent, i.e. the mean for profiles
+  mContents.resize(nCells);
+  for (long bin = 0; bin < nCells; bin++) {
+    mContents[bin] = hist->GetBinContent(bin);
+  }
+}
+
+CalibrationGraph::CalibrationGraph(const TGraph* graph)
+{
+  if (!graph) {
+    LOGF(fatal, "CalibrationGraph: no graph given");
+  }
+  int n = graph->GetN();
+  mX.assign(graph->GetX(), graph->GetX() + n);
+  mY.assign(graph->GetY(), graph->GetY() + n);
+  for (int i = 1; i < n; i++) {
+    if (!(mX[i - 1] < mX[i])) {
+      LOGF(fatal, "CalibrationGraph: the points of graph %s are not in increasing x", graph->GetName());
+    }
+  }
+}
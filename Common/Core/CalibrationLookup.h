@@ -0,0 +1,185 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file CalibrationLookup.h
+/// \brief Flat look-up objects compiled from histogram and graph calibrations
+
+#ifndef COMMON_CORE_CALIBRATIONLOOKUP_H_
+#define COMMON_CORE_CALIBRATIONLOOKUP_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+class TAxis;
+class TH1;
+class TGraph;
+
+// Calibration objects fetched from the CCDB (TH1/TH2/TH3, TProfile, TGraph) are copied once into flat arrays. The
+// look-up is then a bin search on plain arrays, without virtual calls into ROOT, and the objects are immutable after
+// construction, so they can be shared between threads. The results are the same as the ROOT calls they replace:
+// GetBinContent(FindFixBin(...)), TH1::Interpolate and TGraph::Eval (linear).
+
+// Axis with the same bin search as TAxis::FindFixBin (0 = underflow, nBins + 1 = overflow)
+class CalibrationAxis
+{
+ public:
+  CalibrationAxis() = default;
+  explicit CalibrationAxis(const TAxis* axis);
+
+  int getNbins() const { return mNbins; }
+
+  int findFixBin(double x) const
+  {
+    if (x < mMin) {
+      return 0;
+    }
+    if (!(x < mMax)) {
+      return mNbins + 1;
+    }
+    if (mEdges.empty()) {
+      return 1 + static_cast<int>(mNbins * (x - mMin) / (mMax - mMin));
+    }
+    return std::upper_bound(mEdges.begin(), mEdges.end(), x) - mEdges.begin();
+  }
+
+  // bin in [0, nBins + 1], as TAxis::GetBinCenter
+  double getBinCenter(int bin) const { return mCenters[bin]; }
+
+ private:
+  int mNbins = 0;
+  double mMin = 0.;
+  double mMax = 0.;
+  std::vector<double> mEdges;   // only for variable bin size
+  std::vector<double> mCenters; // including under- and overflow bin
+};
+
+// Histogram calibration with 1 to 3 dimensions, bin contents in the TH3 global bin layout
+class CalibrationHistogram
+{
+ public:
+  enum Mode { NearestBin = 0,
+              Interpolated };
+
+  CalibrationHistogram() = default;
+  explicit CalibrationHistogram(const TH1* hist);
+
+  bool isValid() const { return !mContents.empty(); }
+  int getDimension() const { return mDimension; }
+
+  // GetBinContent(FindFixBin(...))
+  double getBinContent(double x) const { return mContents[mAxes[0].findFixBin(x)]; }
+  double getBinContent(double x, double y) const { return mContents[mAxes[0].findFixBin(x) + mStrideY * mAxes[1].findFixBin(y)]; }
+  double getBinContent(double x, double y, double z) const
+  {
+    return mContents[mAxes[0].findFixBin(x) + mStrideY * mAxes[1].findFixBin(y) + mStrideZ * mAxes[2].findFixBin(z)];
+  }
+
+  // TH1::Interpolate(x), only for one-dimensional histograms
+  double interpolate(double x) const
+  {
+    const CalibrationAxis& axis = mAxes[0];
+    int nBins = axis.getNbins();
+    if (std::isnan(x)) {
+      return x;
+    }
+    if (x <= axis.getBinCenter(1)) {
+      return mContents[1];
+    }
+    if (x >= axis.getBinCenter(nBins)) {
+      return mContents[nBins];
+    }
+    int bin = axis.findFixBin(x);
+    if (x <= axis.getBinCenter(bin)) {
+      bin--;
+    }
+    double x0 = axis.getBinCenter(bin);
+    double x1 = axis.getBinCenter(bin + 1);
+    double y0 = mContents[bin];
+    double y1 = mContents[bin + 1];
+    return y0 + (x - x0) * ((y1 - y0) / (x1 - x0));
+  }
+
+  double evaluate(double x, Mode mode) const { return (mode == Interpolated) ? interpolate(x) : getBinContent(x); }
+
+  // batch evaluation of a one-dimensional calibration, out must have at least the size of x
+  template <typename TInput, typename TOutput>
+  void evaluate(const TInput& x, TOutput& out, Mode mode) const
+  {
+    if (mode == Interpolated) {
+      for (std::size_t i = 0; i < x.size(); i++) {
+        out[i] = interpolate(x[i]);
+      }
+    } else {
+      for (std::size_t i = 0; i < x.size(); i++) {
+        out[i] = getBinContent(x[i]);
+      }
+    }
+  }
+
+ private:
+  int mDimension = 0;
+  CalibrationAxis mAxes[3];
+  long mStrideY = 0;
+  long mStrideZ = 0;
+  std::vector<double> mContents;
+};
+
+// TGraph calibration with increasing x, evaluated as TGraph::Eval with linear interpolation (and extrapolation)
+class CalibrationGraph
+{
+ public:
+  CalibrationGraph() = default;
+  explicit CalibrationGraph(const TGraph* graph);
+
+  bool isValid() const { return !mX.empty(); }
+
+  double eval(double x) const
+  {
+    std::size_t n = mX.size();
+    if (n == 0) {
+      return 0.;
+    }
+    if (n == 1 || std::isnan(x)) {
+      return mY[0];
+    }
+    std::size_t up = std::upper_bound(mX.begin(), mX.end(), x) - mX.begin();
+    if (up > 0 && mX[up - 1] == x) {
+      return mY[up - 1];
+    }
+    std::size_t low;
+    if (up == n) { // above the last point: extrapolate from the last two points
+      up = n - 1;
+      low = n - 2;
+    } else if (up == 0) { // below the first point: extrapolate from the first two points
+      low = 0;
+      up = 1;
+    } else {
+      low = up - 1;
+    }
+    return mY[up] + (x - mX[up]) * (mY[low] - mY[up]) / (mX[low] - mX[up]);
+  }
+
+  template <typename TInput, typename TOutput>
+  void evaluate(const TInput& x, TOutput& out) const
+  {
+    for (std::size_t i = 0; i < x.size(); i++) {
+      out[i] = eval(x[i]);
+    }
+  }
+
+ private:
+  std::vector<double> mX;
+  std::vector<double> mY;
+};
+
+#endif // COMMON_CORE_CALIBRATIONLOOKUP_H_
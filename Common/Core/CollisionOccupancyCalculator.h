@@ -0,0 +1,476 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file CollisionOccupancyCalculator.h
+/// \brief Occupancy estimators and time-pattern flags for the collisions of a DF
+
+#ifndef COMMON_CORE_COLLISIONOCCUPANCYCALCULATOR_H_
+#define COMMON_CORE_COLLISIONOCCUPANCYCALCULATOR_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include "CommonConstants/LHCConstants.h"
+
+// Calculates the occupancy of each collision from the other collisions in a time window around it (within the same TF)
+// and the flags for nearby collisions in time and in the same ITS ROF.
+//
+// The collisions are sorted once by their bc, so all the neighbours of a collision in any time range form a contiguous
+// range in this order. The window bounds are kept with two pointers while sweeping through the collisions of a TF, and
+// the track counts of the fixed veto ranges are differences of prefix sums.
+// The occupancy estimators are by default summed over the collisions in the window with the float weights and the
+// per-collision truncation of the integer track sum of the original implementation, so the stored values do not change.
+// With setUseMomentSums(true), they are instead calculated from running sums of the 0th, 1st and 2nd moments of the
+// time differences in each (piecewise polynomial) weight segment, which are shifted to each collision in turn. This is
+// O(N) per TF, but the track occupancy is then truncated once instead of per collision, so it can differ from the
+// default one by up to the number of collisions in the window.
+// The veto on collisions with high FT0C amplitude and the vZ-dependent veto, which depend on the vZ of both
+// collisions, loop over the collisions in the (short) vZ-dependent time range.
+class CollisionOccupancyCalculator
+{
+ public:
+  enum OccupancyFlag { NoCollInTimeRangeNarrow = 0,
+                       NoCollInTimeRangeStrict,
+                       NoCollInTimeRangeStandard,
+                       NoCollInTimeRangeVzDependent,
+                       NoCollInRofStrict,
+                       NoCollInRofStandard,
+                       NoCollInRofWithCloseVz };
+
+  // weight c0 + c1 * x + c2 * x^2 with x = dt - center for dt in [min, max) (us)
+  struct WeightSegment {
+    float min;
+    float max;
+    float center;
+    double c0;
+    double c1;
+    double c2;
+  };
+
+  CollisionOccupancyCalculator()
+  {
+    // default delta-time weights (dt in us), written such that they are evaluated as in the original formulas
+    mWeightSegments = {{-40, -5, -40, 0., 0., 1. / 1225},           // collisions in the past: (dt + 40)^2 / 1225
+                       {-5, 15, 0, 1., 0., 0.},                     // collisions near a given one
+                       {15, 40, 0, 1.24, -0.4 / 25, 0.},            // collisions from the future
+                       {40, 100, 0, 0.6 + 0.8 / 3, -0.4 / 60, 0.}}; // collisions from the distant future
+  }
+
+  // configuration
+  void setTimeWindow(float minUS, float maxUS)
+  {
+    mTimeWinMinNS = minUS * 1e3;
+    mTimeWinMaxNS = maxUS * 1e3;
+  }
+  void setUseWeights(bool useWeights) { mUseWeights = useWeights; }
+  void setUseMomentSums(bool useMomentSums) { mUseMomentSums = useMomentSums; }
+  void setWeightSegments(const std::vector<WeightSegment>& segments) { mWeightSegments = segments; }
+  void setTimeRangeVetoNarrow(float rangeUS) { mTimeRangeVetoNarrow = rangeUS; }
+  void setTimeRangeVetoStandard(float rangeUS) { mTimeRangeVetoStandard = rangeUS; }
+  void setFT0CamplCutInTimeRange(float cut) { mFT0CamplCutInTimeRange = cut; }
+  void setEpsilonVzDependentVeto(float epsilon) { mEpsilonVzDependentVeto = epsilon; }
+  void setFT0CamplCutInROF(float cut) { mFT0CamplCutInROF = cut; }
+  void setEpsilonVzDiffInROF(float epsilon) { mEpsilonVzDiffInROF = epsilon; }
+  void setTimeFrame(int64_t bcSOR, int64_t nBCsPerTF, int rofOffset, int rofLength)
+  {
+    mBcSOR = bcSOR;
+    mNBCsPerTF = nBCsPerTF;
+    mRofOffset = rofOffset;
+    mRofLength = rofLength;
+  }
+
+  // input: one entry per collision, the collision index is the order of the calls
+  void clear()
+  {
+    mBC.clear();
+    mVz.clear();
+    mNTracks.clear();
+    mAmpFT0C.clear();
+    mIsFullInfo.clear();
+  }
+  void reserve(int n)
+  {
+    mBC.reserve(n);
+    mVz.reserve(n);
+    mNTracks.reserve(n);
+    mAmpFT0C.reserve(n);
+    mIsFullInfo.reserve(n);
+  }
+  void addCollision(int64_t globalBC, float vZ, int nTracksITS567, float ampFT0C, bool isFullInfo)
+  {
+    mBC.push_back(globalBC);
+    mVz.push_back(vZ);
+    mNTracks.push_back(nTracksITS567);
+    mAmpFT0C.push_back(ampFT0C);
+    mIsFullInfo.push_back(isFullInfo);
+  }
+
+  void calculate()
+  {
+    const int n = mBC.size();
+    mTrackOccupancy.assign(n, -1);
+    mFT0COccupancy.assign(n, -1);
+    mFlags.assign(n, 0);
+    if (n == 0) {
+      return;
+    }
+
+    mOrder.resize(n);
+    std::iota(mOrder.begin(), mOrder.end(), 0);
+    std::stable_sort(mOrder.begin(), mOrder.end(), [this](int a, int b) { return mBC[a] < mBC[b]; });
+
+    // prefix sums of the track counts in the sorted order
+    mSumTracks.assign(n + 1, 0.);
+    for (int p = 0; p < n; p++) {
+      mSumTracks[p + 1] = mSumTracks[p] + mNTracks[mOrder[p]];
+    }
+
+    // weight segments for the moment sums, a single one with weight 1 without weights
+    if (mUseWeights) {
+      mMoments.resize(mWeightSegments.size());
+      for (std::size_t s = 0; s < mWeightSegments.size(); s++) {
+        mMoments[s].segment = mWeightSegments[s];
+      }
+    } else {
+      mMoments.resize(1);
+      mMoments[0].segment = {-std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), 0, 1., 0., 0.};
+    }
+
+    // TFs and ITS ROFs are contiguous in the sorted order
+    int tfBegin = 0;
+    for (int p = 1; p <= n; p++) {
+      if (p == n || tfId(mBC[mOrder[p]]) != tfId(mBC[mOrder[tfBegin]])) {
+        calculateInRof(tfBegin, p);
+        calculateInTimeRange(tfBegin, p);
+        tfBegin = p;
+      }
+    }
+  }
+
+  // output per collision
+  int getTrackOccupancy(int collision) const { return mTrackOccupancy[collision]; } // -1 if undefined (too close to TF borders)
+  float getFT0COccupancy(int collision) const { return mFT0COccupancy[collision]; } // -1 if undefined (too close to TF borders)
+  bool getFlag(int collision, OccupancyFlag flag) const { return (mFlags[collision] >> flag) & 1; }
+
+ private:
+  int64_t tfId(int64_t bc) const { return (bc - mBcSOR) / mNBCsPerTF; }
+  int64_t rofId(int64_t bc) const { return (bc + o2::constants::lhc::LHCMaxBunches - mRofOffset) / mRofLength; }
+
+  // time differences as used for the cuts
+  static float deltaTimeNS(int64_t bc, int64_t bcRef) { return (bc - bcRef) * o2::constants::lhc::LHCBunchSpacingNS; }
+  static float deltaTimeUS(int64_t bc, int64_t bcRef) { return deltaTimeNS(bc, bcRef) / 1e3; }
+
+  void setFlag(int collision, OccupancyFlag flag, bool value)
+  {
+    if (value) {
+      mFlags[collision] |= (1 << flag);
+    }
+  }
+
+  // first position in [begin, end) for which pred (true for a leading part of the range) is false
+  template <typename Pred>
+  int partitionPoint(int begin, int end, Pred pred) const
+  {
+    return std::partition_point(mOrder.begin() + begin, mOrder.begin() + end, pred) - mOrder.begin();
+  }
+
+  // sum over positions [begin, end)
+  static double rangeSum(const std::vector<double>& sums, int begin, int end) { return sums[end] - sums[begin]; }
+
+  float weight(float dt) const
+  {
+    if (!mUseWeights) {
+      return 1.;
+    }
+    for (const auto& segment : mWeightSegments) {
+      if (dt >= segment.min && dt < segment.max) {
+        float x = dt - segment.center;
+        return segment.c0 + segment.c1 * x + segment.c2 * x * x;
+      }
+    }
+    return 0.;
+  }
+
+  // running sums of n * dt^m and of amplitude * dt^m (m = 0, 1, 2) over the collisions at positions [begin, end) in the
+  // time window and in one weight segment, dt (us) relative to the collision at bcRef
+  struct SegmentMoments {
+    WeightSegment segment;
+    int begin;
+    int end;
+    int64_t bcRef;
+    double tracks[3];
+    double amp[3];
+  };
+
+  void resetMoments(SegmentMoments& moments, int begin, int64_t bcRef)
+  {
+    moments.begin = moments.end = begin;
+    moments.bcRef = bcRef;
+    for (int m = 0; m < 3; m++) {
+      moments.tracks[m] = moments.amp[m] = 0.;
+    }
+  }
+
+  void addToMoments(SegmentMoments& moments, int q, double sign)
+  {
+    int j = mOrder[q];
+    double dt = (mBC[j] - moments.bcRef) * o2::constants::lhc::LHCBunchSpacingNS * 1e-3;
+    double powers[3] = {sign, sign * dt, sign * dt * dt};
+    for (int m = 0; m < 3; m++) {
+      moments.tracks[m] += powers[m] * mNTracks[j];
+      moments.amp[m] += powers[m] * mAmpFT0C[j];
+    }
+  }
+
+  // moves the segment range and the reference of the moments to the collision at bc
+  void moveMoments(SegmentMoments& moments, int tfEnd, int64_t bc)
+  {
+    const auto& segment = moments.segment;
+    auto isAfterBegin = [&](int q) { return !(deltaTimeNS(mBC[mOrder[q]], bc) < mTimeWinMinNS) && !(deltaTimeUS(mBC[mOrder[q]], bc) < segment.min); };
+    auto isBeforeEnd = [&](int q) { return !(deltaTimeNS(mBC[mOrder[q]], bc) > mTimeWinMaxNS) && deltaTimeUS(mBC[mOrder[q]], bc) < segment.max; };
+    while (moments.begin < tfEnd && !isAfterBegin(moments.begin)) {
+      if (moments.begin < moments.end) {
+        addToMoments(moments, moments.begin, -1.);
+      }
+      moments.begin++;
+    }
+    if (moments.end <= moments.begin) {
+      resetMoments(moments, moments.begin, bc); // also drops the rounding errors of the removed collisions
+    } else {
+      // dt -> dt - shift for the collisions remaining in the range, shift is at most the window length
+      double shift = (bc - moments.bcRef) * o2::constants::lhc::LHCBunchSpacingNS * 1e-3;
+      for (auto* sums : {moments.tracks, moments.amp}) {
+        sums[2] += -2 * shift * sums[1] + shift * shift * sums[0];
+        sums[1] -= shift * sums[0];
+      }
+      moments.bcRef = bc;
+    }
+    while (moments.end < tfEnd && isBeforeEnd(moments.end)) {
+      addToMoments(moments, moments.end, 1.);
+      moments.end++;
+    }
+  }
+
+  // weighted sum of the moments: the weight polynomial in x = dt - center expanded in powers of dt
+  static double weightedMoments(const SegmentMoments& moments, const double sums[3])
+  {
+    const auto& segment = moments.segment;
+    double c = segment.center;
+    double a0 = segment.c0 - segment.c1 * c + segment.c2 * c * c;
+    double a1 = segment.c1 - 2 * segment.c2 * c;
+    double a2 = segment.c2;
+    return a0 * sums[0] + a1 * sums[1] + a2 * sums[2];
+  }
+
+  void calculateInRof(int tfBegin, int tfEnd)
+  {
+    int rofBegin = tfBegin;
+    for (int p = tfBegin + 1; p <= tfEnd; p++) {
+      if (p < tfEnd && rofId(mBC[mOrder[p]]) == rofId(mBC[mOrder[rofBegin]])) {
+        continue;
+      }
+      // collisions in the same ROF: [rofBegin, p)
+      double nTracksInRof = rangeSum(mSumTracks, rofBegin, p);
+      int nAboveCutInRof = 0;
+      for (int q = rofBegin; q < p; q++) {
+        nAboveCutInRof += mAmpFT0C[mOrder[q]] > mFT0CamplCutInROF;
+      }
+      // for the close-vZ veto, the collisions of the ROF sorted in vZ
+      mRofByVz.assign(mOrder.begin() + rofBegin, mOrder.begin() + p);
+      std::sort(mRofByVz.begin(), mRofByVz.end(), [this](int a, int b) { return mVz[a] < mVz[b]; });
+      mRofSumTracks.assign(1, 0.);
+      for (const auto& j : mRofByVz) {
+        mRofSumTracks.push_back(mRofSumTracks.back() + mNTracks[j]);
+      }
+
+      for (int q = rofBegin; q < p; q++) {
+        int i = mOrder[q];
+        float vZ = mVz[i];
+        setFlag(i, NoCollInRofStrict, nTracksInRof - mNTracks[i] == 0);
+        setFlag(i, NoCollInRofStandard, nAboveCutInRof - (mAmpFT0C[i] > mFT0CamplCutInROF) == 0);
+
+        auto closeBegin = std::partition_point(mRofByVz.begin(), mRofByVz.end(), [&](int j) { return !(mVz[j] - vZ > -mEpsilonVzDiffInROF); });
+        auto closeEnd = std::partition_point(closeBegin, mRofByVz.end(), [&](int j) { return mVz[j] - vZ < mEpsilonVzDiffInROF; });
+        double nTracksCloseVz = mRofSumTracks[closeEnd - mRofByVz.begin()] - mRofSumTracks[closeBegin - mRofByVz.begin()];
+        if (0 < mEpsilonVzDiffInROF) { // the collision itself is in the range
+          nTracksCloseVz -= mNTracks[i];
+        }
+        setFlag(i, NoCollInRofWithCloseVz, nTracksCloseVz == 0);
+      }
+      rofBegin = p;
+    }
+  }
+
+  void calculateInTimeRange(int tfBegin, int tfEnd)
+  {
+    const float driftV = 2.5; // drift velocity in cm/us, TPC drift_length / drift_time = 250 cm / 100 us
+    const double weightSelf = weight(0);
+    for (auto& moments : mMoments) {
+      resetMoments(moments, tfBegin, mBC[mOrder[tfBegin]]);
+    }
+    // two pointers for the bounds of the time window and of the fixed veto ranges, all non-decreasing during the sweep
+    int winBegin = tfBegin, winEnd = tfBegin;
+    int narrowBegin = tfBegin, narrowEnd = tfBegin;
+    int strictBegin = tfBegin, strictEnd = tfBegin;
+
+    for (int p = tfBegin; p < tfEnd; p++) {
+      int i = mOrder[p];
+      if (!mIsFullInfo[i]) { // occupancy in undefined (too close to TF borders)
+        continue;
+      }
+      int64_t bc = mBC[i];
+      while (winBegin < tfEnd && deltaTimeNS(mBC[mOrder[winBegin]], bc) < mTimeWinMinNS) {
+        winBegin++;
+      }
+      winEnd = std::max(winEnd, winBegin);
+      while (winEnd < tfEnd && !(deltaTimeNS(mBC[mOrder[winEnd]], bc) > mTimeWinMaxNS)) {
+        winEnd++;
+      }
+      // the veto ranges are counted only inside of the time window
+      auto advance = [&](int& begin, int& end, float range) {
+        begin = std::max(begin, winBegin);
+        while (begin < winEnd && !(std::fabs(deltaTimeUS(mBC[mOrder[begin]], bc)) < range) && deltaTimeUS(mBC[mOrder[begin]], bc) < 0) {
+          begin++;
+        }
+        end = std::max(end, begin);
+        while (end < winEnd && std::fabs(deltaTimeUS(mBC[mOrder[end]], bc)) < range) {
+          end++;
+        }
+        end = std::min(end, winEnd);
+      };
+      advance(narrowBegin, narrowEnd, mTimeRangeVetoNarrow);
+      advance(strictBegin, strictEnd, mTimeRangeVetoStandard);
+      const bool selfInWindow = winBegin <= p && p < winEnd;
+
+      // occupancy estimators (without the current collision)
+      if (mUseMomentSums) {
+        double nTracksInWindow = 0, sumAmpInWindow = 0;
+        for (auto& moments : mMoments) {
+          moveMoments(moments, tfEnd, bc);
+          nTracksInWindow += weightedMoments(moments, moments.tracks);
+          sumAmpInWindow += weightedMoments(moments, moments.amp);
+        }
+        if (selfInWindow) {
+          nTracksInWindow -= weightSelf * mNTracks[i];
+          sumAmpInWindow -= weightSelf * mAmpFT0C[i];
+        }
+        mTrackOccupancy[i] = std::max(0., nTracksInWindow);
+        mFT0COccupancy[i] = std::max(0., sumAmpInWindow);
+      } else {
+        // as in the original implementation: past collisions from the nearest one, then future ones, each weighted
+        // track count truncated when added to the integer sum
+        int nTracksInWindow = 0;
+        float sumAmpInWindow = 0;
+        auto addToWindowSums = [&](int q) {
+          int j = mOrder[q];
+          float wOccup = weight(deltaTimeUS(mBC[j], bc));
+          nTracksInWindow += wOccup * mNTracks[j];
+          sumAmpInWindow += wOccup * mAmpFT0C[j];
+        };
+        for (int q = std::min(p, winEnd) - 1; q >= winBegin; q--) {
+          addToWindowSums(q);
+        }
+        for (int q = std::max(p + 1, winBegin); q < winEnd; q++) {
+          addToWindowSums(q);
+        }
+        mTrackOccupancy[i] = nTracksInWindow;
+        mFT0COccupancy[i] = sumAmpInWindow;
+      }
+
+      // counting tracks from other collisions in fixed time windows
+      double nTracksForVetoNarrow = rangeSum(mSumTracks, narrowBegin, narrowEnd) - ((narrowBegin <= p && p < narrowEnd) ? mNTracks[i] : 0);
+      double nTracksForVetoStrict = rangeSum(mSumTracks, strictBegin, strictEnd) - ((strictBegin <= p && p < strictEnd) ? mNTracks[i] : 0);
+      setFlag(i, NoCollInTimeRangeNarrow, nTracksForVetoNarrow == 0);
+      setFlag(i, NoCollInTimeRangeStrict, nTracksForVetoStrict == 0);
+
+      // vZ-dependent time range: loop over the other collisions in it
+      float vZ = mVz[i];
+      float rangeVzDependent = 8 + std::fabs(vZ) / driftV; // 8 us corresponds to maximum possible |vZ|, which is ~20 cm
+      int vzBegin = partitionPoint(winBegin, winEnd, [&](int j) { return deltaTimeUS(mBC[j], bc) < 0 && !(std::fabs(deltaTimeUS(mBC[j], bc)) < rangeVzDependent); });
+      int vzEnd = partitionPoint(vzBegin, winEnd, [&](int j) { return std::fabs(deltaTimeUS(mBC[j], bc)) < rangeVzDependent; });
+      int nCollsWithFT0CAboveVetoStandard = 0; // to veto events with per-collision multiplicity above threshold
+      int nTracksForVetoVzDependent = 0;       // to veto events with nearby collisions, vZ-dependent time cut
+      for (int q = vzBegin; q < vzEnd; q++) {
+        if (q == p) {
+          continue;
+        }
+        int j = mOrder[q];
+        float dt = deltaTimeUS(mBC[j], bc);
+        // standard cut on other collisions vs delta-times
+        if (std::fabs(dt) < 2.0) { // us, complete veto on other collisions
+          nCollsWithFT0CAboveVetoStandard++;
+        } else if (dt > -4.0 && dt <= -2.0) { // us, strict veto to suppress fake ITS-TPC matches more
+          if (mAmpFT0C[j] > mFT0CamplCutInTimeRange / 5)
+            nCollsWithFT0CAboveVetoStandard++;
+        } else if (mAmpFT0C[j] > mFT0CamplCutInTimeRange) { // loose veto, counting number of other collisions with multiplicity above threshold
+          nCollsWithFT0CAboveVetoStandard++;
+        }
+        // vZ-dependent time cut to avoid collinear tracks from other collisions (experimental)
+        if (dt < 0) {
+          // check distance between given vZ and (moving in two directions) vZ of drifting tracks from past collisions
+          if ((std::fabs(mVz[j] - std::fabs(dt) * driftV - vZ) < mEpsilonVzDependentVeto) ||
+              (std::fabs(mVz[j] + std::fabs(dt) * driftV - vZ) < mEpsilonVzDependentVeto))
+            nTracksForVetoVzDependent += mNTracks[j];
+        } else { // dt>0
+          // check distance between drifted vZ of given collision (in two directions) and vZ of future collisions
+          if ((std::fabs(vZ - dt * driftV - mVz[j]) < mEpsilonVzDependentVeto) ||
+              (std::fabs(vZ + dt * driftV - mVz[j]) < mEpsilonVzDependentVeto))
+            nTracksForVetoVzDependent += mNTracks[j];
+        }
+      }
+      setFlag(i, NoCollInTimeRangeStandard, nCollsWithFT0CAboveVetoStandard == 0);
+      setFlag(i, NoCollInTimeRangeVzDependent, nTracksForVetoVzDependent == 0);
+    }
+  }
+
+  // configuration
+  float mTimeWinMinNS = -40e3;
+  float mTimeWinMaxNS = 100e3;
+  bool mUseWeights = true;
+  bool mUseMomentSums = false;
+  std::vector<WeightSegment> mWeightSegments;
+  float mTimeRangeVetoNarrow = 2.0;   // us
+  float mTimeRangeVetoStandard = 10.; // us
+  float mFT0CamplCutInTimeRange = 8000;
+  float mEpsilonVzDependentVeto = 2.5; // cm
+  float mFT0CamplCutInROF = 5000;
+  float mEpsilonVzDiffInROF = 0.3; // cm
+  int64_t mBcSOR = 0;
+  int64_t mNBCsPerTF = 128 * o2::constants::lhc::LHCMaxBunches;
+  int mRofOffset = 0;
+  int mRofLength = 1;
+
+  // input per collision
+  std::vector<int64_t> mBC;
+  std::vector<float> mVz;
+  std::vector<int> mNTracks;
+  std::vector<float> mAmpFT0C;
+  std::vector<bool> mIsFullInfo;
+
+  // working memory, reused from DF to DF
+  std::vector<int> mOrder;              // collision indices sorted by bc
+  std::vector<double> mSumTracks;       // prefix sums of tracks per sorted position
+  std::vector<SegmentMoments> mMoments; // running moment sums per weight segment
+  std::vector<int> mRofByVz;
+  std::vector<double> mRofSumTracks;
+
+  // output per collision
+  std::vector<int> mTrackOccupancy;
+  std::vector<float> mFT0COccupancy;
+  std::vector<uint8_t> mFlags;
+};
+
+#endif // COMMON_CORE_COLLISIONOCCUPANCYCALCULATOR_H_
@@ -12,6 +12,11 @@
 #ifndef ANALYSIS_CORE_EVENTMIXING_H_
 #define ANALYSIS_CORE_EVENTMIXING_H_
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <vector>
+
 namespace eventmixing
 {
 /// Calculate hash for an element based on 2 properties and their bins.
@@ -25,26 +30,165 @@ namespace eventmixing
 template <typename T1, typename T2>
 static int getMixingBin(const T1& vtxBins, const T1& multBins, const T2& vtx, const T2& mult)
 {
-  // underflow
-  if (vtx < vtxBins.at(0)) {
+  // index of the first edge above the value, 0 for underflow and size() for overflow
+  int i = std::upper_bound(vtxBins.begin(), vtxBins.end(), vtx) - vtxBins.begin();
+  int j = std::upper_bound(multBins.begin(), multBins.end(), mult) - multBins.begin();
+  if (i == 0 || j == 0 || i == static_cast<int>(vtxBins.size()) || j == static_cast<int>(multBins.size())) {
     return -1;
   }
-  if (mult < multBins.at(0)) {
-    return -1;
+  return i + j * (vtxBins.size() + 1);
+}
+
+/// Event-class binning with an arbitrary number of axes, shared by the mixing tasks.
+/// Each axis is uniform (O(1) look-up) or variable (binary search). The class of an event is the global bin
+/// index b0 + n0 * (b1 + n1 * (b2 + ...)), in [0, getNClasses()), or -1 if a value is outside of an axis.
+class MixingBinning
+{
+ public:
+  MixingBinning() = default;
+
+  /// Adds a uniform axis with nBins bins in [min, max)
+  void addAxis(int nBins, double min, double max)
+  {
+    Axis axis;
+    axis.nBins = nBins;
+    axis.min = min;
+    axis.max = max;
+    axis.scale = nBins / (max - min);
+    mAxes.push_back(axis);
+    updateStrides();
+  }
+
+  /// Adds a variable axis from its bin edges
+  void addAxis(std::vector<double> const& edges)
+  {
+    Axis axis;
+    axis.nBins = edges.size() - 1;
+    axis.min = edges.front();
+    axis.max = edges.back();
+    axis.edges = edges;
+    mAxes.push_back(axis);
+    updateStrides();
   }
 
-  for (unsigned int i = 1; i < vtxBins.size(); i++) {
-    if (vtx < vtxBins.at(i)) {
-      for (unsigned int j = 1; j < multBins.size(); j++) {
-        if (mult < multBins.at(j)) {
-          return i + j * (vtxBins.size() + 1);
+  /// Adds an axis in the format of ConfigurableAxis: {VARIABLE_WIDTH (= 0), edge0, edge1, ...} or {nBins, min, max}
+  template <typename T>
+  void addConfigurableAxis(std::vector<T> const& spec)
+  {
+    if (spec.at(0) == 0) {
+      addAxis(std::vector<double>(spec.begin() + 1, spec.end()));
+    } else {
+      addAxis(static_cast<int>(spec.at(0)), spec.at(1), spec.at(2));
+    }
+  }
+
+  int getNAxes() const { return mAxes.size(); }
+  int getNClasses() const { return mNClasses; }
+
+  /// Bin of value along axis iAxis, in [0, nBins) or -1 outside of the axis
+  int getAxisBin(int iAxis, double value) const
+  {
+    const Axis& axis = mAxes[iAxis];
+    if (!(value >= axis.min && value < axis.max)) {
+      return -1;
+    }
+    if (axis.edges.empty()) {
+      return std::min(static_cast<int>((value - axis.min) * axis.scale), axis.nBins - 1);
+    }
+    return std::upper_bound(axis.edges.begin(), axis.edges.end(), value) - axis.edges.begin() - 1;
+  }
+
+  /// Event class from one value per axis
+  template <typename... Ts>
+  int getBin(Ts... values) const
+  {
+    std::array<double, sizeof...(Ts)> array{static_cast<double>(values)...};
+    return getBinFromArray(array.data());
+  }
+
+  /// Event class from an array with one value per axis
+  int getBinFromArray(const double* values) const
+  {
+    int bin = 0;
+    for (std::size_t iAxis = 0; iAxis < mAxes.size(); iAxis++) {
+      int axisBin = getAxisBin(iAxis, values[iAxis]);
+      if (axisBin < 0) {
+        return -1;
+      }
+      bin += axisBin * mStrides[iAxis];
+    }
+    return bin;
+  }
+
+  /// Event classes of all collisions of a table in one pass, one getter per axis
+  /// e.g. binning.getBins(collisions, bins, [](auto const& col) { return col.posZ(); }, [](auto const& col) { return col.multFT0M(); });
+  template <typename TCollisions, typename... TGetters>
+  void getBins(TCollisions const& collisions, std::vector<int>& bins, TGetters const&... getters) const
+  {
+    bins.clear();
+    bins.reserve(collisions.size());
+    for (auto const& collision : collisions) {
+      bins.push_back(getBin(getters(collision)...));
+    }
+  }
+
+  /// Calls f(first, second) for the pairs of collisions (indices in bins) of the same class, the second collision
+  /// being one of the nextToMix following collisions of that class (all of them if nextToMix <= 0).
+  /// Collisions outside of the binning (class -1) are not mixed.
+  template <typename F>
+  void forEachSameClassPair(std::vector<int> const& bins, int nextToMix, F&& f) const
+  {
+    // counting sort of the collision indices by class, keeping the order within a class
+    std::vector<int> offsets(mNClasses + 1, 0);
+    for (int bin : bins) {
+      if (bin >= 0) {
+        offsets[bin + 1]++;
+      }
+    }
+    for (int iClass = 0; iClass < mNClasses; iClass++) {
+      offsets[iClass + 1] += offsets[iClass];
+    }
+    std::vector<int> sorted(offsets[mNClasses]);
+    std::vector<int> fill(offsets.begin(), offsets.end() - 1);
+    for (std::size_t i = 0; i < bins.size(); i++) {
+      if (bins[i] >= 0) {
+        sorted[fill[bins[i]]++] = i;
+      }
+    }
+
+    for (int iClass = 0; iClass < mNClasses; iClass++) {
+      for (int first = offsets[iClass]; first < offsets[iClass + 1]; first++) {
+        int last = (nextToMix > 0) ? std::min(first + nextToMix, offsets[iClass + 1] - 1) : offsets[iClass + 1] - 1;
+        for (int second = first + 1; second <= last; second++) {
+          f(sorted[first], sorted[second]);
         }
       }
     }
   }
-  // overflow
-  return -1;
-}
+
+ private:
+  struct Axis {
+    int nBins = 0;
+    double min = 0.;
+    double max = 0.;
+    double scale = 0.;         // nBins / (max - min), for uniform axes
+    std::vector<double> edges; // only for variable axes
+  };
+
+  void updateStrides()
+  {
+    mStrides.resize(mAxes.size());
+    mNClasses = 1;
+    for (std::size_t iAxis = 0; iAxis < mAxes.size(); iAxis++) {
+      mStrides[iAxis] = mNClasses;
+      mNClasses *= mAxes[iAxis].nBins;
+    }
+  }
+
+  std::vector<Axis> mAxes;
+  std::vector<int> mStrides;
+  int mNClasses = 1;
+};
 }; // namespace eventmixing
 
 #endif /* ANALYSIS_CORE_EVENTMIXING_H_ */
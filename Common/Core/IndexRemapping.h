@@ -0,0 +1,111 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file IndexRemapping.h
+/// \brief Old-to-new row index maps for the producers of reduced (derived) tables
+
+#ifndef COMMON_CORE_INDEXREMAPPING_H_
+#define COMMON_CORE_INDEXREMAPPING_H_
+
+#include <cstddef>
+#include <vector>
+
+namespace indexremapping
+{
+/// Keeps a subset of the rows of a table and numbers them densely, in the original order, as they are written to the
+/// reduced table. Typical use, e.g. for the daughter tracks of V0s:
+///
+///   trackMap.reset(tracks.size());
+///   trackMap.keepReferenced(v0s, [](auto const& v0) { return v0.posTrackId(); }, [](auto const& v0) { return v0.negTrackId(); });
+///   trackMap.build();
+///   for (auto const& v0 : v0s) { v0Extras(trackMap[v0.posTrackId()], trackMap[v0.negTrackId()]); }
+///   for (auto const& track : tracks) { if (trackMap.isKept(track.globalIndex())) { reducedTracks(...); } }
+///
+/// Rows are kept with keep(), with a mask, or through the index columns of other tables (foreign keys). A relation
+/// can be restricted to the kept rows of another map, so chains of tables (e.g. particles -> mothers -> ...) are
+/// resolved by calling build() on each map in order. All operations are linear and the buffers are reused between
+/// data frames if the remapper is a member of the task.
+class IndexRemapper
+{
+ public:
+  IndexRemapper() = default;
+
+  /// Starts a new table with nRows rows, none kept
+  void reset(std::size_t nRows)
+  {
+    mMap.assign(nRows, -1);
+    mNKept = 0;
+  }
+
+  /// Keeps row (negative indices, i.e. no reference, are ignored)
+  void keep(int row)
+  {
+    if (row >= 0) {
+      mMap[row] = 0;
+    }
+  }
+
+  /// Keeps the rows for which mask[row] is true
+  template <typename TMask>
+  void keepMask(TMask const& mask)
+  {
+    for (std::size_t row = 0; row < mMap.size(); row++) {
+      if (mask[row]) {
+        mMap[row] = 0;
+      }
+    }
+  }
+
+  /// Keeps the rows referenced by all the rows of a table, one getter per index column
+  template <typename TRows, typename... TGetters>
+  void keepReferenced(TRows const& rows, TGetters const&... getters)
+  {
+    for (auto const& row : rows) {
+      (keep(getters(row)), ...);
+    }
+  }
+
+  /// Keeps the rows referenced by the rows of a table which are kept in rowsMap
+  template <typename TRows, typename... TGetters>
+  void keepReferenced(TRows const& rows, IndexRemapper const& rowsMap, TGetters const&... getters)
+  {
+    for (auto const& row : rows) {
+      if (rowsMap.isKept(row.globalIndex())) {
+        (keep(getters(row)), ...);
+      }
+    }
+  }
+
+  /// Numbers the kept rows, to be called once all rows are kept and before the indices are read
+  void build()
+  {
+    mNKept = 0;
+    for (auto& index : mMap) {
+      if (index >= 0) {
+        index = mNKept++;
+      }
+    }
+  }
+
+  /// New index of row, -1 if row is not kept or negative (no reference)
+  int operator[](int row) const { return row >= 0 ? mMap[row] : -1; }
+  bool isKept(int row) const { return row >= 0 && mMap[row] >= 0; }
+  /// Number of kept rows, i.e. size of the reduced table
+  int getNKept() const { return mNKept; }
+  std::size_t size() const { return mMap.size(); }
+
+ private:
+  std::vector<int> mMap; // new index per row, -1 if not kept
+  int mNKept = 0;
+};
+} // namespace indexremapping
+
+#endif // COMMON_CORE_INDEXREMAPPING_H_
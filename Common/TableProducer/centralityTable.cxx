@@ -23,6 +23,7 @@
 #include "Common/DataModel/Multiplicity.h"
 #include "Common/DataModel/Centrality.h"
 #include "Common/DataModel/EventSelection.h"
+#include "Common/Core/CalibrationLookup.h"
 #include "MetadataHelper.h"
 #include "TableHelper.h"
 #include "TList.h"
@@ -129,6 +130,7 @@ struct CentralityTable {
     std::string name = "";
     bool mCalibrationStored = false;
     TH1* mhMultSelCalib = nullptr;
+    CalibrationHistogram mMultSelCalibLookup; // flat copy of mhMultSelCalib for the per-collision look-up
     float mMCScalePars[6] = {0.0};
     TFormula* mMCScale = nullptr;
     explicit calibrationInfo(std::string name)
@@ -525,6 +527,7 @@ struct CentralityTable {
                   LOGF(warning, "MC Scale information from %s for run %d not available", estimator.name.c_str(), bc.runNumber());
                 }
               }
+              estimator.mMultSelCalibLookup = CalibrationHistogram(estimator.mhMultSelCalib);
               estimator.mCalibrationStored = true;
               estimator.isSane();
             } else {
@@ -587,7 +590,7 @@ struct CentralityTable {
             scaledMultiplicity = scaleMC(multiplicity, estimator.mMCScalePars);
             LOGF(debug, "Unscaled %s multiplicity: %f, scaled %s multiplicity: %f", estimator.name.c_str(), multiplicity, estimator.name.c_str(), scaledMultiplicity);
           }
-          percentile = estimator.mhMultSelCalib->GetBinContent(estimator.mhMultSelCalib->FindFixBin(scaledMultiplicity));
+          percentile = estimator.mMultSelCalibLookup.getBinContent(scaledMultiplicity);
           if (assignOutOfRange)
             percentile = 100.5f;
         }
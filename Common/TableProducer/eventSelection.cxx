@@ -14,6 +14,8 @@
 #include "Framework/AnalysisTask.h"
 #include "Framework/AnalysisDataModel.h"
 #include "Common/DataModel/EventSelection.h"
+#include "Common/Core/BcLookup.h"
+#include "Common/Core/CollisionOccupancyCalculator.h"
 #include "Common/CCDB/EventSelectionParams.h"
 #include "Common/CCDB/TriggerAliases.h"
 #include "CCDB/BasicCCDBManager.h"
@@ -61,6 +63,8 @@ struct BcSelectionTask {
   int mTimeFrameStartBorderMargin = 300; // default value
   int mTimeFrameEndBorderMargin = 4000;  // default value
 
+  bclookup::BcLookup<int32_t> bcIdLookup; // from GlobalBC to BcId, per DF
+
   void init(InitContext&)
   {
     if (metadataInfo.isFullyDefined() && !doprocessRun2 && !doprocessRun3) { // Check if the metadata is initialized (only if not forced from the workflow configuration)
@@ -241,11 +245,13 @@ struct BcSelectionTask {
     auto alppar = ccdb->getForTimeStamp<o2::itsmft::DPLAlpideParam<0>>("ITS/Config/AlpideParam", ts);
     EventSelectionParams* par = ccdb->getForTimeStamp<EventSelectionParams>("EventSelection/EventSelectionParams", ts);
     TriggerAliases* aliases = ccdb->getForTimeStamp<TriggerAliases>("EventSelection/TriggerAliases", ts);
-    // map from GlobalBC to BcId needed to find triggerBc
-    std::map<uint64_t, int32_t> mapGlobalBCtoBcId;
+    // lookup from GlobalBC to BcId needed to find triggerBc
+    bcIdLookup.clear();
+    bcIdLookup.reserve(bcs.size());
     for (auto& bc : bcs) {
-      mapGlobalBCtoBcId[bc.globalBC()] = bc.globalIndex();
+      bcIdLookup.add(bc.globalBC(), bc.globalIndex());
     }
+    bcIdLookup.build();
     int triggerBcShift = confTriggerBcShift;
     if (confTriggerBcShift == 999) {
       triggerBcShift = (run <= 526766 || (run >= 526886 && run <= 527237) || (run >= 527259 && run <= 527518) || run == 527523 || run == 527734 || run >= 534091) ? 0 : 294;
@@ -275,7 +281,8 @@ struct BcSelectionTask {
     for (auto bc : bcs) {
       uint32_t alias{0};
       // workaround for pp2022 (trigger info is shifted by -294 bcs)
-      int32_t triggerBcId = mapGlobalBCtoBcId[bc.globalBC() + triggerBcShift];
+      int triggerBcPos = bcIdLookup.find(bc.globalBC() + triggerBcShift);
+      int32_t triggerBcId = triggerBcPos >= 0 ? bcIdLookup.getValue(triggerBcPos) : 0;
       if (triggerBcId) {
         auto triggerBc = bcs.iteratorAt(triggerBcId);
         uint64_t triggerMask = triggerBc.triggerMask();
@@ -448,6 +455,7 @@ struct EventSelectionTask {
   Configurable<float> confFT0CamplCutVetoOnCollInROF{"FT0CamplPerCollCutVetoOnCollInROF", 5000, "Max allowed FT0C amplitude for each nearby collision inside this ITS ROF"};
   Configurable<float> confEpsilonVzDiffVetoInROF{"EpsilonVzDiffVetoInROF", 0.3, "Minumum distance to nearby collisions along z inside this ITS ROF, cm"};
   Configurable<bool> confUseWeightsForOccupancyVariable{"UseWeightsForOccupancyEstimator", 1, "Use or not the delta-time weights for the occupancy estimator"};
+  Configurable<bool> confUseMomentSumsForOccupancy{"UseMomentSumsForOccupancyEstimator", 0, "Calculate the occupancy estimators from running time-moment sums (faster, the ITS track occupancy is truncated once instead of per collision and can be higher by up to the number of collisions in the window)"};
 
   Partition<FullTracks> tracklets = (aod::track::trackType == static_cast<uint8_t>(o2::aod::track::TrackTypeEnum::Run2Tracklet));
 
@@ -465,19 +473,15 @@ struct EventSelectionTask {
   int rofOffset = -1;     // ITS ROF offset, in bc
   int rofLength = -1;     // ITS ROF length, in bc
 
-  int32_t findClosest(int64_t globalBC, std::map<int64_t, int32_t>& bcs)
-  {
-    auto it = bcs.lower_bound(globalBC);
-    int64_t bc1 = it->first;
-    int32_t index1 = it->second;
-    if (it != bcs.begin())
-      --it;
-    int64_t bc2 = it->first;
-    int32_t index2 = it->second;
-    int64_t dbc1 = std::abs(bc1 - globalBC);
-    int64_t dbc2 = std::abs(bc2 - globalBC);
-    return (dbc1 <= dbc2) ? index1 : index2;
-  }
+  CollisionOccupancyCalculator occupancyCalculator; // occupancy estimators and time-pattern flags per collision
+
+  // TVX-fired bc with the information used to match collisions to it
+  struct TvxBc {
+    int32_t bcIndex;
+    float vtxZ;       // FT0 vertex z
+    bool isAvailable; // not yet matched to a collision in the search by time and zVtx
+  };
+  bclookup::BcLookup<TvxBc> tvxLookup; // TVX-fired colliding bcs of the DF
 
   // helper function to find median time in the vector of TOF or TRD-track times
   float getMedian(std::vector<float> v)
@@ -487,8 +491,9 @@ struct EventSelectionTask {
     return v[medianIndex];
   }
 
-  // helper function to find closest TVX signal in time and in zVtx
-  int64_t findBestGlobalBC(int64_t meanBC, int64_t sigmaBC, int32_t nContrib, float zVtxCol, std::map<int64_t, float>& mapGlobalBcVtxZ)
+  // helper function to find closest available TVX signal in time and in zVtx
+  // returns the position in tvxLookup, -1 if none
+  int findBestTvx(int64_t meanBC, int64_t sigmaBC, int32_t nContrib, float zVtxCol)
   {
     // protection against
     if (sigmaBC < 1)
@@ -501,20 +506,24 @@ struct EventSelectionTask {
     float zVtxSigma = 2.7 * pow(nContrib, -0.466) + 0.024;
     zVtxSigma += 1.0; // additional uncertainty due to imperfectections of FT0 time calibration
 
-    auto itMin = mapGlobalBcVtxZ.lower_bound(minBC);
-    auto itMax = mapGlobalBcVtxZ.upper_bound(maxBC);
+    int posMin = tvxLookup.lowerBound(minBC);
+    int posMax = tvxLookup.upperBound(maxBC);
 
     float bestChi2 = 1e+10;
-    int64_t bestGlobalBC = 0;
-    for (std::map<int64_t, float>::iterator it = itMin; it != itMax; ++it) {
-      float chi2 = pow((it->second - zVtxCol) / zVtxSigma, 2) + pow(static_cast<float>(it->first - meanBC) / sigmaBC, 2.);
+    int bestPos = -1;
+    for (int pos = posMin; pos < posMax; ++pos) {
+      const TvxBc& tvx = tvxLookup.getValue(pos);
+      if (!tvx.isAvailable) {
+        continue;
+      }
+      float chi2 = pow((tvx.vtxZ - zVtxCol) / zVtxSigma, 2) + pow(static_cast<float>(tvxLookup.getGlobalBC(pos) - meanBC) / sigmaBC, 2.);
       if (chi2 < bestChi2) {
         bestChi2 = chi2;
-        bestGlobalBC = it->first;
+        bestPos = pos;
       }
     }
 
-    return bestGlobalBC;
+    return bestPos;
   }
 
   void init(InitContext&)
@@ -545,6 +554,16 @@ struct EventSelectionTask {
     histos.add("hColCounterAll", "", kTH1D, {{1, 0., 1.}});
     histos.add("hColCounterTVX", "", kTH1D, {{1, 0., 1.}});
     histos.add("hColCounterAcc", "", kTH1D, {{1, 0., 1.}});
+
+    occupancyCalculator.setTimeWindow(confTimeIntervalForOccupancyCalculationMin, confTimeIntervalForOccupancyCalculationMax);
+    occupancyCalculator.setUseWeights(confUseWeightsForOccupancyVariable);
+    occupancyCalculator.setUseMomentSums(confUseMomentSumsForOccupancy);
+    occupancyCalculator.setTimeRangeVetoNarrow(confTimeRangeVetoOnCollNarrow);
+    occupancyCalculator.setTimeRangeVetoStandard(confTimeRangeVetoOnCollStandard);
+    occupancyCalculator.setFT0CamplCutInTimeRange(confFT0CamplCutVetoOnCollInTimeRange);
+    occupancyCalculator.setEpsilonVzDependentVeto(confEpsilonDistanceForVzDependentVetoTPC);
+    occupancyCalculator.setFT0CamplCutInROF(confFT0CamplCutVetoOnCollInROF);
+    occupancyCalculator.setEpsilonVzDiffInROF(confEpsilonVzDiffVetoInROF);
   }
 
   void process(aod::Collisions const& collisions)
@@ -648,10 +667,9 @@ struct EventSelectionTask {
       LOGP(debug, "ITS ROF Offset={} ITS ROF Length={}", rofOffset, rofLength);
     }
 
-    // create maps from globalBC to bc index for TVX-fired bcs
+    // create lookup from globalBC to bc index and FT0 zVtx for TVX-fired bcs
     // to be used for closest TVX searches
-    std::map<int64_t, int32_t> mapGlobalBcWithTVX;
-    std::map<int64_t, float> mapGlobalBcVtxZ;
+    tvxLookup.clear();
     for (auto& bc : bcs) {
       int64_t globalBC = bc.globalBC();
       // skip non-colliding bcs for data and anchored runs
@@ -659,13 +677,13 @@ struct EventSelectionTask {
         continue;
       }
       if (bc.selection_bit(kIsTriggerTVX)) {
-        mapGlobalBcWithTVX[globalBC] = bc.globalIndex();
-        mapGlobalBcVtxZ[globalBC] = bc.has_ft0() ? bc.ft0().posZ() : 0;
+        tvxLookup.add(globalBC, {static_cast<int32_t>(bc.globalIndex()), bc.has_ft0() ? bc.ft0().posZ() : 0.f, true});
       }
     }
+    tvxLookup.build();
 
     // protection against empty FT0 maps
-    if (mapGlobalBcWithTVX.size() == 0) {
+    if (tvxLookup.empty()) {
       LOGP(error, "FT0 table is empty or corrupted. Filling evsel table with dummy values");
       for (auto& col : cols) {
         auto bc = col.bc_as<BCsWithBcSelsRun3>();
@@ -762,34 +780,27 @@ struct EventSelectionTask {
 
       int64_t foundGlobalBC = 0;
       int32_t foundBCindex = -1;
+      int foundTvxPos = -1;
 
       if (nPvTracksTOF > 0) {
         // for collisions with TOF tracks:
         // take bc corresponding to TOF track with median time
         int64_t tofGlobalBC = globalBC + TMath::Nint(getMedian(vTrackTimesTOF) / bcNS);
-        std::map<int64_t, int32_t>::iterator it = mapGlobalBcWithTVX.find(tofGlobalBC);
-        if (it != mapGlobalBcWithTVX.end()) {
-          foundGlobalBC = it->first;
-          foundBCindex = it->second;
-        }
+        foundTvxPos = tvxLookup.find(tofGlobalBC);
       } else if (nPvTracksTPCnoTOFnoTRD == 0 && nPvTracksTRDnoTOF > 0) {
         // for collisions with TRD tracks but without TOF or ITSTPC-only tracks:
         // take bc corresponding to TRD track with median time
         int64_t trdGlobalBC = globalBC + TMath::Nint(getMedian(vTrackTimesTRDnoTOF) / bcNS);
-        std::map<int64_t, int32_t>::iterator it = mapGlobalBcWithTVX.find(trdGlobalBC);
-        if (it != mapGlobalBcWithTVX.end()) {
-          foundGlobalBC = it->first;
-          foundBCindex = it->second;
-        }
+        foundTvxPos = tvxLookup.find(trdGlobalBC);
       } else if (nPvTracksHighPtTPCnoTOFnoTRD > 0) {
         // for collisions with high-pt ITSTPC-nonTOF-nonTRD tracks
         // search in 3*confSigmaBCforHighPtTracks range (3*4 bcs by default)
         int64_t meanBC = globalBC + TMath::Nint(sumHighPtTime / sumHighPtW / bcNS);
-        int64_t bestGlobalBC = findBestGlobalBC(meanBC, confSigmaBCforHighPtTracks, vNcontributors[colIndex], col.posZ(), mapGlobalBcVtxZ);
-        if (bestGlobalBC > 0) {
-          foundGlobalBC = bestGlobalBC;
-          foundBCindex = mapGlobalBcWithTVX[bestGlobalBC];
-        }
+        foundTvxPos = findBestTvx(meanBC, confSigmaBCforHighPtTracks, vNcontributors[colIndex], col.posZ());
+      }
+      if (foundTvxPos >= 0) {
+        foundGlobalBC = tvxLookup.getGlobalBC(foundTvxPos);
+        foundBCindex = tvxLookup.getValue(foundTvxPos).bcIndex;
       }
 
       // fill foundBC indices and global BCs
@@ -798,8 +809,8 @@ struct EventSelectionTask {
       vFoundGlobalBC[colIndex] = foundGlobalBC > 0 ? foundGlobalBC : globalBC;
 
       // erase found global BC with TVX from the pool of bcs for the next loop over low-pt TPCnoTOFnoTRD collisions
-      if (foundBCindex >= 0)
-        mapGlobalBcVtxZ.erase(foundGlobalBC);
+      if (foundTvxPos >= 0)
+        tvxLookup.getValue(foundTvxPos).isAvailable = false;
     }
 
     // second loop to match remaining low-pt TPCnoTOFnoTRD collisions
@@ -812,219 +823,26 @@ struct EventSelectionTask {
         int64_t globalBC = bc.globalBC();
         int64_t meanBC = globalBC + TMath::Nint(weightedTime / bcNS);
         int64_t sigmaBC = TMath::CeilNint(weightedSigma / bcNS);
-        int64_t bestGlobalBC = findBestGlobalBC(meanBC, sigmaBC, vNcontributors[colIndex], col.posZ(), mapGlobalBcVtxZ);
-        vFoundGlobalBC[colIndex] = bestGlobalBC > 0 ? bestGlobalBC : globalBC;
-        vFoundBCindex[colIndex] = bestGlobalBC > 0 ? mapGlobalBcWithTVX[bestGlobalBC] : bc.globalIndex();
+        int bestTvxPos = findBestTvx(meanBC, sigmaBC, vNcontributors[colIndex], col.posZ());
+        vFoundGlobalBC[colIndex] = bestTvxPos >= 0 ? tvxLookup.getGlobalBC(bestTvxPos) : globalBC;
+        vFoundBCindex[colIndex] = bestTvxPos >= 0 ? tvxLookup.getValue(bestTvxPos).bcIndex : bc.globalIndex();
       }
       // fill pileup counter
       vCollisionsPerBc[vFoundBCindex[colIndex]]++;
     }
 
-    // save indices of collisions for occupancy calculation (both in ROF and in time range)
-    std::vector<std::vector<int>> vCollsInTimeWin;
-    std::vector<std::vector<int>> vCollsInSameITSROF;
-    std::vector<std::vector<float>> vTimeDeltaForColls; // delta time wrt a given collision
+    // occupancy calculation per ITS ROF and in the pre-defined time window
+    occupancyCalculator.setTimeFrame(bcSOR, nBCsPerTF, rofOffset, rofLength);
+    occupancyCalculator.clear();
+    occupancyCalculator.reserve(cols.size());
     for (auto& col : cols) {
       int32_t colIndex = col.globalIndex();
-      int64_t foundGlobalBC = vFoundGlobalBC[colIndex];
       auto bc = bcs.iteratorAt(vFoundBCindex[colIndex]);
       if (bc.has_foundFT0())
         vAmpFT0CperColl[colIndex] = bc.foundFT0().sumAmpC();
-
-      int64_t TFid = (foundGlobalBC - bcSOR) / nBCsPerTF;
-      int64_t rofId = (foundGlobalBC + 3564 - rofOffset) / rofLength;
-
-      // ### for in-ROF occupancy
-      std::vector<int> vAssocToSameROF;
-      // find all collisions in the same ROF before a given collision
-      int32_t minColIndex = colIndex - 1;
-      while (minColIndex >= 0) {
-        int64_t thisBC = vFoundGlobalBC[minColIndex];
-        // check if this is still the same TF
-        int64_t thisTFid = (thisBC - bcSOR) / nBCsPerTF;
-        if (thisTFid != TFid)
-          break;
-        // int thisRofIdInTF = (thisBC - rofOffset) / rofLength;
-        int64_t thisRofId = (thisBC + 3564 - rofOffset) / rofLength;
-
-        // check if we are within the same ROF
-        if (thisRofId != rofId)
-          break;
-        vAssocToSameROF.push_back(minColIndex);
-        minColIndex--;
-      }
-      // find all collisions in the same ROF after the current one
-      int32_t maxColIndex = colIndex + 1;
-      while (maxColIndex < cols.size()) {
-        int64_t thisBC = vFoundGlobalBC[maxColIndex];
-        int64_t thisTFid = (thisBC - bcSOR) / nBCsPerTF;
-        if (thisTFid != TFid)
-          break;
-        // int thisRofIdInTF = (thisBC - rofOffset) / rofLength;
-        int64_t thisRofId = (thisBC + 3564 - rofOffset) / rofLength;
-        if (thisRofId != rofId)
-          break;
-        vAssocToSameROF.push_back(maxColIndex);
-        maxColIndex++;
-      }
-      vCollsInSameITSROF.push_back(vAssocToSameROF);
-
-      // ### for occupancy in time windows
-      std::vector<int> vAssocToThisCol;
-      std::vector<float> vCollsTimeDeltaWrtGivenColl;
-      // protection against the TF borders
-      if (!vIsFullInfoForOccupancy[colIndex]) {
-        vCollsInTimeWin.push_back(vAssocToThisCol);
-        vTimeDeltaForColls.push_back(vCollsTimeDeltaWrtGivenColl);
-        continue;
-      }
-      // find all collisions in time window before the current one
-      minColIndex = colIndex - 1;
-      while (minColIndex >= 0) {
-        int64_t thisBC = vFoundGlobalBC[minColIndex];
-        // check if this is still the same TF
-        int64_t thisTFid = (thisBC - bcSOR) / nBCsPerTF;
-        if (thisTFid != TFid)
-          break;
-        float dt = (thisBC - foundGlobalBC) * bcNS; // ns
-        // check if we are within the chosen time range
-        if (dt < timeWinOccupancyCalcMinNS)
-          break;
-        vAssocToThisCol.push_back(minColIndex);
-        vCollsTimeDeltaWrtGivenColl.push_back(dt);
-        minColIndex--;
-      }
-      // find all collisions in time window after the current one
-      maxColIndex = colIndex + 1;
-      while (maxColIndex < cols.size()) {
-        int64_t thisBC = vFoundGlobalBC[maxColIndex];
-        int64_t thisTFid = (thisBC - bcSOR) / nBCsPerTF;
-        if (thisTFid != TFid)
-          break;
-        float dt = (thisBC - foundGlobalBC) * bcNS; // ns
-        if (dt > timeWinOccupancyCalcMaxNS)
-          break;
-        vAssocToThisCol.push_back(maxColIndex);
-        vCollsTimeDeltaWrtGivenColl.push_back(dt);
-        maxColIndex++;
-      }
-      vCollsInTimeWin.push_back(vAssocToThisCol);
-      vTimeDeltaForColls.push_back(vCollsTimeDeltaWrtGivenColl);
-    }
-
-    // perform the occupancy calculation per ITS ROF and also in the pre-defined time window
-    std::vector<int> vNumTracksITS567inFullTimeWin(cols.size(), 0); // counter of tracks in full time window for occupancy studies (excluding given event)
-    std::vector<float> vSumAmpFT0CinFullTimeWin(cols.size(), 0);    // sum of FT0C of tracks in full time window for occupancy studies (excluding given event)
-
-    std::vector<bool> vNoCollInTimeRangeStrict(cols.size(), 0);      // no collisions in a specified time range
-    std::vector<bool> vNoCollInTimeRangeNarrow(cols.size(), 0);      // no collisions in a specified time range (narrow)
-    std::vector<bool> vNoHighMultCollInTimeRange(cols.size(), 0);    // no high-mult collisions in a specified time range
-    std::vector<bool> vNoCollInVzDependentTimeRange(cols.size(), 0); // no collisions in a vZ-dependent time range
-
-    std::vector<bool> vNoCollInSameRofStrict(cols.size(), 0);      // to veto events with other collisions in the same ITS ROF
-    std::vector<bool> vNoCollInSameRofStandard(cols.size(), 0);    // to veto events with other collisions in the same ITS ROF, with per-collision multiplicity above threshold
-    std::vector<bool> vNoCollInSameRofWithCloseVz(cols.size(), 0); // to veto events with nearby collisions with close vZ
-
-    for (auto& col : cols) {
-      int32_t colIndex = col.globalIndex();
-      float vZ = col.posZ();
-
-      // ### in-ROF occupancy
-      std::vector<int> vAssocToSameROF = vCollsInSameITSROF[colIndex];
-      int nITS567tracksForRofVetoStrict = 0;        // to veto events with other collisions in the same ITS ROF
-      int nCollsInRofWithFT0CAboveVetoStandard = 0; // to veto events with other collisions in the same ITS ROF, with per-collision multiplicity above threshold
-      int nITS567tracksForRofVetoOnCloseVz = 0;     // to veto events with nearby collisions with close vZ
-      for (uint32_t iCol = 0; iCol < vAssocToSameROF.size(); iCol++) {
-        int thisColIndex = vAssocToSameROF[iCol];
-        nITS567tracksForRofVetoStrict += vTracksITS567perColl[thisColIndex];
-        if (vAmpFT0CperColl[thisColIndex] > confFT0CamplCutVetoOnCollInROF)
-          nCollsInRofWithFT0CAboveVetoStandard++;
-        if (fabs(vCollVz[thisColIndex] - vZ) < confEpsilonVzDiffVetoInROF)
-          nITS567tracksForRofVetoOnCloseVz += vTracksITS567perColl[thisColIndex];
-      }
-      // in-ROF occupancy flags
-      vNoCollInSameRofStrict[colIndex] = (nITS567tracksForRofVetoStrict == 0);
-      vNoCollInSameRofStandard[colIndex] = (nCollsInRofWithFT0CAboveVetoStandard == 0);
-      vNoCollInSameRofWithCloseVz[colIndex] = (nITS567tracksForRofVetoOnCloseVz == 0);
-
-      // ### occupancy in time windows
-      // protection against TF borders
-      if (!vIsFullInfoForOccupancy[colIndex]) { // occupancy in undefined (too close to TF borders)
-        vNumTracksITS567inFullTimeWin[colIndex] = -1;
-        vSumAmpFT0CinFullTimeWin[colIndex] = -1;
-        continue;
-      }
-      std::vector<int> vAssocToThisCol = vCollsInTimeWin[colIndex];
-      std::vector<float> vCollsTimeDeltaWrtGivenColl = vTimeDeltaForColls[colIndex];
-      int nITS567tracksInFullTimeWindow = 0;
-      float sumAmpFT0CInFullTimeWindow = 0;
-      int nITS567tracksForVetoNarrow = 0;      // to veto events with nearby collisions (narrower range)
-      int nITS567tracksForVetoStrict = 0;      // to veto events with nearby collisions
-      int nCollsWithFT0CAboveVetoStandard = 0; // to veto events with per-collision multiplicity above threshold
-      int nITS567tracksForVetoVzDependent = 0; // to veto events with nearby collisions, vZ-dependent time cut
-      for (uint32_t iCol = 0; iCol < vAssocToThisCol.size(); iCol++) {
-        int thisColIndex = vAssocToThisCol[iCol];
-        float dt = vCollsTimeDeltaWrtGivenColl[iCol] / 1e3; // ns -> us
-        float wOccup = 1.;
-        if (confUseWeightsForOccupancyVariable) {
-          // weighted occupancy
-          wOccup = 0;
-          if (dt >= -40 && dt < -5) // collisions in the past
-            wOccup = 1. / 1225 * (dt + 40) * (dt + 40);
-          else if (dt >= -5 && dt < 15) // collisions near a given one
-            wOccup = 1;
-          // else if (dt >= 15 && dt < 100) // collisions from the future
-          //   wOccup = -1. / 85 * dt + 20. / 17;
-          else if (dt >= 15 && dt < 40) // collisions from the future
-            wOccup = -0.4 / 25 * dt + 1.24;
-          else if (dt >= 40 && dt < 100) // collisions from the distant future
-            wOccup = -0.4 / 60 * dt + 0.6 + 0.8 / 3;
-        }
-        nITS567tracksInFullTimeWindow += wOccup * vTracksITS567perColl[thisColIndex];
-        sumAmpFT0CInFullTimeWindow += wOccup * vAmpFT0CperColl[thisColIndex];
-
-        // counting tracks from other collisions in fixed time windows
-        if (fabs(dt) < confTimeRangeVetoOnCollNarrow)
-          nITS567tracksForVetoNarrow += vTracksITS567perColl[thisColIndex];
-        if (fabs(dt) < confTimeRangeVetoOnCollStandard)
-          nITS567tracksForVetoStrict += vTracksITS567perColl[thisColIndex];
-
-        // standard cut on other collisions vs delta-times
-        const float driftV = 2.5; // drift velocity in cm/us, TPC drift_length / drift_time = 250 cm / 100 us
-        if (fabs(dt) < 2.0) {     // us, complete veto on other collisions
-          nCollsWithFT0CAboveVetoStandard++;
-        } else if (dt > -4.0 && dt <= -2.0) { // us, strict veto to suppress fake ITS-TPC matches more
-          if (vAmpFT0CperColl[thisColIndex] > confFT0CamplCutVetoOnCollInTimeRange / 5)
-            nCollsWithFT0CAboveVetoStandard++;
-        } else if (fabs(dt) < 8 + fabs(vZ) / driftV) { // loose veto, 8 us corresponds to maximum possible |vZ|, which is ~20 cm
-          // counting number of other collisions with multiplicity above threshold
-          if (vAmpFT0CperColl[thisColIndex] > confFT0CamplCutVetoOnCollInTimeRange)
-            nCollsWithFT0CAboveVetoStandard++;
-        }
-
-        // vZ-dependent time cut to avoid collinear tracks from other collisions (experimental)
-        if (fabs(dt) < 8 + fabs(vZ) / driftV) {
-          if (dt < 0) {
-            // check distance between given vZ and (moving in two directions) vZ of drifting tracks from past collisions
-            if ((fabs(vCollVz[thisColIndex] - fabs(dt) * driftV - vZ) < confEpsilonDistanceForVzDependentVetoTPC) ||
-                (fabs(vCollVz[thisColIndex] + fabs(dt) * driftV - vZ) < confEpsilonDistanceForVzDependentVetoTPC))
-              nITS567tracksForVetoVzDependent += vTracksITS567perColl[thisColIndex];
-          } else { // dt>0
-            // check distance between drifted vZ of given collision (in two directions) and vZ of future collisions
-            if ((fabs(vZ - dt * driftV - vCollVz[thisColIndex]) < confEpsilonDistanceForVzDependentVetoTPC) ||
-                (fabs(vZ + dt * driftV - vCollVz[thisColIndex]) < confEpsilonDistanceForVzDependentVetoTPC))
-              nITS567tracksForVetoVzDependent += vTracksITS567perColl[thisColIndex];
-          }
-        }
-      }
-      vNumTracksITS567inFullTimeWin[colIndex] = nITS567tracksInFullTimeWindow; // occupancy by a sum of number of ITS tracks (without a current collision)
-      vSumAmpFT0CinFullTimeWin[colIndex] = sumAmpFT0CInFullTimeWindow;         // occupancy by a sum of FT0C amplitudes (without a current collision)
-      // occupancy flags based on nearby collisions
-      vNoCollInTimeRangeNarrow[colIndex] = (nITS567tracksForVetoNarrow == 0);
-      vNoCollInTimeRangeStrict[colIndex] = (nITS567tracksForVetoStrict == 0);
-      vNoHighMultCollInTimeRange[colIndex] = (nCollsWithFT0CAboveVetoStandard == 0);
-      vNoCollInVzDependentTimeRange[colIndex] = (nITS567tracksForVetoVzDependent == 0); // experimental
+      occupancyCalculator.addCollision(vFoundGlobalBC[colIndex], vCollVz[colIndex], vTracksITS567perColl[colIndex], vAmpFT0CperColl[colIndex], vIsFullInfoForOccupancy[colIndex]);
     }
+    occupancyCalculator.calculate();
 
     for (auto& col : cols) {
       int32_t colIndex = col.globalIndex();
@@ -1050,14 +868,14 @@ struct EventSelectionTask {
       selection |= isGoodZvtxFT0vsPV ? BIT(kIsGoodZvtxFT0vsPV) : 0;
 
       // selection bits based on occupancy time pattern
-      selection |= vNoCollInTimeRangeNarrow[colIndex] ? BIT(kNoCollInTimeRangeNarrow) : 0;
-      selection |= vNoCollInTimeRangeStrict[colIndex] ? BIT(kNoCollInTimeRangeStrict) : 0;
-      selection |= vNoHighMultCollInTimeRange[colIndex] ? BIT(kNoCollInTimeRangeStandard) : 0;
-      selection |= vNoCollInVzDependentTimeRange[colIndex] ? BIT(kNoCollInTimeRangeVzDependent) : 0;
+      selection |= occupancyCalculator.getFlag(colIndex, CollisionOccupancyCalculator::NoCollInTimeRangeNarrow) ? BIT(kNoCollInTimeRangeNarrow) : 0;
+      selection |= occupancyCalculator.getFlag(colIndex, CollisionOccupancyCalculator::NoCollInTimeRangeStrict) ? BIT(kNoCollInTimeRangeStrict) : 0;
+      selection |= occupancyCalculator.getFlag(colIndex, CollisionOccupancyCalculator::NoCollInTimeRangeStandard) ? BIT(kNoCollInTimeRangeStandard) : 0;
+      selection |= occupancyCalculator.getFlag(colIndex, CollisionOccupancyCalculator::NoCollInTimeRangeVzDependent) ? BIT(kNoCollInTimeRangeVzDependent) : 0;
 
       // selection bits based on ITS in-ROF occupancy
-      selection |= vNoCollInSameRofStrict[colIndex] ? BIT(kNoCollInRofStrict) : 0;
-      selection |= (vNoCollInSameRofStandard[colIndex] && vNoCollInSameRofWithCloseVz[colIndex]) ? BIT(kNoCollInRofStandard) : 0;
+      selection |= occupancyCalculator.getFlag(colIndex, CollisionOccupancyCalculator::NoCollInRofStrict) ? BIT(kNoCollInRofStrict) : 0;
+      selection |= (occupancyCalculator.getFlag(colIndex, CollisionOccupancyCalculator::NoCollInRofStandard) && occupancyCalculator.getFlag(colIndex, CollisionOccupancyCalculator::NoCollInRofWithCloseVz)) ? BIT(kNoCollInRofStandard) : 0;
 
       // apply int7-like selections
       bool sel7 = 0;
@@ -1079,7 +897,7 @@ struct EventSelectionTask {
       int bcInTF = (bc.globalBC() - bcSOR) % nBCsPerTF;
 
       evsel(alias, selection, sel7, sel8, foundBC, foundFT0, foundFV0, foundFDD, foundZDC, bcInTF,
-            vNumTracksITS567inFullTimeWin[colIndex], vSumAmpFT0CinFullTimeWin[colIndex]);
+            occupancyCalculator.getTrackOccupancy(colIndex), occupancyCalculator.getFT0COccupancy(colIndex));
     }
   }
 
@@ -20,6 +20,7 @@
 #include "Common/DataModel/Multiplicity.h"
 #include "Common/DataModel/EventSelection.h"
 #include "Common/DataModel/TrackSelectionTables.h"
+#include "Common/Core/CalibrationLookup.h"
 #include "TableHelper.h"
 #include "MetadataHelper.h"
 #include "TList.h"
@@ -127,6 +128,9 @@ struct MultiplicityTable {
   TProfile* hVtxZFDDA;
   TProfile* hVtxZFDDC;
   TProfile* hVtxZNTracks;
+  // vertex-z equalization: flat copies of the profiles and their value at vz = 0
+  CalibrationHistogram calibVtxZFV0A, calibVtxZFT0A, calibVtxZFT0C, calibVtxZFDDA, calibVtxZFDDC, calibVtxZNTracks;
+  double calibVtxZ0FV0A, calibVtxZ0FT0A, calibVtxZ0FT0C, calibVtxZ0FDDA, calibVtxZ0FDDC, calibVtxZ0NTracks;
   std::vector<int> mEnabledTables; // Vector of enabled tables
 
   // Debug output
@@ -408,6 +412,17 @@ struct MultiplicityTable {
             if (!hVtxZFV0A || !hVtxZFT0A || !hVtxZFT0C || !hVtxZFDDA || !hVtxZFDDC || !hVtxZNTracks) {
               LOGF(error, "Problem loading CCDB objects! Please check");
               lCalibLoaded = false;
+            } else {
+              auto compileCalibration = [](TProfile* profile, CalibrationHistogram& calib, double& valueAtZero) {
+                calib = CalibrationHistogram(profile);
+                valueAtZero = calib.interpolate(0.0);
+              };
+              compileCalibration(hVtxZFV0A, calibVtxZFV0A, calibVtxZ0FV0A);
+              compileCalibration(hVtxZFT0A, calibVtxZFT0A, calibVtxZ0FT0A);
+              compileCalibration(hVtxZFT0C, calibVtxZFT0C, calibVtxZ0FT0C);
+              compileCalibration(hVtxZFDDA, calibVtxZFDDA, calibVtxZ0FDDA);
+              compileCalibration(hVtxZFDDC, calibVtxZFDDC, calibVtxZ0FDDC);
+              compileCalibration(hVtxZNTracks, calibVtxZNTracks, calibVtxZ0NTracks);
             }
           } else {
             LOGF(error, "Problem loading CCDB object! Please check");
@@ -580,15 +595,15 @@ struct MultiplicityTable {
           case kFV0MultZeqs: // Z equalized FV0
           {
             if (fabs(collision.posZ()) < 15.0f && lCalibLoaded) {
-              multZeqFV0A = hVtxZFV0A->Interpolate(0.0) * multFV0A / hVtxZFV0A->Interpolate(collision.posZ());
+              multZeqFV0A = calibVtxZ0FV0A * multFV0A / calibVtxZFV0A.interpolate(collision.posZ());
             }
             tableFV0Zeqs(multZeqFV0A);
           } break;
           case kFT0MultZeqs: // Z equalized FT0
           {
             if (fabs(collision.posZ()) < 15.0f && lCalibLoaded) {
-              multZeqFT0A = hVtxZFT0A->Interpolate(0.0) * multFT0A / hVtxZFT0A->Interpolate(collision.posZ());
-              multZeqFT0C = hVtxZFT0C->Interpolate(0.0) * multFT0C / hVtxZFT0C->Interpolate(collision.posZ());
+              multZeqFT0A = calibVtxZ0FT0A * multFT0A / calibVtxZFT0A.interpolate(collision.posZ());
+              multZeqFT0C = calibVtxZ0FT0C * multFT0C / calibVtxZFT0C.interpolate(collision.posZ());
             }
             if (produceHistograms.value) {
               histos.fill(HIST("FT0A"), multFT0A, multZeqFT0A);
@@ -601,15 +616,15 @@ struct MultiplicityTable {
           case kFDDMultZeqs: // Z equalized FDD
           {
             if (fabs(collision.posZ()) < 15.0f && lCalibLoaded) {
-              multZeqFDDA = hVtxZFDDA->Interpolate(0.0) * multFDDA / hVtxZFDDA->Interpolate(collision.posZ());
-              multZeqFDDC = hVtxZFDDC->Interpolate(0.0) * multFDDC / hVtxZFDDC->Interpolate(collision.posZ());
+              multZeqFDDA = calibVtxZ0FDDA * multFDDA / calibVtxZFDDA.interpolate(collision.posZ());
+              multZeqFDDC = calibVtxZ0FDDC * multFDDC / calibVtxZFDDC.interpolate(collision.posZ());
             }
             tableFDDZeqs(multZeqFDDA, multZeqFDDC);
           } break;
           case kPVMultZeqs: // Z equalized PV
           {
             if (fabs(collision.posZ()) < 15.0f && lCalibLoaded) {
-              multZeqNContribs = hVtxZNTracks->Interpolate(0.0) * multNContribs / hVtxZNTracks->Interpolate(collision.posZ());
+              multZeqNContribs = calibVtxZ0NTracks * multNContribs / calibVtxZNTracks.interpolate(collision.posZ());
             }
             tablePVZeqs(multZeqNContribs);
           } break;
@@ -15,6 +15,7 @@
 
 #include "TableHelper.h"
 #include "Common/Tools/TrackTuner.h"
+#include "Common/CCDB/CCDBSnapshot.h"
 
 // The Run 3 AO2D stores the tracks at the point of innermost update. For a track with ITS this is the innermost (or second innermost)
 // ITS layer. For a track without ITS, this is the TPC inner wall or for loopers in the TPC even a radius beyond that.
@@ -41,6 +42,7 @@ struct TrackPropagation {
   Produces<aod::TrackTunerTable> tunertable;
 
   Service<o2::ccdb::BasicCCDBManager> ccdb;
+  CCDBSnapshot ccdbSnapshot;
 
   bool fillTracksDCA = false;
   bool fillTracksDCACov = false;
@@ -58,6 +60,8 @@ struct TrackPropagation {
   Configurable<std::string> geoPath{"geoPath", "GLO/Config/GeometryAligned", "Path of the geometry file"};
   Configurable<std::string> grpmagPath{"grpmagPath", "GLO/Config/GRPMagField", "CCDB path of the GRPMagField object"};
   Configurable<std::string> mVtxPath{"mVtxPath", "GLO/Calib/MeanVertex", "Path of the mean vertex file"};
+  Configurable<int> ccdbSnapshotMode{"ccdbSnapshotMode", 0, "CCDB objects: 0 = from the CCDB, 1 = from the CCDB and recorded to ccdbSnapshotFile, 2 = replayed from ccdbSnapshotFile"};
+  Configurable<std::string> ccdbSnapshotFile{"ccdbSnapshotFile", "", "Local bundle of CCDB objects for recording or replay"};
   Configurable<float> minPropagationRadius{"minPropagationDistance", o2::constants::geom::XTPCInnerRef + 0.1, "Only tracks which are at a smaller radius will be propagated, defaults to TPC inner wall"};
   // for TrackTuner only (MC smearing)
   Configurable<bool> useTrackTuner{"useTrackTuner", false, "Apply track tuner corrections to MC"};
@@ -108,8 +112,12 @@ struct TrackPropagation {
     ccdb->setURL(ccdburl);
     ccdb->setCaching(true);
     ccdb->setLocalObjectValidityChecking();
+    ccdbSnapshot.init(ccdb.operator->(), ccdbSnapshotMode, ccdbSnapshotFile);
+    if (ccdbSnapshotMode == CCDBSnapshot::kRecord) {
+      initContext.services().get<CallbackService>().set<CallbackService::Id::Stop>([this]() { ccdbSnapshot.close(); });
+    }
 
-    lut = o2::base::MatLayerCylSet::rectifyPtrFromFile(ccdb->get<o2::base::MatLayerCylSet>(lutPath));
+    lut = o2::base::MatLayerCylSet::rectifyPtrFromFile(ccdbSnapshot.getForTimeStamp<o2::base::MatLayerCylSet>(lutPath, ccdb->getTimestamp()));
     // Histograms for track tuner
     AxisSpec axisBinsDCA = {600, -0.15f, 0.15f, "#it{dca}_{xy} (cm)"};
     registry.add("hDCAxyVsPtRec", "hDCAxyVsPtRec", kTH2F, {axisBinsDCA, axisPtQA});
@@ -131,31 +139,48 @@ struct TrackPropagation {
     if (runNumber == bc.runNumber()) {
       return;
     }
-    grpmag = ccdb->getForTimeStamp<o2::parameters::GRPMagField>(grpmagPath, bc.timestamp());
+    ccdbSnapshot.setRun(bc.runNumber());
+    grpmag = ccdbSnapshot.getForTimeStamp<o2::parameters::GRPMagField>(grpmagPath, bc.timestamp());
     LOG(info) << "Setting magnetic field to current " << grpmag->getL3Current() << " A for run " << bc.runNumber() << " from its GRPMagField CCDB object";
     o2::base::Propagator::initFieldFromGRP(grpmag);
     o2::base::Propagator::Instance()->setMatLUT(lut);
-    mMeanVtx = ccdb->getForTimeStamp<o2::dataformats::MeanVertexObject>(mVtxPath, bc.timestamp());
+    mMeanVtx = ccdbSnapshot.getForTimeStamp<o2::dataformats::MeanVertexObject>(mVtxPath, bc.timestamp());
+    mMeanVtxBase.setPos({mMeanVtx->getX(), mMeanVtx->getY(), mMeanVtx->getZ()});
+    mMeanVtxBase.setCov(mMeanVtx->getSigmaX() * mMeanVtx->getSigmaX(), 0.0f, mMeanVtx->getSigmaY() * mMeanVtx->getSigmaY(), 0.0f, 0.0f, mMeanVtx->getSigmaZ() * mMeanVtx->getSigmaZ());
     runNumber = bc.runNumber();
   }
 
   // Running variables
   gpu::gpustd::array<float, 2> mDcaInfo;
   o2::dataformats::DCA mDcaInfoCov;
-  o2::dataformats::VertexBase mVtx;
+  o2::dataformats::VertexBase mMeanVtxBase;                    // mean vertex, for the tracks without collision
+  std::vector<o2::dataformats::VertexBase> mCollisionVertices; // vertices of the collisions of the DF, by collision index
   o2::track::TrackParametrization<float> mTrackPar;
   o2::track::TrackParametrizationWithError<float> mTrackParCov;
 
+  // the vertices are set once per DF instead of once per propagated track
+  void fillCollisionVertices(aod::Collisions const& collisions)
+  {
+    mCollisionVertices.resize(collisions.size());
+    for (auto const& collision : collisions) {
+      auto& vtx = mCollisionVertices[collision.globalIndex()];
+      vtx.setPos({collision.posX(), collision.posY(), collision.posZ()});
+      vtx.setCov(collision.covXX(), collision.covXY(), collision.covYY(), collision.covXZ(), collision.covYZ(), collision.covZZ());
+    }
+  }
+
   template <typename TTrack, typename TParticle, bool isMc, bool fillCovMat = false, bool useTrkPid = false>
   void fillTrackTables(TTrack const& tracks,
                        TParticle const&,
-                       aod::Collisions const&,
+                       aod::Collisions const& collisions,
                        aod::BCsWithTimestamps const& bcs)
   {
     if (bcs.size() == 0) {
       return;
     }
     initCCDB(bcs.begin());
+    fillCollisionVertices(collisions);
+    auto propagator = o2::base::Propagator::Instance();
 
     if constexpr (fillCovMat) {
       tracksParCovPropagated.reserve(tracks.size());
@@ -211,23 +236,12 @@ struct TrackPropagation {
         } // MC and fillCovMat block ends
         bool isPropagationOK = true;
 
-        if (track.has_collision()) {
-          auto const& collision = track.collision();
-          if constexpr (fillCovMat) {
-            mVtx.setPos({collision.posX(), collision.posY(), collision.posZ()});
-            mVtx.setCov(collision.covXX(), collision.covXY(), collision.covYY(), collision.covXZ(), collision.covYZ(), collision.covZZ());
-            isPropagationOK = o2::base::Propagator::Instance()->propagateToDCABxByBz(mVtx, mTrackParCov, 2.f, matCorr, &mDcaInfoCov);
-          } else {
-            isPropagationOK = o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, mTrackPar, 2.f, matCorr, &mDcaInfo);
-          }
+        // the tracks are still propagated one at a time: the field and material lookups are done inside o2::base::Propagator per step
+        const auto& vtx = track.has_collision() ? mCollisionVertices[track.collisionId()] : mMeanVtxBase;
+        if constexpr (fillCovMat) {
+          isPropagationOK = propagator->propagateToDCABxByBz(vtx, mTrackParCov, 2.f, matCorr, &mDcaInfoCov);
         } else {
-          if constexpr (fillCovMat) {
-            mVtx.setPos({mMeanVtx->getX(), mMeanVtx->getY(), mMeanVtx->getZ()});
-            mVtx.setCov(mMeanVtx->getSigmaX() * mMeanVtx->getSigmaX(), 0.0f, mMeanVtx->getSigmaY() * mMeanVtx->getSigmaY(), 0.0f, 0.0f, mMeanVtx->getSigmaZ() * mMeanVtx->getSigmaZ());
-            isPropagationOK = o2::base::Propagator::Instance()->propagateToDCABxByBz(mVtx, mTrackParCov, 2.f, matCorr, &mDcaInfoCov);
-          } else {
-            isPropagationOK = o2::base::Propagator::Instance()->propagateToDCABxByBz({mMeanVtx->getX(), mMeanVtx->getY(), mMeanVtx->getZ()}, mTrackPar, 2.f, matCorr, &mDcaInfo);
-          }
+          isPropagationOK = propagator->propagateToDCABxByBz(vtx.getXYZ(), mTrackPar, 2.f, matCorr, &mDcaInfo);
         }
         if (isPropagationOK) {
           trackType = aod::track::Track;
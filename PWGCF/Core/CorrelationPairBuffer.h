@@ -0,0 +1,321 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#ifndef O2_ANALYSIS_CORRELATIONPAIRBUFFER_H
+#define O2_ANALYSIS_CORRELATIONPAIRBUFFER_H
+
+#include <algorithm>
+#include <vector>
+
+#include <TArray.h>
+#include <TAxis.h>
+#include <THn.h>
+
+#include "Framework/HistogramSpec.h"
+#include "Framework/Logger.h"
+#include "Framework/StepTHn.h"
+
+// Pre-binned filling of the CorrelationContainer pair histogram and pre-binned efficiency look-up
+
+// Binning of one axis, findBin gives the same result as TAxis::FindBin (0 = underflow, nBins + 1 = overflow)
+class CorrelationBinning
+{
+ public:
+  CorrelationBinning() = default;
+  explicit CorrelationBinning(const o2::framework::AxisSpec& axis)
+  {
+    if (axis.nBins.has_value()) {
+      setUniform(axis.nBins.value(), axis.binEdges[0], axis.binEdges[1]);
+    } else {
+      mEdges = axis.binEdges;
+      mNbins = mEdges.size() - 1;
+    }
+  }
+  explicit CorrelationBinning(const TAxis* axis)
+  {
+    if (axis->IsVariableBinSize()) {
+      mEdges.assign(axis->GetXbins()->GetArray(), axis->GetXbins()->GetArray() + axis->GetNbins() + 1);
+      mNbins = axis->GetNbins();
+    } else {
+      setUniform(axis->GetNbins(), axis->GetXmin(), axis->GetXmax());
+    }
+  }
+
+  int getNbins() const { return mNbins; }
+
+  int findBin(double x) const
+  {
+    if (mUniform) {
+      if (x < mMin) {
+        return 0;
+      }
+      if (!(x < mMax)) {
+        return mNbins + 1;
+      }
+      return 1 + static_cast<int>(mNbins * (x - mMin) / (mMax - mMin));
+    }
+    return std::upper_bound(mEdges.begin(), mEdges.end(), x) - mEdges.begin();
+  }
+
+  // 0-based bin, -1 for under- and overflow
+  int findBinNoOverflow(double x) const
+  {
+    int bin = findBin(x);
+    return (bin < 1 || bin > mNbins) ? -1 : bin - 1;
+  }
+
+  double getBinCenter(int bin) const
+  {
+    if (mUniform) {
+      return mMin + (bin - 0.5) * (mMax - mMin) / mNbins;
+    }
+    return 0.5 * (mEdges[bin - 1] + mEdges[bin]);
+  }
+
+ private:
+  void setUniform(int nBins, double min, double max)
+  {
+    mUniform = true;
+    mNbins = nBins;
+    mMin = min;
+    mMax = max;
+  }
+
+  bool mUniform = false;
+  int mNbins = 0;
+  double mMin = 0;
+  double mMax = 0;
+  std::vector<double> mEdges; // only for variable bin size
+};
+
+// Accumulates the pairs of one event (or pair of events) and adds them to the pair StepTHn at once.
+// The pair histogram has the axes (delta eta, pT assoc, pT trig, multiplicity, delta phi, vertex[, user axis]).
+// The multiplicity and vertex bins are found once per event, the pT (and user axis) bins once per track, and only
+// delta eta and delta phi per pair. The pairs are summed in a dense block over all axes but multiplicity and vertex;
+// only the filled cells are added to (and reset after) flush. The global bin follows the StepTHn layout
+// (row-major with the last axis running fastest, no under- and overflow bins).
+// The block is only allocated up to maxCells cells (e.g. with a fine mass axis it can be as large as the pair histogram
+// without the multiplicity and vertex axes); above, isBuffered() is false and the pairs have to be filled directly.
+class CorrelationPairBuffer
+{
+ public:
+  enum PairAxis { DeltaEta = 0,
+                  PtAssoc,
+                  PtTrig,
+                  Multiplicity,
+                  DeltaPhi,
+                  Vertex,
+                  User,
+                  PairAxisLastEntry };
+
+  void init(const std::vector<o2::framework::AxisSpec>& pairAxis, long maxCells)
+  {
+    if (pairAxis.size() != User && pairAxis.size() != PairAxisLastEntry) {
+      LOGF(fatal, "CorrelationPairBuffer: %d axes given, expected %d or %d", static_cast<int>(pairAxis.size()), static_cast<int>(User), static_cast<int>(PairAxisLastEntry));
+    }
+    mAxes.clear();
+    for (const auto& axis : pairAxis) {
+      mAxes.emplace_back(axis);
+    }
+    mHasUserAxis = (pairAxis.size() == PairAxisLastEntry);
+
+    long cells = static_cast<long>(nBins(DeltaEta)) * nBins(PtAssoc) * nBins(PtTrig) * nBins(DeltaPhi) * nBins(User);
+    mBuffered = (cells <= maxCells);
+    if (!mBuffered) {
+      LOGF(info, "CorrelationPairBuffer: per-event block with %ld cells above the limit of %ld cells, pairs are filled directly", cells, maxCells);
+      mSumw.clear();
+      mSumw2.clear();
+      mIsTouched.clear();
+      mTouched.clear();
+      return;
+    }
+    LOGF(info, "CorrelationPairBuffer: per-event block with %ld cells", cells);
+    mSumw.assign(cells, 0.);
+    mSumw2.assign(cells, 0.);
+    mIsTouched.assign(cells, false);
+    mTouched.clear();
+    mTouched.reserve(std::min(cells, 1L << 16));
+  }
+
+  // false if the block is above the cell limit given to init, fill and flush must not be used then
+  bool isBuffered() const { return mBuffered; }
+  const CorrelationBinning& getAxis(PairAxis axis) const { return mAxes[axis]; }
+  bool hasUserAxis() const { return mHasUserAxis; }
+
+  // 0-based bin without under- and overflow (-1) on one of the pair axes
+  int findBin(PairAxis axis, double value) const { return (axis == User && !mHasUserAxis) ? 0 : mAxes[axis].findBinNoOverflow(value); }
+
+  // returns false if the event is outside of the multiplicity or vertex axis, in which case no pair can be filled
+  bool setEvent(float multiplicity, float posZ)
+  {
+    mMultiplicityBin = findBin(Multiplicity, multiplicity);
+    mVertexBin = findBin(Vertex, posZ);
+    return mMultiplicityBin >= 0 && mVertexBin >= 0;
+  }
+
+  // all bins 0-based and inside the axes
+  void fill(int deltaEtaBin, int ptAssocBin, int ptTrigBin, int deltaPhiBin, int userBin, double weight)
+  {
+    long cell = (((static_cast<long>(deltaEtaBin) * nBins(PtAssoc) + ptAssocBin) * nBins(PtTrig) + ptTrigBin) * nBins(DeltaPhi) + deltaPhiBin) * nBins(User) + userBin;
+    if (!mIsTouched[cell]) {
+      mIsTouched[cell] = true;
+      mTouched.push_back(cell);
+    }
+    mSumw[cell] += weight;
+    mSumw2[cell] += weight * weight;
+    if (weight != 1.) {
+      mUnitWeights = false;
+    }
+  }
+
+  // adds the accumulated pairs to the given step and resets the buffer
+  void flush(StepTHn* hist, int step)
+  {
+    if (mTouched.empty()) {
+      return;
+    }
+
+    // StepTHn creates its containers at the first fill: the value container always, the sumw2 container for weights != 1
+    if (hist->getValues(step) == nullptr || (!mUnitWeights && hist->getSumw2(step) == nullptr)) {
+      primeContainers(hist, step, mUnitWeights);
+    }
+    TArray* values = hist->getValues(step);
+    TArray* sumw2 = hist->getSumw2(step);
+
+    for (const auto& cell : mTouched) {
+      if (mSumw2[cell] != 0.) { // cells which were filled only with weight 0 do not change the histogram
+        Long64_t bin = getGlobalBin(cell);
+        values->SetAt(values->GetAt(bin) + mSumw[cell], bin);
+        if (sumw2) {
+          sumw2->SetAt(sumw2->GetAt(bin) + mSumw2[cell], bin);
+        }
+      }
+      mSumw[cell] = 0.;
+      mSumw2[cell] = 0.;
+      mIsTouched[cell] = false;
+    }
+    mTouched.clear();
+    mUnitWeights = true;
+  }
+
+ private:
+  int nBins(PairAxis axis) const { return (axis == User && !mHasUserAxis) ? 1 : mAxes[axis].getNbins(); }
+
+  Long64_t getGlobalBin(long cell) const
+  {
+    int bins[PairAxisLastEntry];
+    for (int axis : {User, DeltaPhi, PtTrig, PtAssoc, DeltaEta}) {
+      bins[axis] = cell % nBins(static_cast<PairAxis>(axis));
+      cell /= nBins(static_cast<PairAxis>(axis));
+    }
+    bins[Multiplicity] = mMultiplicityBin;
+    bins[Vertex] = mVertexBin;
+
+    Long64_t bin = 0;
+    for (int axis = 0; axis < PairAxisLastEntry; axis++) {
+      bin = bin * nBins(static_cast<PairAxis>(axis)) + bins[axis];
+    }
+    return bin;
+  }
+
+  // Fills the bin of the first filled cell once through StepTHn::Fill, which allocates the containers of this step, and
+  // removes the entry again. The global bin computed here must be the one filled by StepTHn, otherwise the direct
+  // additions in flush would go to the wrong bins.
+  void primeContainers(StepTHn* hist, int step, bool unitWeights)
+  {
+    const Long64_t globalBin = getGlobalBin(mTouched.front());
+    Long64_t bin = globalBin;
+    double x[PairAxisLastEntry];
+    for (int axis = PairAxisLastEntry - 1; axis >= 0; axis--) {
+      x[axis] = mAxes[std::min(axis, static_cast<int>(mAxes.size()) - 1)].getBinCenter(bin % nBins(static_cast<PairAxis>(axis)) + 1);
+      bin /= nBins(static_cast<PairAxis>(axis));
+    }
+    // a weight != 1 creates also the sumw2 container
+    const double weight = unitWeights ? 1. : 2.;
+    const double before = (hist->getValues(step) != nullptr && globalBin < hist->getValues(step)->GetSize()) ? hist->getValues(step)->GetAt(globalBin) : 0.;
+    if (mHasUserAxis) {
+      hist->Fill(step, x[0], x[1], x[2], x[3], x[4], x[5], x[6], weight);
+    } else {
+      hist->Fill(step, x[0], x[1], x[2], x[3], x[4], x[5], weight);
+    }
+    TArray* values = hist->getValues(step);
+    if (values == nullptr || globalBin >= values->GetSize() || values->GetAt(globalBin) - before != weight) {
+      LOGF(fatal, "CorrelationPairBuffer: the pair histogram does not have the binning or bin layout of the buffer");
+    }
+    values->SetAt(values->GetAt(globalBin) - weight, globalBin);
+    TArray* sumw2 = hist->getSumw2(step);
+    if (sumw2) {
+      sumw2->SetAt(sumw2->GetAt(globalBin) - weight * weight, globalBin);
+    }
+  }
+
+  std::vector<CorrelationBinning> mAxes;
+  bool mHasUserAxis = false;
+  bool mBuffered = false;
+  int mMultiplicityBin = -1;
+  int mVertexBin = -1;
+  std::vector<double> mSumw;  // sum of weights per cell of the current event
+  std::vector<double> mSumw2; // sum of squared weights per cell of the current event
+  std::vector<bool> mIsTouched; // cell is in mTouched
+  std::vector<long> mTouched;   // cells filled in the current event
+  bool mUnitWeights = true;     // all weights of the current event are 1
+};
+
+// Efficiency THn (eta, pT, multiplicity, vertex) copied into a flat array. The multiplicity and vertex bins are found
+// once per event, afterwards only eta and pT are binned per track. Values are identical to THn::GetBinContent.
+class CorrelationEfficiencyCache
+{
+ public:
+  void init(THnBase* eff)
+  {
+    if (eff->GetNdimensions() != 4) {
+      LOGF(fatal, "CorrelationEfficiencyCache: efficiency histogram has %d dimensions, expected 4", eff->GetNdimensions());
+    }
+    for (int i = 0; i < 4; i++) {
+      mAxes[i] = CorrelationBinning(eff->GetAxis(i));
+      mSizes[i] = mAxes[i].getNbins() + 2;
+    }
+    mValues.resize(static_cast<long>(mSizes[0]) * mSizes[1] * mSizes[2] * mSizes[3]);
+    int idx[4];
+    long cell = 0;
+    for (idx[0] = 0; idx[0] < mSizes[0]; idx[0]++) {
+      for (idx[1] = 0; idx[1] < mSizes[1]; idx[1]++) {
+        for (idx[2] = 0; idx[2] < mSizes[2]; idx[2]++) {
+          for (idx[3] = 0; idx[3] < mSizes[3]; idx[3]++) {
+            mValues[cell++] = eff->GetBinContent(idx);
+          }
+        }
+      }
+    }
+  }
+
+  bool isInitialized() const { return !mValues.empty(); }
+
+  void setEvent(float multiplicity, float posZ)
+  {
+    mMultiplicityBin = mAxes[2].findBin(multiplicity);
+    mVertexBin = mAxes[3].findBin(posZ);
+  }
+
+  double get(float eta, float pt) const
+  {
+    return mValues[((static_cast<long>(mAxes[0].findBin(eta)) * mSizes[1] + mAxes[1].findBin(pt)) * mSizes[2] + mMultiplicityBin) * mSizes[3] + mVertexBin];
+  }
+
+ private:
+  CorrelationBinning mAxes[4];
+  int mSizes[4] = {0, 0, 0, 0}; // bins per axis including under- and overflow
+  int mMultiplicityBin = 0;
+  int mVertexBin = 0;
+  std::vector<double> mValues;
+};
+
+#endif
@@ -25,6 +25,9 @@
 // #include "Framework/Logger.h"
 // #include "Common/DataModel/Multiplicity.h"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <vector>
 #include <memory>
 #include "TLorentzVector.h"
@@ -375,6 +378,242 @@ float FemtoPair<TrackType>::GetGammaOut() const
 
   return fourmomentasum.Gamma();
 }
+
+//====================================================================================
+
+// vertex&mult bin of an event for the mixing as a single integer: vertexBin * (N_multBins * N_subBins) + multBin * N_subBins + subBin; -1 if outside of the binning
+inline int getMixingBin(float const& vertexZ, float const& vertexZmax, int const& NvertexBins, float const& mult, std::vector<float> const& multBinning, int const& NsubBins = 1)
+{
+  if (std::fabs(vertexZ) >= vertexZmax)
+    return -1;
+  int multBin = getBinIndex<int>(mult, multBinning);
+  if (multBin < 0 || multBin >= static_cast<int>(multBinning.size()) - 1)
+    return -1;
+
+  int vertexBin = std::min(static_cast<int>(std::floor((vertexZ + vertexZmax) / (2 * vertexZmax / NvertexBins))), NvertexBins - 1);
+  int subBin = 0;
+  if (NsubBins > 1) {
+    float subBinWidth = (multBinning[multBin + 1] - multBinning[multBin]) / NsubBins;
+    subBin = std::min(static_cast<int>(std::floor((mult - multBinning[multBin]) / subBinWidth)), NsubBins - 1);
+  }
+  return (vertexBin * (static_cast<int>(multBinning.size()) - 1) + multBin) * std::max(NsubBins, 1) + subBin;
+}
+
+// mult bin (without the sub-binning) from the bin given by getMixingBin
+inline int getMultBinFromMixingBin(int const& mixingBin, int const& NmultBins, int const& NsubBins = 1)
+{
+  return (mixingBin / std::max(NsubBins, 1)) % NmultBins;
+}
+
+//====================================================================================
+
+// selected particles of one event in SoA layout, everything needed by FemtoPairKernel is precomputed once per particle
+class FemtoParticleArray
+{
+ public:
+  static constexpr std::array<float, 9> TPCradii = {0.85, 1.05, 1.25, 1.45, 1.65, 1.85, 2.05, 2.25, 2.45}; // the same as in FemtoPair
+  static constexpr int NRadii = TPCradii.size() + 1;                                                      // phi* is stored for the dEta-dPhi* cut radius (index 0) and for TPCradii
+
+  // capacity is kept, so an array reused for many events allocates only while growing
+  void clear()
+  {
+    _eta.clear();
+    _theta.clear();
+    _px.clear();
+    _py.clear();
+    _pz.clear();
+    _e.clear();
+    _phiStar.clear();
+  }
+  std::size_t size() const { return _eta.size(); }
+  bool empty() const { return _eta.empty(); }
+
+  template <typename TrackType>
+  void push_back(TrackType const& track, double const& mass, float const& magfield, float const& radiusTPC)
+  {
+    const double pt = track.pt();
+    const double phi = track.phi();
+    const double pz = pt * std::sinh(static_cast<double>(track.eta()));
+
+    _eta.push_back(track.eta());
+    _theta.push_back(THETA(track.eta()));
+    _px.push_back(pt * std::cos(phi));
+    _py.push_back(pt * std::sin(phi));
+    _pz.push_back(pz);
+    _e.push_back(std::sqrt(pt * pt + pz * pz + mass * mass));
+
+    _phiStar.push_back(track.phiStar(magfield, radiusTPC));
+    for (const auto& radius : TPCradii)
+      _phiStar.push_back(track.phiStar(magfield, radius));
+  }
+
+  float eta(std::size_t i) const { return _eta[i]; }
+  float theta(std::size_t i) const { return _theta[i]; }
+  double px(std::size_t i) const { return _px[i]; }
+  double py(std::size_t i) const { return _py[i]; }
+  double pz(std::size_t i) const { return _pz[i]; }
+  double e(std::size_t i) const { return _e[i]; }
+  float phiStar(std::size_t i, int radiusIndex = 0) const { return _phiStar[i * NRadii + radiusIndex]; }
+
+  const double* px() const { return _px.data(); }
+  const double* py() const { return _py.data(); }
+
+ private:
+  std::vector<float> _eta;
+  std::vector<float> _theta;
+  std::vector<double> _px;
+  std::vector<double> _py;
+  std::vector<double> _pz;
+  std::vector<double> _e;
+  std::vector<float> _phiStar; // NRadii values per particle
+};
+
+//====================================================================================
+
+// pair variables calculated directly from the FemtoParticleArray (no TLorentzVector, no per pair look-up of the masses);
+// the results are the same as of the corresponding FemtoPair getters
+class FemtoPairKernel
+{
+ public:
+  void SetIdentical(const bool& isidentical) { _isidentical = isidentical; }
+  bool IsIdentical() const { return _isidentical; }
+
+  // kT of the pairs (i, j) for all j in [jFirst, second.size()), written to kT[j - jFirst]; plain loop over the arrays, so it can be vectorized
+  void GetKt(FemtoParticleArray const& first, std::size_t i, FemtoParticleArray const& second, std::size_t jFirst, std::vector<float>& kT) const
+  {
+    const std::size_t n = second.size() > jFirst ? second.size() - jFirst : 0;
+    kT.resize(n);
+    const double px1 = first.px(i);
+    const double py1 = first.py(i);
+    const double* px2 = second.px() + jFirst;
+    const double* py2 = second.py() + jFirst;
+    float* out = kT.data();
+    for (std::size_t j = 0; j < n; j++) {
+      const double sumPx = px1 + px2[j];
+      const double sumPy = py1 + py2[j];
+      out[j] = 0.5 * std::sqrt(sumPx * sumPx + sumPy * sumPy);
+    }
+  }
+
+  float GetEtaDiff(FemtoParticleArray const& first, std::size_t i, FemtoParticleArray const& second, std::size_t j) const { return first.eta(i) - second.eta(j); }
+  float GetPhiStarDiff(FemtoParticleArray const& first, std::size_t i, FemtoParticleArray const& second, std::size_t j) const { return first.phiStar(i) - second.phiStar(j); }
+
+  bool IsClosePair(FemtoParticleArray const& first, std::size_t i, FemtoParticleArray const& second, std::size_t j, const float& deta, const float& dphi) const
+  {
+    return std::pow(std::fabs(GetEtaDiff(first, i, second, j)) / deta, 2) + std::pow(std::fabs(GetPhiStarDiff(first, i, second, j)) / dphi, 2) < 1.0f;
+  }
+  bool IsClosePair(FemtoParticleArray const& first, std::size_t i, FemtoParticleArray const& second, std::size_t j, const float& avgSep) const
+  {
+    return GetAvgSep(first, i, second, j) < avgSep;
+  }
+
+  float GetAvgSep(FemtoParticleArray const& first, std::size_t i, FemtoParticleArray const& second, std::size_t j) const
+  {
+    float dtheta = first.theta(i) - second.theta(j);
+    float res = 0.0;
+
+    for (int r = 0; r < static_cast<int>(FemtoParticleArray::TPCradii.size()); r++) {
+      const float radius = FemtoParticleArray::TPCradii[r];
+      res += sqrt(pow(2.0 * radius * sin(0.5 * (first.phiStar(i, r + 1) - second.phiStar(j, r + 1))), 2) + pow(2.0 * radius * sin(0.5 * dtheta), 2));
+    }
+
+    return 100.0 * res / FemtoParticleArray::TPCradii.size();
+  }
+
+  // k*, q_LCMS (out, side, long), mT and gamma_out of the pair (i, j)
+  struct PairVariables {
+    float kstar;
+    float qOut;
+    float qSide;
+    float qLong;
+    float mT;
+    float gammaOut;
+  };
+
+  PairVariables GetPairVariables(FemtoParticleArray const& first, std::size_t i, FemtoParticleArray const& second, std::size_t j) const
+  {
+    const double sumPx = first.px(i) + second.px(j);
+    const double sumPy = first.py(i) + second.py(j);
+    const double sumPz = first.pz(i) + second.pz(j);
+    const double sumE = first.e(i) + second.e(j);
+    const double difPx = first.px(i) - second.px(j);
+    const double difPy = first.py(i) - second.py(j);
+    const double difPz = first.pz(i) - second.pz(j);
+    const double difE = first.e(i) - second.e(j);
+
+    const double sumPt2 = sumPx * sumPx + sumPy * sumPy;
+    const double sumMt2 = sumE * sumE - sumPz * sumPz;
+    const double sumM2 = sumMt2 - sumPt2;
+    const double difM2 = difE * difE - difPx * difPx - difPy * difPy - difPz * difPz;
+
+    PairVariables res;
+
+    if (_isidentical) {
+      res.kstar = 0.5 * std::sqrt(std::fabs(difM2));
+    } else { // |q| in the pair rest frame: (q*P)^2/P^2 - q^2
+      const double qP = difE * sumE - difPx * sumPx - difPy * sumPy - difPz * sumPz;
+      res.kstar = 0.5 * std::sqrt(std::fabs(qP * qP / sumM2 - difM2));
+    }
+
+    // boost along Z to the LCMS and rotation of the X axis along the pair's kT
+    const double betaZ = sumPz / sumE;
+    const double gammaZ = 1.0 / std::sqrt(1.0 - betaZ * betaZ);
+    const double sumPt = std::sqrt(sumPt2);
+    const double cosPhi = sumPt > 0 ? sumPx / sumPt : 1.0;
+    const double sinPhi = sumPt > 0 ? sumPy / sumPt : 0.0;
+    res.qOut = difPx * cosPhi + difPy * sinPhi;
+    res.qSide = -difPx * sinPhi + difPy * cosPhi;
+    res.qLong = gammaZ * (difPz - betaZ * difE);
+
+    res.mT = 0.5 * std::sqrt(sumMt2);
+    res.gammaOut = std::sqrt(sumMt2 / sumM2);
+
+    return res;
+  }
+
+ private:
+  bool _isidentical = true;
+};
+
+//====================================================================================
+
+// mixing pools: for every vertex&mult bin (see getMixingBin) a ring of fixed depth with the indices of the last events put in there;
+// memory is allocated once, events beyond the depth replace the oldest ones
+class FemtoMixingPool
+{
+ public:
+  void Init(const int& Nbins, const int& depth)
+  {
+    _depth = std::max(depth, 1);
+    _events.assign(static_cast<std::size_t>(Nbins) * _depth, -1);
+    _head.assign(Nbins, 0);
+    _count.assign(Nbins, 0);
+  }
+  void Clear()
+  {
+    std::fill(_head.begin(), _head.end(), 0);
+    std::fill(_count.begin(), _count.end(), 0);
+  }
+
+  int GetNbins() const { return _head.size(); }
+  int GetNevents(const int& bin) const { return _count[bin]; }
+  // k-th event in the bin, from the oldest (k = 0) to the newest one
+  int GetEvent(const int& bin, const int& k) const { return _events[static_cast<std::size_t>(bin) * _depth + (_head[bin] + _depth - _count[bin] + k) % _depth]; }
+
+  void Push(const int& bin, const int& event)
+  {
+    _events[static_cast<std::size_t>(bin) * _depth + _head[bin]] = event;
+    _head[bin] = (_head[bin] + 1) % _depth;
+    if (_count[bin] < _depth)
+      _count[bin]++;
+  }
+
+ private:
+  int _depth = 1;
+  std::vector<int> _events;
+  std::vector<int> _head;
+  std::vector<int> _count;
+};
 } // namespace o2::aod::singletrackselector
 
 #endif // PWGCF_FEMTO3D_CORE_FEMTO3DPAIRTASK_H_
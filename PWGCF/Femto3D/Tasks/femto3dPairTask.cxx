@@ -93,6 +93,7 @@ struct FemtoCorrelations {
   Configurable<int> _vertexNbinsToMix{"vertexNbinsToMix", 10, "Number of vertexZ bins for the mixing"};
   Configurable<std::vector<float>> _centBins{"multBins", std::vector<float>{0.0f, 100.0f}, "multiplicity percentile/centrality binning (min:0, max:100)"};
   Configurable<int> _multNsubBins{"multSubBins", 1, "number of sub-bins to perform the mixing within"};
+  Configurable<int> _mixingDepth{"mixingDepth", 100, "max. number of previous events (within a DF) in the same vertex&mult bin to mix each event with"};
   Configurable<std::vector<float>> _kTbins{"kTbins", std::vector<float>{0.0f, 100.0f}, "pair transverse momentum kT binning"};
   ConfigurableAxis CFkStarBinning{"CFkStarBinning", {500, 0.005, 5.005}, "k* binning of the CF (Nbins, lowlimit, uplimit)"};
 
@@ -120,14 +121,16 @@ struct FemtoCorrelations {
   using FilteredCollisions = soa::Join<aod::SingleCollSels, aod::SingleCollExtras>;
   using FilteredTracks = aod::SingleTrackSels;
 
-  typedef std::shared_ptr<soa::Filtered<FilteredTracks>::iterator> trkType;
-  typedef std::shared_ptr<soa::Filtered<FilteredCollisions>::iterator> colType;
+  using FemtoParticleArray = o2::aod::singletrackselector::FemtoParticleArray;
 
-  std::map<int64_t, std::vector<trkType>> selectedtracks_1;
-  std::map<int64_t, std::vector<trkType>> selectedtracks_2;
-  std::map<std::pair<int, float>, std::vector<colType>> mixbins;
-
-  std::unique_ptr<o2::aod::singletrackselector::FemtoPair<trkType>> Pair = std::make_unique<o2::aod::singletrackselector::FemtoPair<trkType>>();
+  std::vector<FemtoParticleArray> selectedtracks_1; // selected particles per collision (index = collision global index)
+  std::vector<FemtoParticleArray> selectedtracks_2;
+  std::vector<float> magFields;
+  o2::aod::singletrackselector::FemtoMixingPool MixingPool;
+  o2::aod::singletrackselector::FemtoPairKernel Kernel;
+  std::vector<float> kTbuffer;
+  double mass_1 = 0.0, mass_2 = 0.0;
+  std::mt19937 randomGenerator{static_cast<std::mt19937::result_type>(std::chrono::steady_clock::now().time_since_epoch().count())};
 
   Filter pFilter = o2::aod::singletrackselector::p > _min_P&& o2::aod::singletrackselector::p < _max_P;
   Filter etaFilter = nabs(o2::aod::singletrackselector::eta) < _eta;
@@ -165,12 +168,16 @@ struct FemtoCorrelations {
       LOGF(fatal, "The configured number of kT bins in the array is less than 2 !!!");
     if (_vertexNbinsToMix.value < 1)
       LOGF(fatal, "The configured number of VertexZ bins is less than 1 !!!");
+    if (_mixingDepth.value < 1)
+      LOGF(fatal, "The configured mixing depth is less than 1 !!!");
 
     IsIdentical = (_sign_1 * _particlePDG_1 == _sign_2 * _particlePDG_2);
 
-    Pair->SetIdentical(IsIdentical);
-    Pair->SetPDG1(_particlePDG_1);
-    Pair->SetPDG2(_particlePDG_2);
+    Kernel.SetIdentical(IsIdentical);
+    mass_1 = particle_mass(_particlePDG_1);
+    mass_2 = particle_mass(_particlePDG_2);
+
+    MixingPool.Init(_vertexNbinsToMix * (_centBins.value.size() - 1) * std::max(static_cast<int>(_multNsubBins), 1), _mixingDepth);
 
     TPCcuts_1 = std::make_pair(_particlePDG_1, _tpcNSigma_1);
     TOFcuts_1 = std::make_pair(_particlePDG_1, _tofNSigma_1);
@@ -267,67 +274,20 @@ struct FemtoCorrelations {
     }
   }
 
-  template <typename Type>
-  void mixTracks(Type const& tracks, unsigned int multBin)
-  { // template for identical particles from the same collision
+  template <int SE_or_ME>
+  void mixTracks(FemtoParticleArray const& tracks1, FemtoParticleArray const& tracks2, unsigned int multBin, bool isSameArray = false)
+  { // template arg.: 0 -- SE; 1 -- ME; isSameArray: identical particles from the same collision, only the combinations are taken
     if (multBin > SEhistos_1D.size())
       LOGF(fatal, "multBin value passed to the mixTracks function exceeds the configured number of Cent. bins (1D)");
     if (_fill3dCF && multBin > SEhistos_3D.size())
       LOGF(fatal, "multBin value passed to the mixTracks function exceeds the configured number of Cent. bins (3D)");
 
-    for (unsigned int ii = 0; ii < tracks.size(); ii++) { // nested loop for all the combinations
-      for (unsigned int iii = ii + 1; iii < tracks.size(); iii++) {
+    for (unsigned int ii = 0; ii < tracks1.size(); ii++) {
+      unsigned int firstToMix = isSameArray ? ii + 1 : 0;
+      Kernel.GetKt(tracks1, ii, tracks2, firstToMix, kTbuffer); // kT of all the pairs with ii at once
 
-        Pair->SetPair(tracks[ii], tracks[iii]);
-        float pair_kT = Pair->GetKt();
-
-        if (pair_kT < *_kTbins.value.begin() || pair_kT >= *(_kTbins.value.end() - 1))
-          continue;
-
-        unsigned int kTbin = o2::aod::singletrackselector::getBinIndex<unsigned int>(pair_kT, _kTbins);
-        if (kTbin > SEhistos_1D[multBin].size())
-          LOGF(fatal, "kTbin value obtained for a pair exceeds the configured number of kT bins (1D)");
-        if (_fill3dCF && kTbin > SEhistos_3D[multBin].size())
-          LOGF(fatal, "kTbin value obtained for a pair exceeds the configured number of kT bins (3D)");
-
-        if (_fillDetaDphi % 2 == 0)
-          DoubleTrack_SE_histos_BC[multBin][kTbin]->Fill(Pair->GetPhiStarDiff(_radiusTPC), Pair->GetEtaDiff());
-
-        if (_deta > 0 && _dphi > 0 && Pair->IsClosePair(_deta, _dphi, _radiusTPC))
-          continue;
-        if (_avgSepTPC > 0 && Pair->IsClosePair(_avgSepTPC))
-          continue;
-
-        if (_fillDetaDphi > 0)
-          DoubleTrack_SE_histos_AC[multBin][kTbin]->Fill(Pair->GetPhiStarDiff(_radiusTPC), Pair->GetEtaDiff());
-
-        kThistos[multBin][kTbin]->Fill(pair_kT);
-        mThistos[multBin][kTbin]->Fill(Pair->GetMt());       // test
-        SEhistos_1D[multBin][kTbin]->Fill(Pair->GetKstar()); // close pair rejection and fillig the SE histo
-
-        if (_fill3dCF) {
-          std::mt19937 mt(std::chrono::steady_clock::now().time_since_epoch().count());
-          TVector3 qLCMS = std::pow(-1, (mt() % 2)) * Pair->GetQLCMS(); // introducing randomness to the pair order ([first, second]); important only for 3D because if there are any sudden order/correlation in the tables, it could couse unwanted asymmetries in the final 3d rel. momentum distributions; irrelevant in 1D case because the absolute value of the rel.momentum is taken
-          SEhistos_3D[multBin][kTbin]->Fill(qLCMS.X(), qLCMS.Y(), qLCMS.Z());
-        }
-        Pair->ResetPair();
-      }
-    }
-  }
-
-  template <int SE_or_ME, typename Type>
-  void mixTracks(Type const& tracks1, Type const& tracks2, unsigned int multBin)
-  { // last value: 0 -- SE; 1 -- ME
-    if (multBin > SEhistos_1D.size())
-      LOGF(fatal, "multBin value passed to the mixTracks function exceeds the configured number of Cent. bins (1D)");
-    if (_fill3dCF && multBin > SEhistos_3D.size())
-      LOGF(fatal, "multBin value passed to the mixTracks function exceeds the configured number of Cent. bins (3D)");
-
-    for (auto ii : tracks1) {
-      for (auto iii : tracks2) {
-
-        Pair->SetPair(ii, iii);
-        float pair_kT = Pair->GetKt();
+      for (unsigned int iii = firstToMix; iii < tracks2.size(); iii++) {
+        float pair_kT = kTbuffer[iii - firstToMix];
 
         if (pair_kT < *_kTbins.value.begin() || pair_kT >= *(_kTbins.value.end() - 1))
           continue;
@@ -340,47 +300,45 @@ struct FemtoCorrelations {
 
         if (_fillDetaDphi % 2 == 0) {
           if (!SE_or_ME)
-            DoubleTrack_SE_histos_BC[multBin][kTbin]->Fill(Pair->GetPhiStarDiff(_radiusTPC), Pair->GetEtaDiff());
+            DoubleTrack_SE_histos_BC[multBin][kTbin]->Fill(Kernel.GetPhiStarDiff(tracks1, ii, tracks2, iii), Kernel.GetEtaDiff(tracks1, ii, tracks2, iii));
           else
-            DoubleTrack_ME_histos_BC[multBin][kTbin]->Fill(Pair->GetPhiStarDiff(_radiusTPC), Pair->GetEtaDiff());
+            DoubleTrack_ME_histos_BC[multBin][kTbin]->Fill(Kernel.GetPhiStarDiff(tracks1, ii, tracks2, iii), Kernel.GetEtaDiff(tracks1, ii, tracks2, iii));
         }
 
-        if (_deta > 0 && _dphi > 0 && Pair->IsClosePair(_deta, _dphi, _radiusTPC))
+        if (_deta > 0 && _dphi > 0 && Kernel.IsClosePair(tracks1, ii, tracks2, iii, _deta, _dphi))
           continue;
-        if (_avgSepTPC > 0 && Pair->IsClosePair(_avgSepTPC))
+        if (_avgSepTPC > 0 && Kernel.IsClosePair(tracks1, ii, tracks2, iii, _avgSepTPC))
           continue;
 
         if (_fillDetaDphi > 0) {
           if (!SE_or_ME)
-            DoubleTrack_SE_histos_AC[multBin][kTbin]->Fill(Pair->GetPhiStarDiff(_radiusTPC), Pair->GetEtaDiff());
+            DoubleTrack_SE_histos_AC[multBin][kTbin]->Fill(Kernel.GetPhiStarDiff(tracks1, ii, tracks2, iii), Kernel.GetEtaDiff(tracks1, ii, tracks2, iii));
           else
-            DoubleTrack_ME_histos_AC[multBin][kTbin]->Fill(Pair->GetPhiStarDiff(_radiusTPC), Pair->GetEtaDiff());
+            DoubleTrack_ME_histos_AC[multBin][kTbin]->Fill(Kernel.GetPhiStarDiff(tracks1, ii, tracks2, iii), Kernel.GetEtaDiff(tracks1, ii, tracks2, iii));
         }
 
+        auto pair = Kernel.GetPairVariables(tracks1, ii, tracks2, iii);
+        // introducing randomness to the pair order ([first, second]); important only for 3D because if there are any sudden order/correlation in the tables, it could couse unwanted asymmetries in the final 3d rel. momentum distributions; irrelevant in 1D case because the absolute value of the rel.momentum is taken
+        float pairOrder = (_fill3dCF && randomGenerator() % 2) ? -1.f : 1.f;
+
         if (!SE_or_ME) {
-          SEhistos_1D[multBin][kTbin]->Fill(Pair->GetKstar());
+          SEhistos_1D[multBin][kTbin]->Fill(pair.kstar);
           kThistos[multBin][kTbin]->Fill(pair_kT);
-          mThistos[multBin][kTbin]->Fill(Pair->GetMt()); // test
+          mThistos[multBin][kTbin]->Fill(pair.mT); // test
 
-          if (_fill3dCF) {
-            std::mt19937 mt(std::chrono::steady_clock::now().time_since_epoch().count());
-            TVector3 qLCMS = std::pow(-1, (mt() % 2)) * Pair->GetQLCMS(); // introducing randomness to the pair order ([first, second]); important only for 3D because if there are any sudden order/correlation in the tables, it could couse unwanted asymmetries in the final 3d rel. momentum distributions; irrelevant in 1D case because the absolute value of the rel.momentum is taken
-            SEhistos_3D[multBin][kTbin]->Fill(qLCMS.X(), qLCMS.Y(), qLCMS.Z());
-          }
+          if (_fill3dCF)
+            SEhistos_3D[multBin][kTbin]->Fill(pairOrder * pair.qOut, pairOrder * pair.qSide, pairOrder * pair.qLong);
         } else {
-          MEhistos_1D[multBin][kTbin]->Fill(Pair->GetKstar());
+          MEhistos_1D[multBin][kTbin]->Fill(pair.kstar);
 
           if (_fill3dCF) {
-            std::mt19937 mt(std::chrono::steady_clock::now().time_since_epoch().count());
-            TVector3 qLCMS = std::pow(-1, (mt() % 2)) * Pair->GetQLCMS(); // introducing randomness to the pair order ([first, second]); important only for 3D because if there are any sudden order/correlation in the tables, it could couse unwanted asymmetries in the final 3d rel. momentum distributions; irrelevant in 1D case because the absolute value of the rel.momentum is taken
-            MEhistos_3D[multBin][kTbin]->Fill(qLCMS.X(), qLCMS.Y(), qLCMS.Z());
+            MEhistos_3D[multBin][kTbin]->Fill(pairOrder * pair.qOut, pairOrder * pair.qSide, pairOrder * pair.qLong);
             if (_fill3dAddHistos == 1)
-              Add3dHistos[multBin][kTbin]->Fill(qLCMS.X(), qLCMS.Y(), qLCMS.Z(), Pair->GetKstar());
+              Add3dHistos[multBin][kTbin]->Fill(pairOrder * pair.qOut, pairOrder * pair.qSide, pairOrder * pair.qLong, pair.kstar);
             else if (_fill3dAddHistos == 2)
-              Add3dHistos[multBin][kTbin]->Fill(qLCMS.X(), qLCMS.Y(), qLCMS.Z(), Pair->GetGammaOut());
+              Add3dHistos[multBin][kTbin]->Fill(pairOrder * pair.qOut, pairOrder * pair.qSide, pairOrder * pair.qLong, pair.gammaOut);
           }
         }
-        Pair->ResetPair();
       }
     }
   }
@@ -390,6 +348,18 @@ struct FemtoCorrelations {
     if (_particlePDG_1 == 0 || _particlePDG_2 == 0)
       LOGF(fatal, "One of passed PDG is 0!!!");
 
+    // the arrays are indexed by the collision global index and reused from DF to DF (only cleared), so there is no allocation per track
+    const std::size_t Ncollisions = collisions.tableSize();
+    if (selectedtracks_1.size() < Ncollisions) {
+      selectedtracks_1.resize(Ncollisions);
+      selectedtracks_2.resize(Ncollisions);
+      magFields.resize(Ncollisions);
+    }
+    for (std::size_t i = 0; i < Ncollisions; i++) {
+      selectedtracks_1[i].clear();
+      selectedtracks_2[i].clear();
+    }
+
     for (auto track : tracks) {
       if (std::fabs(track.template singleCollSel_as<soa::Filtered<FilteredCollisions>>().posZ()) > _vertexZ)
         continue;
@@ -415,7 +385,7 @@ struct FemtoCorrelations {
         continue;
 
       if (track.sign() == _sign_1 && (track.p() < _PIDtrshld_1 ? o2::aod::singletrackselector::TPCselection(track, TPCcuts_1) : o2::aod::singletrackselector::TOFselection(track, TOFcuts_1, _tpcNSigmaResidual_1.value))) { // filling the map: eventID <-> selected particles1
-        selectedtracks_1[track.singleCollSelId()].push_back(std::make_shared<decltype(track)>(track));
+        selectedtracks_1[track.singleCollSelId()].push_back(track, mass_1, track.template singleCollSel_as<soa::Filtered<FilteredCollisions>>().magField(), _radiusTPC);
 
         registry.fill(HIST("p_first"), track.p());
         if (_particlePDG_1 == 211) {
@@ -439,7 +409,7 @@ struct FemtoCorrelations {
       if (IsIdentical) {
         continue;
       } else if (track.sign() != _sign_2 && !TOFselection(track, std::make_pair(_particlePDGtoReject, _rejectWithinNsigmaTOF)) && (track.p() < _PIDtrshld_2 ? o2::aod::singletrackselector::TPCselection(track, TPCcuts_2) : o2::aod::singletrackselector::TOFselection(track, TOFcuts_2, _tpcNSigmaResidual_2.value))) { // filling the map: eventID <-> selected particles2 if (see condition above ^)
-        selectedtracks_2[track.singleCollSelId()].push_back(std::make_shared<decltype(track)>(track));
+        selectedtracks_2[track.singleCollSelId()].push_back(track, mass_2, track.template singleCollSel_as<soa::Filtered<FilteredCollisions>>().magField(), _radiusTPC);
 
         registry.fill(HIST("p_second"), track.p());
         if (_particlePDG_2 == 211) {
@@ -461,6 +431,10 @@ struct FemtoCorrelations {
       }
     }
 
+    //====================================== mixing starts here ======================================
+
+    MixingPool.Clear(); // the mixing is done within the DF
+
     for (auto collision : collisions) {
       if (collision.multPerc() < *_centBins.value.begin() || collision.multPerc() >= *(_centBins.value.end() - 1))
         continue;
@@ -480,100 +454,42 @@ struct FemtoCorrelations {
       if (_requestNoCollInTimeRangeStandard && !collision.noCollInTimeRangeStandard())
         continue;
 
-      if (selectedtracks_1.find(collision.globalIndex()) == selectedtracks_1.end()) {
+      const int64_t col2 = collision.globalIndex();
+      if (selectedtracks_1[col2].empty()) {
         if (IsIdentical)
           continue;
-        else if (selectedtracks_2.find(collision.globalIndex()) == selectedtracks_2.end())
+        else if (selectedtracks_2[col2].empty())
           continue;
       }
-      int vertexBinToMix = std::floor((collision.posZ() + _vertexZ) / (2 * _vertexZ / _vertexNbinsToMix));
-      float centBinToMix = o2::aod::singletrackselector::getBinIndex<float>(collision.multPerc(), _centBins, _multNsubBins);
-
-      mixbins[std::pair<int, float>{vertexBinToMix, centBinToMix}].push_back(std::make_shared<decltype(collision)>(collision));
-    }
-
-    //====================================== mixing starts here ======================================
 
-    if (IsIdentical) { //====================================== mixing identical ======================================
-
-      for (auto i = mixbins.begin(); i != mixbins.end(); i++) { // iterating over all vertex&mult bins
-        unsigned int EvPerBin = (i->second).size();
-
-        for (unsigned int indx1 = 0; indx1 < EvPerBin; indx1++) { // loop over all the events in each vertex&mult bin
-
-          auto col1 = (i->second)[indx1];
-
-          Pair->SetMagField1(col1->magField());
-          Pair->SetMagField2(col1->magField());
-
-          unsigned int centBin = std::floor((i->first).second);
-          MultHistos[centBin]->Fill(col1->mult());
+      int mixingBin = o2::aod::singletrackselector::getMixingBin(collision.posZ(), _vertexZ, _vertexNbinsToMix, collision.multPerc(), _centBins, _multNsubBins);
+      if (mixingBin < 0)
+        continue;
+      unsigned int centBin = o2::aod::singletrackselector::getMultBinFromMixingBin(mixingBin, _centBins.value.size() - 1, _multNsubBins);
 
-          mixTracks(selectedtracks_1[col1->index()], centBin); // mixing SE identical
+      magFields[col2] = collision.magField();
+      MultHistos[centBin]->Fill(collision.mult());
 
-          for (unsigned int indx2 = indx1 + 1; indx2 < EvPerBin; indx2++) { // nested loop for all the combinations of collisions in a chosen mult/vertex bin
-            if (_MEreductionFactor.value > 1) {
-              std::mt19937 mt(std::chrono::steady_clock::now().time_since_epoch().count());
-              if ((mt() % (_MEreductionFactor.value + 1)) < _MEreductionFactor.value)
-                continue;
-            }
+      const auto& tracks2 = IsIdentical ? selectedtracks_1[col2] : selectedtracks_2[col2];
 
-            auto col2 = (i->second)[indx2];
+      if (magFields[col2] != 0) // pairs are not built without the mag. field (the same as in FemtoPair)
+        mixTracks<0>(selectedtracks_1[col2], tracks2, centBin, IsIdentical); // mixing SE, in <> brackets: 0 -- SE; 1 -- ME
 
-            Pair->SetMagField2(col2->magField());
-            mixTracks<1>(selectedtracks_1[col1->index()], selectedtracks_1[col2->index()], centBin); // mixing ME identical, in <> brackets: 0 -- SE; 1 -- ME
-          }
+      for (int k = 0; k < MixingPool.GetNevents(mixingBin); k++) { // mixing with all the previous events in the pool of the vertex&mult bin
+        if (_MEreductionFactor.value > 1) {
+          if ((randomGenerator() % (_MEreductionFactor.value + 1)) < _MEreductionFactor.value)
+            continue;
         }
-      }
-
-    } else { //====================================== mixing non-identical ======================================
-
-      for (auto i = mixbins.begin(); i != mixbins.end(); i++) { // iterating over all vertex&mult bins
-        unsigned int EvPerBin = (i->second).size();
-
-        for (unsigned int indx1 = 0; indx1 < EvPerBin; indx1++) { // loop over all the events in each vertex&mult bin
-
-          auto col1 = (i->second)[indx1];
-
-          Pair->SetMagField1(col1->magField());
-          Pair->SetMagField2(col1->magField());
-
-          unsigned int centBin = std::floor((i->first).second);
-          MultHistos[centBin]->Fill(col1->mult());
-
-          mixTracks<0>(selectedtracks_1[col1->index()], selectedtracks_2[col1->index()], centBin); // mixing SE non-identical, in <> brackets: 0 -- SE; 1 -- ME
 
-          for (unsigned int indx2 = indx1 + 1; indx2 < EvPerBin; indx2++) { // nested loop for all the combinations of collisions in a chosen mult/vertex bin
-            if (_MEreductionFactor.value > 1) {
-              std::mt19937 mt(std::chrono::steady_clock::now().time_since_epoch().count());
-              if (mt() % (_MEreductionFactor.value + 1) < _MEreductionFactor.value)
-                continue;
-            }
-
-            auto col2 = (i->second)[indx2];
+        const int col1 = MixingPool.GetEvent(mixingBin, k);
+        if (magFields[col1] * magFields[col2] == 0)
+          continue;
 
-            Pair->SetMagField2(col2->magField());
-            mixTracks<1>(selectedtracks_1[col1->index()], selectedtracks_2[col2->index()], centBin); // mixing ME non-identical, in <> brackets: 0 -- SE; 1 -- ME
-          }
-        }
+        mixTracks<1>(selectedtracks_1[col1], tracks2, centBin); // mixing ME, in <> brackets: 0 -- SE; 1 -- ME
       }
 
-    } //====================================== end of mixing non-identical ======================================
-
-    // clearing up
-    for (auto i = selectedtracks_1.begin(); i != selectedtracks_1.end(); i++)
-      (i->second).clear();
-    selectedtracks_1.clear();
-
-    if (!IsIdentical) {
-      for (auto i = selectedtracks_2.begin(); i != selectedtracks_2.end(); i++)
-        (i->second).clear();
-      selectedtracks_2.clear();
+      MixingPool.Push(mixingBin, col2);
     }
-
-    for (auto i = mixbins.begin(); i != mixbins.end(); i++)
-      (i->second).clear();
-    mixbins.clear();
   }
 };
 
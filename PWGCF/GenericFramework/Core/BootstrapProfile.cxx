@@ -51,16 +51,34 @@ void BootstrapProfile::InitializeSubsamples(Int_t nSub)
     reinterpret_cast<TProfile*>(fListOfEntries->At(i))->Reset();
   }
   fNSubs = nSub;
+  fSubProfiles.clear();
+  CacheSubProfiles();
+}
+Bool_t BootstrapProfile::CacheSubProfiles()
+{
+  if (static_cast<Int_t>(fSubProfiles.size()) == fNSubs)
+    return kTRUE;
+  fSubProfiles.clear();
+  if (!fListOfEntries || fListOfEntries->GetEntries() < fNSubs) {
+    printf("No subprofiles exist!\n");
+    return kFALSE;
+  }
+  TIter next(fListOfEntries);
+  for (Int_t i = 0; i < fNSubs; i++)
+    fSubProfiles.push_back(reinterpret_cast<TProfile*>(next()));
+  return kTRUE;
 }
 void BootstrapProfile::FillProfile(const Double_t& xv, const Double_t& yv, const Double_t& w, const Double_t& rn)
 {
   TProfile::Fill(xv, yv, w);
   if (!fNSubs)
     return;
+  if (!CacheSubProfiles())
+    return;
   Int_t targetInd = rn * fNSubs;
   if (targetInd >= fNSubs)
     targetInd = 0;
-  reinterpret_cast<TProfile*>(fListOfEntries->At(targetInd))->Fill(xv, yv, w);
+  fSubProfiles[targetInd]->Fill(xv, yv, w);
 }
 void BootstrapProfile::FillProfile(const Double_t& xv, const Double_t& yv, const Double_t& w)
 {
@@ -75,6 +75,8 @@ void FlowContainer::Initialize(TObjArray* inputList, const o2::framework::AxisSp
       dynamic_cast<TProfile2D*>(fProfRand->At(i))->Sumw2();
     }
   }
+  fProfRandPtr.clear();
+  CacheSubProfiles();
 };
 void FlowContainer::Initialize(TObjArray* inputList, int nMultiBins, double MultiMin, double MultiMax, int nRandom)
 {
@@ -100,6 +102,8 @@ void FlowContainer::Initialize(TObjArray* inputList, int nMultiBins, double Mult
       dynamic_cast<TProfile2D*>(fProfRand->At(i))->Sumw2();
     }
   }
+  fProfRandPtr.clear();
+  CacheSubProfiles();
 };
 bool FlowContainer::CreateBinsFromAxis(TAxis* inax)
 {
@@ -137,18 +141,74 @@ int FlowContainer::FillProfile(const char* hname, double multi, double corr, dou
 {
   if (!fProf)
     return -1;
-  int yin = fProf->GetYaxis()->FindBin(hname);
-  if (!yin) {
+  int yin = GetCorrelatorIndex(hname);
+  if (yin < 0) {
     printf("Could not find bin %s\n", hname);
     return -1;
   }
-  fProf->Fill(multi, yin, corr, w);
+  return FillProfile(yin, multi, corr, w, rn);
+};
+int FlowContainer::GetCorrelatorIndex(const char* hname)
+{
+  if (!fProf)
+    return -1;
+  int yin = fProf->GetYaxis()->FindBin(hname);
+  return (yin > 0 && yin <= fProf->GetNbinsY()) ? yin : -1;
+}
+bool FlowContainer::CacheSubProfiles()
+{
+  if (static_cast<int>(fProfRandPtr.size()) == fNRandom)
+    return kTRUE;
+  fProfRandPtr.clear();
+  if (!fProfRand || fProfRand->GetEntries() < fNRandom) {
+    printf("Subsample profiles do not exist!\n");
+    return kFALSE;
+  }
+  for (int i = 0; i < fNRandom; i++)
+    fProfRandPtr.push_back(dynamic_cast<TProfile2D*>(fProfRand->At(i)));
+  return kTRUE;
+}
+int FlowContainer::FillProfile(int corrIndex, double multi, double corr, double w, double rn)
+{
+  if (!fProf || corrIndex < 1 || corrIndex > fProf->GetNbinsY())
+    return -1;
+  fProf->Fill(multi, corrIndex, corr, w);
   if (fNRandom) {
-    double rnind = rn * fNRandom;
-    dynamic_cast<TProfile2D*>(fProfRand->At(static_cast<int>(rnind)))->Fill(multi, yin, corr, w);
+    if (!CacheSubProfiles())
+      return -1;
+    int rnind = static_cast<int>(rn * fNRandom);
+    if (rnind >= fNRandom)
+      rnind = 0;
+    fProfRandPtr[rnind]->Fill(multi, corrIndex, corr, w);
   }
   return 0;
 };
+int FlowContainer::FillEvent(double multi, std::span<const int> corrIndices, std::span<const double> corr, std::span<const double> w, double rn)
+{
+  // Fills all correlators of one event, returns the number of filled correlators. Indices outside the profile are skipped
+  if (!fProf || corr.size() < corrIndices.size() || w.size() < corrIndices.size())
+    return -1;
+  TProfile2D* subProf = 0;
+  if (fNRandom) {
+    if (!CacheSubProfiles())
+      return -1;
+    int rnind = static_cast<int>(rn * fNRandom);
+    if (rnind >= fNRandom)
+      rnind = 0;
+    subProf = fProfRandPtr[rnind];
+  }
+  int nbinsY = fProf->GetNbinsY();
+  int nFilled = 0;
+  for (size_t i = 0; i < corrIndices.size(); i++) {
+    if (corrIndices[i] < 1 || corrIndices[i] > nbinsY)
+      continue;
+    fProf->Fill(multi, corrIndices[i], corr[i], w[i]);
+    if (subProf)
+      subProf->Fill(multi, corrIndices[i], corr[i], w[i]);
+    nFilled++;
+  }
+  return nFilled;
+}
 void FlowContainer::OverrideProfileErrors(TProfile2D* inpf)
 {
   int nBinsX = fProf->GetNbinsX();
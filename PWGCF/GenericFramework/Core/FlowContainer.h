@@ -11,6 +11,7 @@
 
 #ifndef PWGCF_GENERICFRAMEWORK_CORE_FLOWCONTAINER_H_
 #define PWGCF_GENERICFRAMEWORK_CORE_FLOWCONTAINER_H_
+#include <span>
 #include <vector>
 #include "TH3F.h"
 #include "TProfile2D.h"
@@ -51,6 +52,9 @@ class FlowContainer : public TNamed
   int GetNMultiBins() { return fProf->GetNbinsX(); }
   double GetMultiAtBin(int bin) { return fProf->GetXaxis()->GetBinCenter(bin); }
   int FillProfile(const char* hname, double multi, double y, double w, double rn);
+  int GetCorrelatorIndex(const char* hname); // index to be used in the per-event filling, -1 if the correlator does not exist
+  int FillProfile(int corrIndex, double multi, double y, double w, double rn);
+  int FillEvent(double multi, std::span<const int> corrIndices, std::span<const double> y, std::span<const double> w, double rn);
   TProfile2D* GetProfile() { return fProf; }
   void OverrideProfileErrors(TProfile2D* inpf);
   void ReadAndMerge(const char* infile);
@@ -153,6 +157,8 @@ class FlowContainer : public TNamed
   TProfile2D* fProf;
   TObjArray* fProfRand;
   int fNRandom;
+  std::vector<TProfile2D*> fProfRandPtr; //! do not store; typed view of fProfRand for filling
+  bool CacheSubProfiles();
   TString fIDName;
   int fPtRebin;             //! do not store
   double* fPtRebinEdges;    //! do not store
@@ -276,6 +276,33 @@ void FlowPtContainer::Initialise(int nbinsx, double xlow, double xhigh, const in
   }
   printf("Container %s initialized with m = %i\n", this->GetName(), mpar);
 };
+bool FlowPtContainer::CacheProfiles()
+{
+  // Built on the first fill, so that containers read back from file or merged are filled through the cache as well
+  auto isCached = [](TList* list, const std::vector<BootstrapProfile*>& profiles) {
+    if (!list)
+      return profiles.empty();
+    return static_cast<int>(profiles.size()) == list->GetEntries() && (profiles.empty() || profiles.front() == list->First());
+  };
+  if (isCached(fCorrList, fCorrProfiles) && isCached(fCMTermList, fCMTermProfiles) && isCached(fCovList, fCovProfiles))
+    return kTRUE;
+  if (!fCorrList || !fCMTermList) {
+    printf("Profiles do not exist!\n");
+    return kFALSE;
+  }
+  auto cacheList = [](TList* list, std::vector<BootstrapProfile*>& profiles) {
+    profiles.clear();
+    if (!list)
+      return;
+    TIter next(list);
+    while (TObject* obj = next())
+      profiles.push_back(dynamic_cast<BootstrapProfile*>(obj));
+  };
+  cacheList(fCorrList, fCorrProfiles);
+  cacheList(fCMTermList, fCMTermProfiles);
+  cacheList(fCovList, fCovProfiles);
+  return kTRUE;
+}
 void FlowPtContainer::Fill(const double& w, const double& pt)
 {
   for (size_t i = 0; i < sumP.size(); ++i) {
@@ -312,15 +339,19 @@ void FlowPtContainer::CalculateCorrelations()
 }
 void FlowPtContainer::FillPtProfiles(const double& centmult, const double& rn)
 {
+  if (!CacheProfiles())
+    return;
   for (int m = 1; m <= mpar; ++m) {
     if (corrDen[m] != 0) {
-      dynamic_cast<BootstrapProfile*>(fCorrList->At(m - 1))->FillProfile(centmult, corrNum[m] / corrDen[m], (fEventWeight == kEventWeight::kUnity) ? 1.0 : corrDen[m], rn);
+      fCorrProfiles[m - 1]->FillProfile(centmult, corrNum[m] / corrDen[m], (fEventWeight == kEventWeight::kUnity) ? 1.0 : corrDen[m], rn);
     }
   }
   return;
 }
 void FlowPtContainer::FillVnPtCorrProfiles(const double& centmult, const double& flowval, const double& flowtuples, const double& rn, uint8_t mask)
 {
+  if (!CacheProfiles())
+    return;
   if (!mask) {
     return;
   }
@@ -329,7 +360,7 @@ void FlowPtContainer::FillVnPtCorrProfiles(const double& centmult, const double&
       continue;
     }
     if (corrDen[m] != 0) {
-      dynamic_cast<BootstrapProfile*>(fCovList->At(fillCounter))->FillProfile(centmult, flowval * corrNum[m] / corrDen[m], (fEventWeight == kUnity) ? 1.0 : flowtuples * corrDen[m], rn);
+      fCovProfiles[fillCounter]->FillProfile(centmult, flowval * corrNum[m] / corrDen[m], (fEventWeight == kUnity) ? 1.0 : flowtuples * corrDen[m], rn);
     }
     ++fillCounter;
   }
@@ -337,6 +368,8 @@ void FlowPtContainer::FillVnPtCorrProfiles(const double& centmult, const double&
 }
 void FlowPtContainer::FillVnDeltaPtProfiles(const double& centmult, const double& flowval, const double& flowtuples, const double& rn, uint8_t mask)
 {
+  if (!CacheProfiles())
+    return;
   if (!mask) {
     return;
   }
@@ -345,7 +378,7 @@ void FlowPtContainer::FillVnDeltaPtProfiles(const double& centmult, const double
       continue;
     for (auto i = 0; i <= m; ++i) {
       if (cmDen[m] != 0) {
-        dynamic_cast<BootstrapProfile*>(fCovList->At(fillCounter))->FillProfile(centmult, flowval * ((i == m) ? cmVal[0] : cmVal[m * (m - 1) / 2 + (m - i)]), (fEventWeight == kUnity) ? 1.0 : flowtuples * cmDen[m], rn);
+        fCovProfiles[fillCounter]->FillProfile(centmult, flowval * ((i == m) ? cmVal[0] : cmVal[m * (m - 1) / 2 + (m - i)]), (fEventWeight == kUnity) ? 1.0 : flowtuples * cmDen[m], rn);
       }
       ++fillCounter;
     }
@@ -354,59 +387,65 @@ void FlowPtContainer::FillVnDeltaPtProfiles(const double& centmult, const double
 }
 void FlowPtContainer::FillVnPtCorrStdProfiles(const double& centmult, const double& rn)
 {
+  if (!CacheProfiles())
+    return;
   double wAABBCC = getStdAABBCC(warr);
   if (wAABBCC != 0)
-    dynamic_cast<BootstrapProfile*>(fCovList->At(0))->FillProfile(centmult, getStdAABBCC(arr) / wAABBCC, (fEventWeight == kUnity) ? 1.0 : wAABBCC, rn);
+    fCovProfiles[0]->FillProfile(centmult, getStdAABBCC(arr) / wAABBCC, (fEventWeight == kUnity) ? 1.0 : wAABBCC, rn);
   double wAABBC = getStdAABBC(warr);
   if (wAABBC != 0)
-    dynamic_cast<BootstrapProfile*>(fCovList->At(1))->FillProfile(centmult, getStdAABBCC(arr) / wAABBC, (fEventWeight == kUnity) ? 1.0 : wAABBC, rn);
+    fCovProfiles[1]->FillProfile(centmult, getStdAABBCC(arr) / wAABBC, (fEventWeight == kUnity) ? 1.0 : wAABBC, rn);
   double wABCC = getStdAABBC(warr);
   if (wABCC != 0)
-    dynamic_cast<BootstrapProfile*>(fCovList->At(2))->FillProfile(centmult, getStdABCC(arr) / wABCC, (fEventWeight == kUnity) ? 1.0 : wABCC, rn);
+    fCovProfiles[2]->FillProfile(centmult, getStdABCC(arr) / wABCC, (fEventWeight == kUnity) ? 1.0 : wABCC, rn);
   double wABC = getStdABC(warr);
   if (wABC != 0)
-    dynamic_cast<BootstrapProfile*>(fCovList->At(3))->FillProfile(centmult, getStdABC(arr) / wABC, (fEventWeight == kUnity) ? 1.0 : wABC, rn);
+    fCovProfiles[3]->FillProfile(centmult, getStdABC(arr) / wABC, (fEventWeight == kUnity) ? 1.0 : wABC, rn);
   return;
 }
 void FlowPtContainer::FillVnDeltaPtStdProfiles(const double& centmult, const double& rn)
 {
+  if (!CacheProfiles())
+    return;
   double wAABBCC = getStdAABBCC(warr);
   if (wAABBCC != 0)
-    dynamic_cast<BootstrapProfile*>(fCovList->At(0))->FillProfile(centmult, getStdAABBCC(arr) / wAABBCC, (fEventWeight == kUnity) ? 1.0 : wAABBCC, rn);
+    fCovProfiles[0]->FillProfile(centmult, getStdAABBCC(arr) / wAABBCC, (fEventWeight == kUnity) ? 1.0 : wAABBCC, rn);
   double wAABBCD = getStdAABBCD(warr);
   if (wAABBCD != 0)
-    dynamic_cast<BootstrapProfile*>(fCovList->At(1))->FillProfile(centmult, getStdAABBCD(arr) / wAABBCD, (fEventWeight == kUnity) ? 1.0 : wAABBCD, rn);
+    fCovProfiles[1]->FillProfile(centmult, getStdAABBCD(arr) / wAABBCD, (fEventWeight == kUnity) ? 1.0 : wAABBCD, rn);
   double wAABBDD = getStdAABBDD(warr);
   if (wAABBDD != 0)
-    dynamic_cast<BootstrapProfile*>(fCovList->At(2))->FillProfile(centmult, getStdAABBDD(arr) / wAABBDD, (fEventWeight == kUnity) ? 1.0 : wAABBDD, rn);
+    fCovProfiles[2]->FillProfile(centmult, getStdAABBDD(arr) / wAABBDD, (fEventWeight == kUnity) ? 1.0 : wAABBDD, rn);
 
   double wAABBC = getStdAABBC(warr);
   if (wAABBC != 0)
-    dynamic_cast<BootstrapProfile*>(fCovList->At(3))->FillProfile(centmult, getStdAABBC(arr) / wAABBC, (fEventWeight == kUnity) ? 1.0 : wAABBC, rn);
+    fCovProfiles[3]->FillProfile(centmult, getStdAABBC(arr) / wAABBC, (fEventWeight == kUnity) ? 1.0 : wAABBC, rn);
   double wAABBD = getStdAABBD(warr);
   if (wAABBD != 0)
-    dynamic_cast<BootstrapProfile*>(fCovList->At(4))->FillProfile(centmult, getStdAABBD(arr) / wAABBD, (fEventWeight == kUnity) ? 1.0 : wAABBD, rn);
+    fCovProfiles[4]->FillProfile(centmult, getStdAABBD(arr) / wAABBD, (fEventWeight == kUnity) ? 1.0 : wAABBD, rn);
 
   double wABCC = getStdABCC(warr);
   if (wABCC != 0)
-    dynamic_cast<BootstrapProfile*>(fCovList->At(5))->FillProfile(centmult, getStdABCC(arr) / wABCC, (fEventWeight == kUnity) ? 1.0 : wABCC, rn);
+    fCovProfiles[5]->FillProfile(centmult, getStdABCC(arr) / wABCC, (fEventWeight == kUnity) ? 1.0 : wABCC, rn);
   double wABCD = getStdABCD(warr);
   if (wABCD != 0)
-    dynamic_cast<BootstrapProfile*>(fCovList->At(6))->FillProfile(centmult, getStdABCD(arr) / wABCD, (fEventWeight == kUnity) ? 1.0 : wABCD, rn);
+    fCovProfiles[6]->FillProfile(centmult, getStdABCD(arr) / wABCD, (fEventWeight == kUnity) ? 1.0 : wABCD, rn);
   double wABDD = getStdABDD(warr);
   if (wABDD != 0)
-    dynamic_cast<BootstrapProfile*>(fCovList->At(7))->FillProfile(centmult, getStdABDD(arr) / wABDD, (fEventWeight == kUnity) ? 1.0 : wABDD, rn);
+    fCovProfiles[7]->FillProfile(centmult, getStdABDD(arr) / wABDD, (fEventWeight == kUnity) ? 1.0 : wABDD, rn);
 
   double wABC = getStdABC(warr);
   if (wABC != 0)
-    dynamic_cast<BootstrapProfile*>(fCovList->At(8))->FillProfile(centmult, getStdABC(arr) / wABC, (fEventWeight == kUnity) ? 1.0 : wABC, rn);
+    fCovProfiles[8]->FillProfile(centmult, getStdABC(arr) / wABC, (fEventWeight == kUnity) ? 1.0 : wABC, rn);
   double wABD = getStdABD(warr);
   if (wABD != 0)
-    dynamic_cast<BootstrapProfile*>(fCovList->At(9))->FillProfile(centmult, getStdABD(arr) / wABD, (fEventWeight == kUnity) ? 1.0 : wABD, rn);
+    fCovProfiles[9]->FillProfile(centmult, getStdABD(arr) / wABD, (fEventWeight == kUnity) ? 1.0 : wABD, rn);
   return;
 }
 void FlowPtContainer::FillCMProfiles(const double& centmult, const double& rn)
 {
+  if (!CacheProfiles())
+    return;
   if (sumP[GetVectorIndex(0, 0)] == 0)
     return;
   // 0th order correlation
@@ -420,31 +459,31 @@ void FlowPtContainer::FillCMProfiles(const double& centmult, const double& rn)
   if (mpar < 1 || cmDen[1] == 0)
     return;
   cmVal.push_back(sumP[GetVectorIndex(1, 1)] / cmDen[1]);
-  dynamic_cast<BootstrapProfile*>(fCMTermList->At(0))->FillProfile(centmult, cmVal[1], (fEventWeight == kEventWeight::kUnity) ? 1.0 : cmDen[0], rn);
+  fCMTermProfiles[0]->FillProfile(centmult, cmVal[1], (fEventWeight == kEventWeight::kUnity) ? 1.0 : cmDen[0], rn);
   if (mpar < 2 || sumP[GetVectorIndex(2, 0)] == 0 || cmDen[2] == 0)
     return;
   cmVal.push_back(1 / cmDen[2] * (sumP[GetVectorIndex(1, 1)] * sumP[GetVectorIndex(1, 1)] - sumP[GetVectorIndex(2, 2)]));
-  dynamic_cast<BootstrapProfile*>(fCMTermList->At(1))->FillProfile(centmult, cmVal[2], (fEventWeight == kEventWeight::kUnity) ? 1.0 : cmDen[1], rn);
+  fCMTermProfiles[1]->FillProfile(centmult, cmVal[2], (fEventWeight == kEventWeight::kUnity) ? 1.0 : cmDen[1], rn);
   cmVal.push_back(-2 * 1 / cmDen[2] * (sumP[GetVectorIndex(1, 0)] * sumP[GetVectorIndex(1, 1)] - sumP[GetVectorIndex(2, 1)]));
-  dynamic_cast<BootstrapProfile*>(fCMTermList->At(2))->FillProfile(centmult, cmVal[3], (fEventWeight == kEventWeight::kUnity) ? 1.0 : cmDen[1], rn);
+  fCMTermProfiles[2]->FillProfile(centmult, cmVal[3], (fEventWeight == kEventWeight::kUnity) ? 1.0 : cmDen[1], rn);
   if (mpar < 3 || sumP[GetVectorIndex(3, 0)] == 0 || cmDen[3] == 0)
     return;
   cmVal.push_back(1 / cmDen[3] * (sumP[GetVectorIndex(1, 1)] * sumP[GetVectorIndex(1, 1)] * sumP[GetVectorIndex(1, 1)] - 3 * sumP[GetVectorIndex(2, 2)] * sumP[GetVectorIndex(1, 1)] + 2 * sumP[GetVectorIndex(3, 3)]));
-  dynamic_cast<BootstrapProfile*>(fCMTermList->At(3))->FillProfile(centmult, cmVal[4], (fEventWeight == kEventWeight::kUnity) ? 1.0 : cmDen[2], rn);
+  fCMTermProfiles[3]->FillProfile(centmult, cmVal[4], (fEventWeight == kEventWeight::kUnity) ? 1.0 : cmDen[2], rn);
   cmVal.push_back(-3 * 1 / cmDen[3] * (sumP[GetVectorIndex(1, 1)] * sumP[GetVectorIndex(1, 1)] * sumP[GetVectorIndex(1, 0)] - 2 * sumP[GetVectorIndex(2, 1)] * sumP[GetVectorIndex(1, 1)] + 2 * sumP[GetVectorIndex(3, 2)] - sumP[GetVectorIndex(2, 2)] * sumP[GetVectorIndex(1, 0)]));
-  dynamic_cast<BootstrapProfile*>(fCMTermList->At(4))->FillProfile(centmult, cmVal[5], (fEventWeight == kEventWeight::kUnity) ? 1.0 : cmDen[2], rn);
+  fCMTermProfiles[4]->FillProfile(centmult, cmVal[5], (fEventWeight == kEventWeight::kUnity) ? 1.0 : cmDen[2], rn);
   cmVal.push_back(3 * 1 / cmDen[3] * (sumP[GetVectorIndex(1, 1)] * sumP[GetVectorIndex(1, 0)] * sumP[GetVectorIndex(1, 0)] - 2 * sumP[GetVectorIndex(2, 1)] * sumP[GetVectorIndex(1, 0)] + 2 * sumP[GetVectorIndex(3, 1)] - sumP[GetVectorIndex(1, 1)] * sumP[GetVectorIndex(2, 0)]));
-  dynamic_cast<BootstrapProfile*>(fCMTermList->At(5))->FillProfile(centmult, cmVal[6], (fEventWeight == kEventWeight::kUnity) ? 1.0 : cmDen[2], rn);
+  fCMTermProfiles[5]->FillProfile(centmult, cmVal[6], (fEventWeight == kEventWeight::kUnity) ? 1.0 : cmDen[2], rn);
   if (mpar < 4 || sumP[GetVectorIndex(4, 0)] == 0 || cmDen[4] == 0)
     return;
   cmVal.push_back(1 / cmDen[4] * (sumP[GetVectorIndex(1, 1)] * sumP[GetVectorIndex(1, 1)] * sumP[GetVectorIndex(1, 1)] * sumP[GetVectorIndex(1, 1)] - 6 * sumP[GetVectorIndex(2, 2)] * sumP[GetVectorIndex(1, 1)] * sumP[GetVectorIndex(1, 1)] + 3 * sumP[GetVectorIndex(2, 2)] * sumP[GetVectorIndex(2, 2)] + 8 * sumP[GetVectorIndex(3, 3)] * sumP[GetVectorIndex(1, 1)] - 6 * sumP[GetVectorIndex(4, 4)]));
-  dynamic_cast<BootstrapProfile*>(fCMTermList->At(6))->FillProfile(centmult, cmVal[7], (fEventWeight == kEventWeight::kUnity) ? 1.0 : cmDen[3], rn);
+  fCMTermProfiles[6]->FillProfile(centmult, cmVal[7], (fEventWeight == kEventWeight::kUnity) ? 1.0 : cmDen[3], rn);
   cmVal.push_back(-4 * 1 / cmDen[4] * (sumP[GetVectorIndex(1, 1)] * sumP[GetVectorIndex(1, 1)] * sumP[GetVectorIndex(1, 1)] * sumP[GetVectorIndex(1, 0)] - 3 * sumP[GetVectorIndex(2, 2)] * sumP[GetVectorIndex(1, 1)] * sumP[GetVectorIndex(1, 0)] - 3 * sumP[GetVectorIndex(1, 1)] * sumP[GetVectorIndex(1, 1)] * sumP[GetVectorIndex(2, 1)] + 3 * sumP[GetVectorIndex(2, 2)] * sumP[GetVectorIndex(2, 1)] + 6 * sumP[GetVectorIndex(1, 1)] * sumP[GetVectorIndex(3, 2)] - 6 * sumP[GetVectorIndex(4, 3)]));
-  dynamic_cast<BootstrapProfile*>(fCMTermList->At(7))->FillProfile(centmult, cmVal[8], (fEventWeight == kEventWeight::kUnity) ? 1.0 : cmDen[3], rn);
+  fCMTermProfiles[7]->FillProfile(centmult, cmVal[8], (fEventWeight == kEventWeight::kUnity) ? 1.0 : cmDen[3], rn);
   cmVal.push_back(6 * 1 / cmDen[4] * (sumP[GetVectorIndex(1, 1)] * sumP[GetVectorIndex(1, 1)] * sumP[GetVectorIndex(1, 0)] * sumP[GetVectorIndex(1, 0)] - sumP[GetVectorIndex(2, 2)] * sumP[GetVectorIndex(1, 0)] * sumP[GetVectorIndex(1, 0)] - sumP[GetVectorIndex(2, 0)] * sumP[GetVectorIndex(1, 1)] * sumP[GetVectorIndex(1, 1)] + sumP[GetVectorIndex(2, 0)] * sumP[GetVectorIndex(2, 2)] - 4 * sumP[GetVectorIndex(2, 1)] * sumP[GetVectorIndex(1, 1)] * sumP[GetVectorIndex(1, 0)] + 4 * sumP[GetVectorIndex(3, 2)] * sumP[GetVectorIndex(1, 0)] + 4 * sumP[GetVectorIndex(3, 1)] * sumP[GetVectorIndex(1, 1)] + 2 * sumP[GetVectorIndex(2, 1)] * sumP[GetVectorIndex(2, 1)] - 6 * sumP[GetVectorIndex(4, 2)]));
-  dynamic_cast<BootstrapProfile*>(fCMTermList->At(8))->FillProfile(centmult, cmVal[9], (fEventWeight == kEventWeight::kUnity) ? 1.0 : cmDen[3], rn);
+  fCMTermProfiles[8]->FillProfile(centmult, cmVal[9], (fEventWeight == kEventWeight::kUnity) ? 1.0 : cmDen[3], rn);
   cmVal.push_back(-4 * 1 / cmDen[4] * (sumP[GetVectorIndex(1, 1)] * sumP[GetVectorIndex(1, 0)] * sumP[GetVectorIndex(1, 0)] * sumP[GetVectorIndex(1, 0)] - 3 * sumP[GetVectorIndex(2, 1)] * sumP[GetVectorIndex(1, 0)] * sumP[GetVectorIndex(1, 0)] - 3 * sumP[GetVectorIndex(1, 1)] * sumP[GetVectorIndex(2, 0)] * sumP[GetVectorIndex(1, 0)] + 3 * sumP[GetVectorIndex(2, 1)] * sumP[GetVectorIndex(2, 0)] + 2 * sumP[GetVectorIndex(1, 1)] * sumP[GetVectorIndex(3, 0)] + 6 * sumP[GetVectorIndex(3, 1)] * sumP[GetVectorIndex(1, 0)] - 6 * sumP[GetVectorIndex(4, 1)]));
-  dynamic_cast<BootstrapProfile*>(fCMTermList->At(9))->FillProfile(centmult, cmVal[10], (fEventWeight == kEventWeight::kUnity) ? 1.0 : cmDen[3], rn);
+  fCMTermProfiles[9]->FillProfile(centmult, cmVal[10], (fEventWeight == kEventWeight::kUnity) ? 1.0 : cmDen[3], rn);
   return;
 }
 void FlowPtContainer::FillArray(FillType a, FillType b, double c, double d)
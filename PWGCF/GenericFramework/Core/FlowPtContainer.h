@@ -112,14 +112,18 @@ class FlowPtContainer : public TNamed
   bool fUseCentralMoments;
   bool fUseGap;
   void MergeBSLists(TList* source, TList* target);
+  bool CacheProfiles();
   TH1* raiseHistToPower(TH1* inh, double p);
-  std::vector<double> sumP;             //!
-  std::vector<double> corrNum;          //!
-  std::vector<double> corrDen;          //!
-  std::vector<double> cmVal;            //!
-  std::vector<double> cmDen;            //!
-  std::complex<double> arr[3][3][3][3]; //!
-  double warr[3][3][3][3];              //!
+  std::vector<double> sumP;                       //!
+  std::vector<double> corrNum;                    //!
+  std::vector<double> corrDen;                    //!
+  std::vector<double> cmVal;                      //!
+  std::vector<double> cmDen;                      //!
+  std::complex<double> arr[3][3][3][3];           //!
+  double warr[3][3][3][3];                        //!
+  std::vector<BootstrapProfile*> fCorrProfiles;   //! profiles of fCorrList, indexed for filling
+  std::vector<BootstrapProfile*> fCMTermProfiles; //! profiles of fCMTermList, indexed for filling
+  std::vector<BootstrapProfile*> fCovProfiles;    //! profiles of fCovList, indexed for filling
   template <typename T>
   double getStdAABBCC(T& inarr);
   template <typename T>
@@ -24,7 +24,7 @@ using std::pair;
 using std::string;
 using std::vector;
 
-GFW::GFW() : fInitialized(false) {}
+GFW::GFW() : fInitialized(false), fMaxHarmonics(0) {}
 
 GFW::~GFW()
 {
@@ -88,12 +88,15 @@ int GFW::CreateRegions()
     return 0;
   }
   int nRegions = 0;
+  fMaxHarmonics = 0;
   for (auto pItr = fRegions.begin(); pItr != fRegions.end(); pItr++) {
-    GFWCumulant* lCumulant = new GFWCumulant();
-    lCumulant->CreateComplexVectorArrayVarPower(pItr->Nhar, pItr->NparVec, pItr->NpT);
-    fCumulants.push_back(*lCumulant);
+    fCumulants.emplace_back();
+    fCumulants.back().CreateComplexVectorArrayVarPower(pItr->Nhar, pItr->NparVec, pItr->NpT);
+    fMaxHarmonics = std::max(fMaxHarmonics, pItr->Nhar);
     ++nRegions;
   }
+  fCos.resize(fMaxHarmonics);
+  fSin.resize(fMaxHarmonics);
   if (nRegions)
     fInitialized = true;
   return nRegions;
@@ -101,11 +104,23 @@ int GFW::CreateRegions()
 void GFW::Fill(double eta, int ptin, double phi, double weight, int mask, double SecondWeight)
 {
   // if(!fInitialized) return;
+  bool lHarmonicsCalculated = false; // cos(n*phi), sin(n*phi) are shared by all regions the particle falls into
   for (int i = 0; i < static_cast<int>(fRegions.size()); ++i) {
-    if (fRegions.at(i).EtaMin < eta && fRegions.at(i).EtaMax > eta && (fRegions.at(i).BitMask & mask))
-      fCumulants.at(i).FillArray(ptin, phi, weight, SecondWeight);
+    if (fRegions.at(i).EtaMin < eta && fRegions.at(i).EtaMax > eta && (fRegions.at(i).BitMask & mask)) {
+      if (!lHarmonicsCalculated) {
+        GFWCumulant::CalculateHarmonics(phi, fMaxHarmonics, fCos.data(), fSin.data());
+        lHarmonicsCalculated = true;
+      }
+      fCumulants.at(i).FillArray(ptin, fCos.data(), fSin.data(), weight, SecondWeight);
+    }
   }
 };
+void GFW::Fill(std::span<const double> eta, std::span<const int> ptin, std::span<const double> phi, std::span<const double> weight, int mask, std::span<const double> secondWeight)
+{
+  const bool lHasSecondWeight = !secondWeight.empty();
+  for (std::size_t i = 0; i < phi.size(); ++i)
+    Fill(eta[i], ptin[i], phi[i], weight[i], mask, lHasSecondWeight ? secondWeight[i] : -1);
+};
 complex<double> GFW::TwoRec(int n1, int n2, int p1, int p2, int ptbin, GFWCumulant* r1, GFWCumulant* r2, GFWCumulant* r3)
 {
   complex<double> part1 = r1->Vec(n1, p1, ptbin);
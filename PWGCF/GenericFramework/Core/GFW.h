@@ -26,6 +26,7 @@ If used, modified, or distributed, please aknowledge the author of this code.
 #include <utility>
 #include <algorithm>
 #include <complex>
+#include <span>
 
 class GFW
 {
@@ -62,6 +63,7 @@ class GFW
   void AddRegion(std::string refName, int lNhar, int* lNparVec, double lEtaMin, double lEtaMax, int lNpT, int BitMask);  // Legacy support, array instead of a vector
   int CreateRegions();
   void Fill(double eta, int ptin, double phi, double weight, int mask, double secondWeight = -1);
+  void Fill(std::span<const double> eta, std::span<const int> ptin, std::span<const double> phi, std::span<const double> weight, int mask, std::span<const double> secondWeight = {}); // Batch fill, same as calling Fill for each particle
   void Clear();
   GFWCumulant GetCumulant(int index) { return fCumulants.at(index); }
   CorrConfig GetCorrelatorConfig(std::string config, std::string head = "", bool ptdif = false);
@@ -70,6 +72,9 @@ class GFW
 
  protected:
   bool fInitialized;
+  int fMaxHarmonics;        //! Max. number of harmonics over all regions
+  std::vector<double> fCos; //! cos(n*phi) of the particle being filled
+  std::vector<double> fSin; //! sin(n*phi) of the particle being filled
   std::vector<CorrConfig> fListOfCFGs;
   std::complex<double> TwoRec(int n1, int n2, int p1, int p2, int ptbin, GFWCumulant*, GFWCumulant*, GFWCumulant*);
   std::complex<double> RecursiveCorr(GFWCumulant* qpoi, GFWCumulant* qref, GFWCumulant* qol, int ptbin, std::vector<int>& hars, std::vector<int>& pows); // POI, Ref. flow, overlapping region
@@ -19,20 +19,46 @@ If used, modified, or distributed, please aknowledge the author of this code.
 
 #include "GFWCumulant.h"
 
+#include <algorithm>
+
 using std::complex;
 using std::vector;
 
-GFWCumulant::GFWCumulant() : fQvector(0),
+GFWCumulant::GFWCumulant() : fNQ(0),
                              fUsed(kBlank),
                              fNEntries(-1),
                              fN(1),
                              fPow(1),
                              fPt(1),
-                             fFilledPts(0),
                              fInitialized(false) {}
 
 GFWCumulant::~GFWCumulant() {}
+void GFWCumulant::CalculateHarmonics(double phi, int nHarmonics, double* lCos, double* lSin)
+{
+  if (nHarmonics < 1)
+    return;
+  lCos[0] = 1;
+  lSin[0] = 0;
+  if (nHarmonics < 2)
+    return;
+  // exp(i*n*phi) = exp(i*(n-1)*phi) * exp(i*phi), so only one sin/cos per particle is needed
+  double lCos1 = cos(phi);
+  double lSin1 = sin(phi);
+  lCos[1] = lCos1;
+  lSin[1] = lSin1;
+  for (int lN = 2; lN < nHarmonics; lN++) {
+    lCos[lN] = lCos[lN - 1] * lCos1 - lSin[lN - 1] * lSin1;
+    lSin[lN] = lSin[lN - 1] * lCos1 + lCos[lN - 1] * lSin1;
+  }
+};
 void GFWCumulant::FillArray(int ptin, double phi, double weight, double SecondWeight)
+{
+  if (!fInitialized)
+    CreateComplexVectorArray(1, 1, 1);
+  CalculateHarmonics(phi, fN, fCos.data(), fSin.data());
+  FillArray(ptin, fCos.data(), fSin.data(), weight, SecondWeight);
+};
+void GFWCumulant::FillArray(int ptin, const double* lCos, const double* lSin, double weight, double SecondWeight)
 {
   if (!fInitialized)
     CreateComplexVectorArray(1, 1, 1);
@@ -41,53 +67,60 @@ void GFWCumulant::FillArray(int ptin, double phi, double weight, double SecondWe
   else if (ptin < 0 || ptin >= fPt)
     return;
   fFilledPts[ptin] = true;
+  // Dont calculate it for every harmonic; multiplication is cheaper that power
+  // Also, if second weight is specified, then keep the first weight with power no more than 1, and us the other weight otherwise
+  // this is important when POIs are a subset of REFs and have different weights than REFs
+  const int lMaxPow = static_cast<int>(fPrefactors.size());
+  if (lMaxPow > 0)
+    fPrefactors[0] = 1;
+  if (lMaxPow > 1)
+    fPrefactors[1] = weight;
+  const double lHigherWeight = (SecondWeight > 0) ? SecondWeight : weight;
+  for (int lPow = 2; lPow < lMaxPow; lPow++)
+    fPrefactors[lPow] = fPrefactors[lPow - 1] * lHigherWeight;
+  double* lQRe = fQRe.data() + ptin * fNQ;
+  double* lQIm = fQIm.data() + ptin * fNQ;
   for (int lN = 0; lN < fN; lN++) {
-    double lSin = sin(lN * phi); // No need to recalculate for each power
-    double lCos = cos(lN * phi); // No need to recalculate for each power
-    for (int lPow = 0; lPow < PW(lN); lPow++) {
-      double lPrefactor = 0;
-      // Dont calculate it twice; multiplication is cheaper that power
-      // Also, if second weight is specified, then keep the first weight with power no more than 1, and us the other weight otherwise
-      // this is important when POIs are a subset of REFs and have different weights than REFs
-      if (SecondWeight > 0 && lPow > 1)
-        lPrefactor = pow(SecondWeight, lPow - 1) * weight;
-      else
-        lPrefactor = pow(weight, lPow);
-      double qsin = lPrefactor * lSin;
-      double qcos = lPrefactor * lCos;
-      fQvector[ptin][lN][lPow] += complex<double>(qcos, qsin);
+    const int lOffset = fHarOffset[lN];
+    const int lNPow = fPowVec[lN];
+    for (int lPow = 0; lPow < lNPow; lPow++) {
+      lQRe[lOffset + lPow] += fPrefactors[lPow] * lCos[lN];
+      lQIm[lOffset + lPow] += fPrefactors[lPow] * lSin[lN];
     }
   }
   Inc();
 };
+void GFWCumulant::FillArray(std::span<const int> ptin, std::span<const double> phi, std::span<const double> weight, std::span<const double> SecondWeight)
+{
+  if (!fInitialized)
+    CreateComplexVectorArray(1, 1, 1);
+  const bool lHasSecondWeight = !SecondWeight.empty();
+  for (std::size_t i = 0; i < phi.size(); i++) {
+    CalculateHarmonics(phi[i], fN, fCos.data(), fSin.data());
+    FillArray(ptin[i], fCos.data(), fSin.data(), weight[i], lHasSecondWeight ? SecondWeight[i] : -1);
+  }
+};
 void GFWCumulant::ResetQs()
 {
   if (!fNEntries)
     return; // If 0 entries, then no need to reset. Otherwise, if -1, then just initialized and need to set to 0.
-  for (int i = 0; i < fPt; i++) {
-    fFilledPts[i] = false;
-    for (int lN = 0; lN < fN; lN++) {
-      for (int lPow = 0; lPow < PW(lN); lPow++) {
-        fQvector[i][lN][lPow] = fNullQ;
-      }
-    }
-  }
+  std::fill(fFilledPts.begin(), fFilledPts.end(), false);
+  std::fill(fQRe.begin(), fQRe.end(), 0.);
+  std::fill(fQIm.begin(), fQIm.end(), 0.);
   fNEntries = 0;
 };
 void GFWCumulant::DestroyComplexVectorArray()
 {
   if (!fInitialized)
     return;
-  for (int l_n = 0; l_n < fN; l_n++) {
-    for (int i = 0; i < fPt; i++) {
-      delete[] fQvector[i][l_n];
-    }
-  }
-  for (int i = 0; i < fPt; i++) {
-    delete[] fQvector[i];
-  }
-  delete[] fQvector;
-  delete[] fFilledPts;
+  fQRe.clear();
+  fQIm.clear();
+  fHarOffset.clear();
+  fFilledPts.clear();
+  fCos.clear();
+  fSin.clear();
+  fPrefactors.clear();
+  fNQ = 0;
   fInitialized = false;
   fNEntries = -1;
 };
@@ -106,17 +139,21 @@ void GFWCumulant::CreateComplexVectorArrayVarPower(int N, vector<int> PowVec, in
   fN = N;
   fPow = 0;
   fPt = Pt;
-  fFilledPts = new bool[Pt];
   fPowVec = PowVec;
-  fQvector = new complex<double>**[fPt];
-  for (int i = 0; i < fPt; i++) {
-    fQvector[i] = new complex<double>*[fN];
-  }
+  fHarOffset.resize(fN);
+  fNQ = 0;
+  int lMaxPow = 0;
   for (int l_n = 0; l_n < fN; l_n++) {
-    for (int i = 0; i < fPt; i++) {
-      fQvector[i][l_n] = new complex<double>[PW(l_n)];
-    }
+    fHarOffset[l_n] = fNQ;
+    fNQ += PW(l_n);
+    lMaxPow = std::max(lMaxPow, PW(l_n));
   }
+  fQRe.assign(fPt * fNQ, 0.);
+  fQIm.assign(fPt * fNQ, 0.);
+  fFilledPts.assign(fPt, false);
+  fCos.resize(fN);
+  fSin.resize(fN);
+  fPrefactors.resize(lMaxPow);
   ResetQs();
   fInitialized = true;
 };
@@ -126,13 +163,16 @@ complex<double> GFWCumulant::Vec(int n, int p, int ptbin)
     return 0;
   if (ptbin >= fPt || ptbin < 0)
     ptbin = 0;
-  if (n >= 0)
-    return fQvector[ptbin][n][p];
-  return conj(fQvector[ptbin][-n][p]);
+  if (n >= 0) {
+    const int lIndex = ptbin * fNQ + fHarOffset[n] + p;
+    return complex<double>(fQRe[lIndex], fQIm[lIndex]);
+  }
+  const int lIndex = ptbin * fNQ + fHarOffset[-n] + p;
+  return complex<double>(fQRe[lIndex], -fQIm[lIndex]);
 };
 bool GFWCumulant::IsPtBinFilled(int ptb)
 {
-  if (!fFilledPts)
+  if (fFilledPts.empty())
     return false;
   if (ptb > 0) {
     if (fPt == 1)
@@ -21,6 +21,7 @@ If used, modified, or distributed, please aknowledge the author of this code.
 
 #include <cmath>
 #include <complex>
+#include <span>
 #include <vector>
 
 class GFWCumulant
@@ -30,6 +31,9 @@ class GFWCumulant
   ~GFWCumulant();
   void ResetQs();
   void FillArray(int ptin, double phi, double weight = 1, double SecondWeight = -1);
+  void FillArray(int ptin, const double* lCos, const double* lSin, double weight = 1, double SecondWeight = -1); // with precomputed cos(n*phi), sin(n*phi) for n < GetNHarmonics()
+  void FillArray(std::span<const int> ptin, std::span<const double> phi, std::span<const double> weight, std::span<const double> SecondWeight = {});
+  static void CalculateHarmonics(double phi, int nHarmonics, double* lCos, double* lSin); // cos(n*phi), sin(n*phi) for n < nHarmonics from a single sin/cos
   enum UsedFlags_t { kBlank = 0,
                      kFull = 1,
                      kPt = 2 };
@@ -40,6 +44,7 @@ class GFWCumulant
   };
   void Inc() { fNEntries++; }
   int GetN() { return fNEntries; }
+  int GetNHarmonics() const { return fN; }
   bool IsPtBinFilled(int ptb);
   void CreateComplexVectorArray(int N = 1, int P = 1, int Pt = 1);
   void CreateComplexVectorArrayVarPower(int N = 1, std::vector<int> Pvec = {1}, int Pt = 1);
@@ -47,7 +52,11 @@ class GFWCumulant
   void DestroyComplexVectorArray();
   std::complex<double> Vec(int, int, int ptbin = 0); // envelope class to summarize pt-dif. Q-vec getter
  protected:
-  std::complex<double>*** fQvector;
+  // Q-vectors are stored in flat arrays of real and imaginary parts, indexed by ptbin * fNQ + fHarOffset[n] + p
+  std::vector<double> fQRe;    //!
+  std::vector<double> fQIm;    //!
+  std::vector<int> fHarOffset; //! Offset of each harmonic within a pT bin
+  int fNQ;                     //! Number of (harmonic, power) pairs per pT bin
   uint fUsed;
   int fNEntries;
   // Q-vectors. Could be done recursively, but maybe defining each one of them explicitly is easier to read
@@ -55,9 +64,11 @@ class GFWCumulant
   int fPow;                 //! Power
   std::vector<int> fPowVec; //! Powers array
   int fPt;                  //! fPt bins
-  bool* fFilledPts;
+  std::vector<bool> fFilledPts;
   bool fInitialized; // Arrays are initialized
-  std::complex<double> fNullQ = 0;
+  std::vector<double> fCos;        //! cos(n*phi) of the particle being filled
+  std::vector<double> fSin;        //! sin(n*phi) of the particle being filled
+  std::vector<double> fPrefactors; //! weight^power of the particle being filled
 };
 
 #endif // PWGCF_GENERICFRAMEWORK_CORE_GFWCUMULANT_H_
@@ -141,29 +141,68 @@ double GFWWeights::GetWeight(double phi, double eta, double vz, double pt, doubl
     return 1. / weight;
   return 1;
 };
-double GFWWeights::GetNUA(double phi, double eta, double vz)
+void GFWWeightMap::Build(const TH3* h)
+{
+  const TAxis* axes[3] = {h->GetXaxis(), h->GetYaxis(), h->GetZaxis()};
+  for (int i = 0; i < 3; i++) {
+    Axis& axis = fAxes[i];
+    axis.nBins = axes[i]->GetNbins();
+    axis.min = axes[i]->GetXmin();
+    axis.max = axes[i]->GetXmax();
+    axis.uniform = !axes[i]->IsVariableBinSize();
+    if (axis.uniform)
+      axis.edges.clear();
+    else
+      axis.edges.assign(axes[i]->GetXbins()->GetArray(), axes[i]->GetXbins()->GetArray() + axis.nBins + 1);
+    fSize[i] = axis.nBins + 2;
+  }
+  fValues.resize(h->GetNcells());
+  for (int bin = 0; bin < h->GetNcells(); bin++) {
+    double weight = h->GetBinContent(bin);
+    fValues[bin] = (weight != 0) ? 1. / weight : 1;
+  }
+}
+void GFWWeightMap::Get(std::span<const double> x, std::span<const double> y, double z, std::span<double> weights) const
+{
+  const double* values = fValues.data() + fSize[0] * fSize[1] * FindBin(fAxes[2], z);
+  for (size_t i = 0; i < weights.size(); i++)
+    weights[i] = values[FindBin(fAxes[0], x[i]) + fSize[0] * FindBin(fAxes[1], y[i])];
+}
+void GFWWeights::BuildFlatNUA()
 {
   if (!fAccInt)
     CreateNUA();
-  int xind = fAccInt->GetXaxis()->FindBin(phi);
-  int etaind = fAccInt->GetYaxis()->FindBin(eta);
-  int vzind = fAccInt->GetZaxis()->FindBin(vz);
-  double weight = fAccInt->GetBinContent(xind, etaind, vzind);
-  if (weight != 0)
-    return 1. / weight;
-  return 1;
+  fAccFlat.Build(fAccInt);
 }
-double GFWWeights::GetNUE(double pt, double eta, double vz)
+void GFWWeights::BuildFlatNUE()
 {
   if (!fEffInt)
     CreateNUE();
-  int xind = fEffInt->GetXaxis()->FindBin(pt);
-  int etaind = fEffInt->GetYaxis()->FindBin(eta);
-  int vzind = fEffInt->GetZaxis()->FindBin(vz);
-  double weight = fEffInt->GetBinContent(xind, etaind, vzind);
-  if (weight != 0)
-    return 1. / weight;
-  return 1;
+  fEffFlat.Build(fEffInt);
+}
+double GFWWeights::GetNUA(double phi, double eta, double vz)
+{
+  if (!fAccFlat.IsBuilt())
+    BuildFlatNUA();
+  return fAccFlat.Get(phi, eta, vz);
+}
+double GFWWeights::GetNUE(double pt, double eta, double vz)
+{
+  if (!fEffFlat.IsBuilt())
+    BuildFlatNUE();
+  return fEffFlat.Get(pt, eta, vz);
+}
+void GFWWeights::GetNUA(std::span<const double> phi, std::span<const double> eta, double vz, std::span<double> weights)
+{
+  if (!fAccFlat.IsBuilt())
+    BuildFlatNUA();
+  fAccFlat.Get(phi, eta, vz, weights);
+}
+void GFWWeights::GetNUE(std::span<const double> pt, std::span<const double> eta, double vz, std::span<double> weights)
+{
+  if (!fEffFlat.IsBuilt())
+    BuildFlatNUE();
+  fEffFlat.Get(pt, eta, vz, weights);
 }
 double GFWWeights::FindMax(TH3D* inh, int& ix, int& iy, int& iz)
 {
@@ -216,6 +255,7 @@ void GFWWeights::CreateNUA(bool IntegrateOverCentAndPt)
   if (IntegrateOverCentAndPt) {
     if (fAccInt)
       delete fAccInt;
+    fAccFlat.Reset();
     fAccInt = reinterpret_cast<TH3D*>(fW_data->At(0)->Clone("IntegratedAcceptance"));
     fAccInt->Sumw2();
     for (int etai = 1; etai <= fAccInt->GetNbinsY(); etai++) {
@@ -276,6 +316,7 @@ void GFWWeights::CreateNUE(bool IntegrateOverCentrality)
     den->RebinY(2);
     num->RebinZ(5);
     den->RebinZ(5);
+    fEffFlat.Reset();
     fEffInt = reinterpret_cast<TH3D*>(num->Clone("Efficiency_Integrated"));
     fEffInt->Divide(den);
     return;
@@ -362,6 +403,7 @@ void GFWWeights::OverwriteNUA()
   delete trash;
   fW_data->Add(reinterpret_cast<TH3D*>(fAccInt->Clone(ts.Data())));
   delete fAccInt;
+  fAccFlat.Reset();
 }
 Long64_t GFWWeights::Merge(TCollection* collist)
 {
@@ -11,6 +11,9 @@
 
 #ifndef PWGCF_GENERICFRAMEWORK_CORE_GFWWEIGHTS_H_
 #define PWGCF_GENERICFRAMEWORK_CORE_GFWWEIGHTS_H_
+#include <algorithm>
+#include <span>
+#include <vector>
 #include "TObjArray.h"
 #include "TNamed.h"
 #include "TH3D.h"
@@ -20,6 +23,40 @@
 #include "TCollection.h"
 #include "TString.h"
 
+// Flat copy of a weight map (TH3) with the inverse weights precomputed (1 for empty bins), including under- and overflow.
+// Bins are found as in TAxis::FindBin, so the weights are identical to 1/TH3::GetBinContent.
+class GFWWeightMap
+{
+ public:
+  void Build(const TH3* h);
+  void Reset() { fValues.clear(); }
+  bool IsBuilt() const { return !fValues.empty(); }
+  double Get(double x, double y, double z) const { return fValues[FindBin(fAxes[0], x) + fSize[0] * (FindBin(fAxes[1], y) + fSize[1] * FindBin(fAxes[2], z))]; }
+  void Get(std::span<const double> x, std::span<const double> y, double z, std::span<double> weights) const;
+
+ private:
+  struct Axis {
+    bool uniform = true;
+    int nBins = 0;
+    double min = 0;
+    double max = 0;
+    std::vector<double> edges; // only for variable bin size
+  };
+  static int FindBin(const Axis& axis, double x)
+  {
+    if (x < axis.min)
+      return 0;
+    if (!(x < axis.max))
+      return axis.nBins + 1;
+    if (axis.uniform)
+      return 1 + static_cast<int>(axis.nBins * (x - axis.min) / (axis.max - axis.min));
+    return std::upper_bound(axis.edges.begin(), axis.edges.end(), x) - axis.edges.begin();
+  }
+  Axis fAxes[3];
+  int fSize[3] = {0, 0, 0};    // bins per axis including under- and overflow
+  std::vector<double> fValues; // inverse weights, global bin as in TH3
+};
+
 class GFWWeights : public TNamed
 {
  public:
@@ -31,6 +68,9 @@ class GFWWeights : public TNamed
   double GetWeight(double phi, double eta, double vz, double pt, double cent, int htype);             // htype: 0 for data, 1 for mc rec, 2 for mc gen
   double GetNUA(double phi, double eta, double vz);                                                   // This just fetches correction from integrated NUA, should speed up
   double GetNUE(double pt, double eta, double vz);                                                    // fetches weight from fEffInt
+  // Batch versions of GetNUA and GetNUE for the tracks of one event
+  void GetNUA(std::span<const double> phi, std::span<const double> eta, double vz, std::span<double> weights);
+  void GetNUE(std::span<const double> pt, std::span<const double> eta, double vz, std::span<double> weights);
   bool IsDataFilled() { return fDataFilled; }
   bool IsMCFilled() { return fMCFilled; }
   double FindMax(TH3D* inh, int& ix, int& iy, int& iz);
@@ -59,11 +99,15 @@ class GFWWeights : public TNamed
   TObjArray* fW_data;
   TObjArray* fW_mcrec;
   TObjArray* fW_mcgen;
-  TH3D* fEffInt;   //!
-  TH1D* fIntEff;   //!
-  TH3D* fAccInt;   //!
-  int fNbinsPt;    //! do not store
-  double* fbinsPt; //! do not store
+  TH3D* fEffInt;         //!
+  TH1D* fIntEff;         //!
+  TH3D* fAccInt;         //!
+  int fNbinsPt;          //! do not store
+  double* fbinsPt;       //! do not store
+  GFWWeightMap fAccFlat; //! flat copy of fAccInt, built at first use
+  GFWWeightMap fEffFlat; //! flat copy of fEffInt, built at first use
+  void BuildFlatNUA();
+  void BuildFlatNUE();
   void AddArray(TObjArray* targ, TObjArray* sour);
   const char* GetBinName(double /*ptv*/, double /*v0mv*/, const char* pf = "")
   {
@@ -123,6 +123,10 @@ struct GenericFramework {
   // define global variables
   GFW* fGFW = new GFW();
   std::vector<GFW::CorrConfig> corrconfigs;
+  std::vector<std::vector<int>> corrIndices; // FlowContainer index of each correlator, one per pT bin for pT-differential ones
+  std::vector<int> eventCorrIndices;         // correlators of the current event, filled at once
+  std::vector<double> eventCorrValues;
+  std::vector<double> eventCorrWeights;
   TRandom3* fRndm = new TRandom3(0);
   TAxis* fPtAxis;
 
@@ -236,11 +240,13 @@ struct GenericFramework {
       fFC->SetName("FlowContainer");
       fFC->SetXAxis(fPtAxis);
       fFC->Initialize(oba, multAxis, cfgNbootstrap);
+      SetCorrelatorIndices(fFC);
     }
     if (doprocessMCGen) {
       fFC_gen->SetName("FlowContainer_gen");
       fFC_gen->SetXAxis(fPtAxis);
       fFC_gen->Initialize(oba, multAxis, cfgNbootstrap);
+      SetCorrelatorIndices(fFC_gen);
     }
     delete oba;
     fFCpt->SetUseCentralMoments(cfgUseCentralMoments);
@@ -279,6 +285,23 @@ struct GenericFramework {
     }
   }
 
+  // resolve the correlator names once, reco and gen containers share the same correlators
+  template <typename TFlowContainer>
+  void SetCorrelatorIndices(TFlowContainer& fc)
+  {
+    corrIndices.clear();
+    for (const auto& corrconf : corrconfigs) {
+      std::vector<int> indices;
+      if (corrconf.pTDif) {
+        for (auto i = 1; i <= fPtAxis->GetNbins(); ++i)
+          indices.push_back(fc->GetCorrelatorIndex(Form("%s_pt_%i", corrconf.Head.c_str(), i)));
+      } else {
+        indices.push_back(fc->GetCorrelatorIndex(corrconf.Head.c_str()));
+      }
+      corrIndices.push_back(indices);
+    }
+  }
+
   void AddConfigObjectsToObjArray(TObjArray* oba, const std::vector<GFW::CorrConfig>& configs)
   {
     for (auto it = configs.begin(); it != configs.end(); ++it) {
@@ -427,6 +450,9 @@ struct GenericFramework {
     fFCpt->FillCMProfiles(centmult, rndm);
     if (!cfgUseGapMethod)
       fFCpt->FillVnPtStdProfiles(centmult, rndm);
+    eventCorrIndices.clear();
+    eventCorrValues.clear();
+    eventCorrWeights.clear();
     for (uint l_ind = 0; l_ind < corrconfigs.size(); ++l_ind) {
       auto dnx = fGFW->Calculate(corrconfigs.at(l_ind), 0, kTRUE).real();
       if (dnx == 0)
@@ -434,7 +460,9 @@ struct GenericFramework {
       if (!corrconfigs.at(l_ind).pTDif) {
         auto val = fGFW->Calculate(corrconfigs.at(l_ind), 0, kFALSE).real() / dnx;
         if (TMath::Abs(val) < 1) {
-          (dt == kGen) ? fFC_gen->FillProfile(corrconfigs.at(l_ind).Head.c_str(), centmult, val, dnx, rndm) : fFC->FillProfile(corrconfigs.at(l_ind).Head.c_str(), centmult, val, dnx, rndm);
+          eventCorrIndices.push_back(corrIndices[l_ind][0]);
+          eventCorrValues.push_back(val);
+          eventCorrWeights.push_back(dnx);
           if (cfgUseGapMethod)
             fFCpt->FillVnPtProfiles(centmult, val, dnx, rndm, configs.GetpTCorrMasks()[l_ind]);
         }
@@ -445,10 +473,14 @@ struct GenericFramework {
         if (dnx == 0)
           continue;
         auto val = fGFW->Calculate(corrconfigs.at(l_ind), i - 1, kFALSE).real() / dnx;
-        if (TMath::Abs(val) < 1)
-          (dt == kGen) ? fFC_gen->FillProfile(Form("%s_pt_%i", corrconfigs.at(l_ind).Head.c_str(), i), centmult, val, dnx, rndm) : fFC->FillProfile(Form("%s_pt_%i", corrconfigs.at(l_ind).Head.c_str(), i), centmult, val, dnx, rndm);
+        if (TMath::Abs(val) < 1) {
+          eventCorrIndices.push_back(corrIndices[l_ind][i - 1]);
+          eventCorrValues.push_back(val);
+          eventCorrWeights.push_back(dnx);
+        }
       }
     }
+    (dt == kGen) ? fFC_gen->FillEvent(centmult, eventCorrIndices, eventCorrValues, eventCorrWeights, rndm) : fFC->FillEvent(centmult, eventCorrIndices, eventCorrValues, eventCorrWeights, rndm);
     return;
   }
 
@@ -0,0 +1,173 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#ifndef PWGCF_MULTIPARTICLECORRELATIONS_CORE_MUPA_CORRELATORENGINE_H_
+#define PWGCF_MULTIPARTICLECORRELATIONS_CORE_MUPA_CORRELATORENGINE_H_
+
+#include <algorithm>
+#include <array>
+#include <complex>
+#include <cstdint>
+#include <cstdlib>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Framework/Logger.h"
+
+// Engine to calculate generic multi-particle correlators from Q-vectors.
+//
+// A correlator is a multiset of slots (harmonic, weight power). Removing the last slot (h,p) gives the recursion
+//   C(S + (h,p)) = Q(h,p) * C(S) - sum_{s in S} C(S with s -> (h_s + h, p_s + p)),
+// which only depends on the multiset of slots. Results are therefore cached per event, keyed by the sorted
+// multiset, and all sub-correlators are shared among all requested correlators (of any order, and their weights).
+// Q-vectors are kept in a flat array which holds also negative harmonics, so no conjugation is needed at look-up.
+class MuPaCorrelatorEngine
+{
+ public:
+  static constexpr int fMaxOrder = gMaxCorrelator;                    // max number of particles in a correlator
+  static constexpr int fMaxHarmonic = gMaxHarmonic * gMaxCorrelator;  // max |harmonic| of Q-vectors
+  static constexpr int fMaxPower = gMaxCorrelator;                    // max weight power of Q-vectors
+  static constexpr std::size_t fDefaultMaxCacheSize = 1 << 20;        // max number of cached sub-correlators per event
+
+  MuPaCorrelatorEngine() : fQ((2 * fMaxHarmonic + 1) * (fMaxPower + 1), std::complex<double>(0., 0.)) {}
+
+  // Set the Q-vectors for the current event from q[h][wp], with h in [0, fMaxHarmonic] and wp in [0, fMaxPower].
+  // Any object with Re() and Im() (e.g. TComplex) can be used for the elements. This invalidates the cache.
+  template <typename QArray>
+  void SetQ(const QArray& q)
+  {
+    for (int h = 0; h <= fMaxHarmonic; h++) {
+      for (int wp = 0; wp <= fMaxPower; wp++) {
+        std::complex<double> value(q[h][wp].Re(), q[h][wp].Im());
+        fQ[Index(h, wp)] = value;
+        fQ[Index(-h, wp)] = std::conj(value);
+      }
+    }
+    fCache.clear();
+  }
+
+  void Reset()
+  {
+    std::fill(fQ.begin(), fQ.end(), std::complex<double>(0., 0.));
+    fCache.clear();
+  }
+
+  void SetMaxCacheSize(std::size_t maxCacheSize) { fMaxCacheSize = maxCacheSize; }
+  std::size_t GetCacheSize() const { return fCache.size(); }
+
+  const std::complex<double>& Q(int h, int wp) const { return fQ[Index(h, wp)]; }
+
+  // Generic n-particle correlation <exp[i(n1*phi1+...+nn*phinn)]>, not yet divided by its weight.
+  std::complex<double> Correlator(int n, const int* harmonics)
+  {
+    if (n < 1 || n > fMaxOrder) {
+      LOGF(fatal, "\033[1;31m%s at line %d : n = %d is not supported\033[0m", __FUNCTION__, __LINE__, n);
+    }
+    Slots slots{};
+    int sumHarmonics = 0;
+    for (int i = 0; i < n; i++) {
+      slots[i] = {harmonics[i], 1};
+      sumHarmonics += std::abs(harmonics[i]);
+    }
+    if (sumHarmonics > fMaxHarmonic) { // this also bounds all merged harmonics in the recursion, see MakeKey
+      LOGF(fatal, "\033[1;31m%s at line %d : sum of |harmonics| = %d is bigger than %d\033[0m", __FUNCTION__, __LINE__, sumHarmonics, fMaxHarmonic);
+    }
+    Sort(slots, n);
+    return Evaluate(slots, n);
+  }
+
+  std::complex<double> Correlator(const std::vector<int>& harmonics) { return Correlator(harmonics.size(), harmonics.data()); }
+
+ private:
+  struct Slot {
+    int h;
+    int p;
+  };
+  using Slots = std::array<Slot, fMaxOrder>;
+  using Key = std::array<uint64_t, 3>; // 12 bits per slot (harmonic + 128, power), 5 slots per word
+
+  struct KeyHash {
+    std::size_t operator()(const Key& key) const
+    {
+      std::size_t seed = 0;
+      for (const auto& word : key) {
+        seed ^= std::hash<uint64_t>{}(word) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+      }
+      return seed;
+    }
+  };
+
+  static int Index(int h, int wp)
+  {
+    if (std::abs(h) > fMaxHarmonic || wp < 0 || wp > fMaxPower) {
+      LOGF(fatal, "\033[1;31m%s at line %d : Q-vector (%d,%d) is out of range\033[0m", __FUNCTION__, __LINE__, h, wp);
+    }
+    return (h + fMaxHarmonic) * (fMaxPower + 1) + wp;
+  }
+
+  static void Sort(Slots& slots, int n)
+  {
+    // insertion sort, n is small
+    for (int i = 1; i < n; i++) {
+      Slot slot = slots[i];
+      int j = i - 1;
+      while (j >= 0 && (slots[j].h > slot.h || (slots[j].h == slot.h && slots[j].p > slot.p))) {
+        slots[j + 1] = slots[j];
+        j--;
+      }
+      slots[j + 1] = slot;
+    }
+  }
+
+  static Key MakeKey(const Slots& slots, int n)
+  {
+    Key key{0, 0, 0};
+    for (int i = 0; i < n; i++) {
+      uint64_t code = (static_cast<uint64_t>(slots[i].h + 128) << 4) | static_cast<uint64_t>(slots[i].p);
+      key[i / 5] |= code << (12 * (i % 5));
+    }
+    return key;
+  }
+
+  // slots[0..n) must be sorted
+  std::complex<double> Evaluate(const Slots& slots, int n)
+  {
+    if (n == 1) {
+      return Q(slots[0].h, slots[0].p);
+    }
+    Key key = MakeKey(slots, n);
+    auto cached = fCache.find(key);
+    if (cached != fCache.end()) {
+      return cached->second;
+    }
+
+    const Slot& last = slots[n - 1];
+    std::complex<double> c = Q(last.h, last.p) * Evaluate(slots, n - 1);
+    for (int i = 0; i < n - 1; i++) {
+      Slots merged = slots;
+      merged[i] = {slots[i].h + last.h, slots[i].p + last.p};
+      Sort(merged, n - 1);
+      c -= Evaluate(merged, n - 1);
+    }
+
+    if (fCache.size() < fMaxCacheSize) {
+      fCache.emplace(key, c);
+    }
+    return c;
+  }
+
+  std::vector<std::complex<double>> fQ;                          // Q(h,wp) for h in [-fMaxHarmonic, fMaxHarmonic]
+  std::unordered_map<Key, std::complex<double>, KeyHash> fCache; // sub-correlators of the current event
+  std::size_t fMaxCacheSize = fDefaultMaxCacheSize;              // beyond this, sub-correlators are recalculated
+};
+
+#endif // PWGCF_MULTIPARTICLECORRELATIONS_CORE_MUPA_CORRELATORENGINE_H_
@@ -70,6 +70,9 @@ using namespace std;
 // *) Global constants:
 #include "PWGCF/MultiparticleCorrelations/Core/MuPa-GlobalConstants.h"
 
+// *) Correlator engine:
+#include "PWGCF/MultiparticleCorrelations/Core/MuPa-CorrelatorEngine.h"
+
 // *) Main task:
 struct MultiparticleCorrelationsAB // this name is used in lower-case format to name the TDirectoryFile in AnalysisResults.root
 {
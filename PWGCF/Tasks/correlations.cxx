@@ -31,6 +31,7 @@
 #include "Common/DataModel/Centrality.h"
 #include "PWGCF/DataModel/CorrelationsDerived.h"
 #include "PWGCF/Core/CorrelationContainer.h"
+#include "PWGCF/Core/CorrelationPairBuffer.h"
 #include "PWGCF/Core/PairCuts.h"
 #include "DataFormatsParameters/GRPObject.h"
 #include "DataFormatsParameters/GRPMagField.h"
@@ -85,6 +86,7 @@ struct CorrelationTask {
 
   O2_DEFINE_CONFIGURABLE(cfgDecayParticleMask, int, 0, "Selection bitmask for the decay particles: 0 = no selection")
   O2_DEFINE_CONFIGURABLE(cfgMassAxis, int, 0, "Use invariant mass axis (0 = OFF, 1 = ON)")
+  O2_DEFINE_CONFIGURABLE(cfgPairBufferMaxCells, int, 4000000, "Maximum number of cells (product of the pair axes but multiplicity and vertex) of the per-event pair buffer, above it the pairs are filled directly")
   O2_DEFINE_CONFIGURABLE(cfgMcTriggerPDGs, std::vector<int>, {}, "MC PDG codes to use exclusively as trigger particles and exclude from associated particles. Empty = no selection.")
 
   ConfigurableAxis axisVertex{"axisVertex", {7, -7, 7}, "vertex axis for histograms"};
@@ -122,6 +124,11 @@ struct CorrelationTask {
   OutputObj<CorrelationContainer> mixed{"mixedEvent"};
 
   std::vector<float> efficiencyAssociatedCache;
+  std::vector<int> ptAssociatedBinCache;
+
+  CorrelationPairBuffer pairBuffer; // pairs of the current event, added to the pair histogram once per event
+  CorrelationEfficiencyCache efficiencyTriggerBinned;
+  CorrelationEfficiencyCache efficiencyAssociatedBinned;
 
   struct Config {
     bool mPairCuts = false;
@@ -188,10 +195,15 @@ struct CorrelationTask {
     same.setObject(new CorrelationContainer("sameEvent", "sameEvent", corrAxis, effAxis, userAxis));
     mixed.setObject(new CorrelationContainer("mixedEvent", "mixedEvent", corrAxis, effAxis, userAxis));
 
+    std::vector<AxisSpec> pairAxis(corrAxis);
+    pairAxis.insert(pairAxis.end(), userAxis.begin(), userAxis.end());
+    pairBuffer.init(pairAxis, cfgPairBufferMaxCells);
+
     same->setTrackEtaCut(cfgCutEta);
     mixed->setTrackEtaCut(cfgCutEta);
 
     efficiencyAssociatedCache.reserve(512);
+    ptAssociatedBinCache.reserve(512);
 
     // o2-ccdb-upload -p Users/jgrosseo/correlations/LHC15o -f /tmp/correction_2011_global.root -k correction
 
@@ -296,15 +308,26 @@ struct CorrelationTask {
   template <CorrelationContainer::CFStep step, typename TTarget, typename TTracks1, typename TTracks2>
   void fillCorrelations(TTarget target, TTracks1& tracks1, TTracks2& tracks2, float multiplicity, float posZ, int magField, float eventWeight)
   {
-    // Cache efficiency for particles (too many FindBin lookups)
+    // Pairs are filled only if the event is inside of the multiplicity and vertex axes of the pair histogram
+    const bool fillPairs = pairBuffer.setEvent(multiplicity, posZ);
+
+    // Cache pT bins and efficiency for associated particles (too many FindBin lookups)
+    ptAssociatedBinCache.clear();
+    for (auto& track : tracks2) {
+      ptAssociatedBinCache.push_back(pairBuffer.findBin(CorrelationPairBuffer::PtAssoc, track.pt()));
+    }
     if constexpr (step == CorrelationContainer::kCFStepCorrected) {
       if (cfg.mEfficiencyAssociated) {
+        efficiencyAssociatedBinned.setEvent(multiplicity, posZ);
         efficiencyAssociatedCache.clear();
         efficiencyAssociatedCache.reserve(tracks2.size());
         for (auto& track : tracks2) {
-          efficiencyAssociatedCache.push_back(getEfficiencyCorrection(cfg.mEfficiencyAssociated, track.eta(), track.pt(), multiplicity, posZ));
+          efficiencyAssociatedCache.push_back(efficiencyAssociatedBinned.get(track.eta(), track.pt()));
         }
       }
+      if (cfg.mEfficiencyTrigger) {
+        efficiencyTriggerBinned.setEvent(multiplicity, posZ);
+      }
     }
 
     for (auto& track1 : tracks1) {
@@ -335,7 +358,7 @@ struct CorrelationTask {
       float triggerWeight = eventWeight;
       if constexpr (step == CorrelationContainer::kCFStepCorrected) {
         if (cfg.mEfficiencyTrigger) {
-          triggerWeight *= getEfficiencyCorrection(cfg.mEfficiencyTrigger, track1.eta(), track1.pt(), multiplicity, posZ);
+          triggerWeight *= efficiencyTriggerBinned.get(track1.eta(), track1.pt());
         }
       }
 
@@ -348,7 +371,17 @@ struct CorrelationTask {
         target->getTriggerHist()->Fill(step, track1.pt(), multiplicity, posZ, triggerWeight);
       }
 
+      const int ptTriggerBin = pairBuffer.findBin(CorrelationPairBuffer::PtTrig, track1.pt());
+      int userBin = 0;
+      if constexpr (std::experimental::is_detected<hasInvMass, typename TTracks1::iterator>::value) {
+        userBin = pairBuffer.findBin(CorrelationPairBuffer::User, track1.invMass());
+      } else if (pairBuffer.hasUserAxis()) {
+        LOGF(fatal, "Can not fill mass axis without invMass column. Disable cfgMassAxis.");
+      }
+
+      int track2Index = -1;
       for (auto& track2 : tracks2) {
+        track2Index++;
         if constexpr (std::is_same<TTracks1, TTracks2>::value) {
           if (track1.globalIndex() == track2.globalIndex()) {
             // LOGF(info, "Track identical: %f | %f | %f || %f | %f | %f", track1.eta(), track1.phi(), track1.pt(),  track2.eta(), track2.phi(), track2.pt());
@@ -404,7 +437,7 @@ struct CorrelationTask {
         float associatedWeight = triggerWeight;
         if constexpr (step == CorrelationContainer::kCFStepCorrected) {
           if (cfg.mEfficiencyAssociated) {
-            associatedWeight *= efficiencyAssociatedCache[track2.filteredIndex()];
+            associatedWeight *= efficiencyAssociatedCache[track2Index];
           }
         }
 
@@ -416,17 +449,25 @@ struct CorrelationTask {
           deltaPhi += TwoPI;
         }
 
-        // last param is the weight
-        if (cfgMassAxis) {
-          if constexpr (std::experimental::is_detected<hasInvMass, typename TTracks1::iterator>::value)
+        if (pairBuffer.isBuffered()) {
+          const int ptAssociatedBin = ptAssociatedBinCache[track2Index];
+          const int deltaEtaBin = pairBuffer.findBin(CorrelationPairBuffer::DeltaEta, track1.eta() - track2.eta());
+          const int deltaPhiBin = pairBuffer.findBin(CorrelationPairBuffer::DeltaPhi, deltaPhi);
+          if (fillPairs && ptTriggerBin >= 0 && ptAssociatedBin >= 0 && deltaEtaBin >= 0 && deltaPhiBin >= 0 && userBin >= 0) {
+            pairBuffer.fill(deltaEtaBin, ptAssociatedBin, ptTriggerBin, deltaPhiBin, userBin, associatedWeight);
+          }
+        } else if (cfgMassAxis) {
+          // last param is the weight
+          if constexpr (std::experimental::is_detected<hasInvMass, typename TTracks1::iterator>::value) {
             target->getPairHist()->Fill(step, track1.eta() - track2.eta(), track2.pt(), track1.pt(), multiplicity, deltaPhi, posZ, track1.invMass(), associatedWeight);
-          else
-            LOGF(fatal, "Can not fill mass axis without invMass column. Disable cfgMassAxis.");
+          }
         } else {
           target->getPairHist()->Fill(step, track1.eta() - track2.eta(), track2.pt(), track1.pt(), multiplicity, deltaPhi, posZ, associatedWeight);
         }
       }
     }
+
+    pairBuffer.flush(target->getPairHist(), step);
   }
 
   void loadEfficiency(uint64_t timestamp)
@@ -445,6 +486,7 @@ struct CorrelationTask {
         LOGF(fatal, "Could not load efficiency histogram for trigger particles from %s", cfgEfficiencyTrigger.value.c_str());
       }
       LOGF(info, "Loaded efficiency histogram for trigger particles from %s (%p)", cfgEfficiencyTrigger.value.c_str(), (void*)cfg.mEfficiencyTrigger);
+      efficiencyTriggerBinned.init(cfg.mEfficiencyTrigger);
     }
     if (cfgEfficiencyAssociated.value.empty() == false) {
       if (cfgLocalEfficiency > 0) {
@@ -457,20 +499,11 @@ struct CorrelationTask {
         LOGF(fatal, "Could not load efficiency histogram for associated particles from %s", cfgEfficiencyAssociated.value.c_str());
       }
       LOGF(info, "Loaded efficiency histogram for associated particles from %s (%p)", cfgEfficiencyAssociated.value.c_str(), (void*)cfg.mEfficiencyAssociated);
+      efficiencyAssociatedBinned.init(cfg.mEfficiencyAssociated);
     }
     cfg.efficiencyLoaded = true;
   }
 
-  double getEfficiencyCorrection(THn* eff, float eta, float pt, float multiplicity, float posZ)
-  {
-    int effVars[4];
-    effVars[0] = eff->GetAxis(0)->FindBin(eta);
-    effVars[1] = eff->GetAxis(1)->FindBin(pt);
-    effVars[2] = eff->GetAxis(2)->FindBin(multiplicity);
-    effVars[3] = eff->GetAxis(3)->FindBin(posZ);
-    return eff->GetBinContent(effVars);
-  }
-
   // Version with explicit nested loop
   void processSameAOD(aodCollisions::iterator const& collision, aod::BCsWithTimestamps const&, aodTracks const& tracks)
   {
@@ -18,7 +18,11 @@
 #include <cmath>
 #include <array>
 #include <cstdlib>
-#include <map>
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <tuple>
+#include <vector>
 #include <iterator>
 #include <utility>
 
@@ -615,8 +619,9 @@ struct PhotonConversionBuilder {
     if (!checkAP(alpha, qt, max_alpha_ap, max_qt_ap)) { // store only photon conversions
       return;
     }
-    pca_map[std::make_tuple(v0.globalIndex(), collision.globalIndex(), pos.globalIndex(), ele.globalIndex())] = pca_kf;
-    cospa_map[std::make_tuple(v0.globalIndex(), collision.globalIndex(), pos.globalIndex(), ele.globalIndex())] = cospa_kf;
+    if (!filltable) {
+      v0cands.push_back(v0.globalIndex(), collision.globalIndex(), pos.globalIndex(), ele.globalIndex(), pca_kf, cospa_kf);
+    }
 
     if (filltable) {
       registry.fill(HIST("V0/hAP"), alpha, qt);
@@ -675,15 +680,47 @@ struct PhotonConversionBuilder {
   }
 
   Preslice<aod::V0s> perCollision = o2::aod::v0::collisionId;
-  std::map<std::tuple<int64_t, int64_t, int64_t, int64_t>, float> pca_map;      // (v0.globalIndex(), collision.globalIndex(), pos.globalIndex(), ele.globalIndex()) -> pca
-  std::map<std::tuple<int64_t, int64_t, int64_t, int64_t>, float> cospa_map;    // (v0.globalIndex(), collision.globalIndex(), pos.globalIndex(), ele.globalIndex()) -> cospa
-  std::vector<std::pair<int64_t, int64_t>> stored_v0Ids;                        // (pos.globalIndex(), ele.globalIndex())
-  std::vector<std::tuple<int64_t, int64_t, int64_t, int64_t>> stored_fullv0Ids; // (v0.globalIndex(), collision.globalIndex(), pos.globalIndex(), ele.globalIndex())
-  std::unordered_map<int64_t, int> nv0_map;                                     // map collisionId -> nv0
+
+  // photon candidates of the DF, struct of arrays. The capacity is kept from DF to DF.
+  struct {
+    std::vector<int64_t> v0Id;
+    std::vector<int64_t> collisionId;
+    std::vector<int64_t> posId;
+    std::vector<int64_t> eleId;
+    std::vector<float> pca;
+    std::vector<float> cospa;
+
+    size_t size() const { return v0Id.size(); }
+    void push_back(int64_t v0Id_, int64_t collisionId_, int64_t posId_, int64_t eleId_, float pca_, float cospa_)
+    {
+      v0Id.emplace_back(v0Id_);
+      collisionId.emplace_back(collisionId_);
+      posId.emplace_back(posId_);
+      eleId.emplace_back(eleId_);
+      pca.emplace_back(pca_);
+      cospa.emplace_back(cospa_);
+    }
+    void clear()
+    {
+      v0Id.clear();
+      collisionId.clear();
+      posId.clear();
+      eleId.clear();
+      pca.clear();
+      cospa.clear();
+    }
+  } v0cands;
+  std::vector<float> min_pca_pos;     // track globalIndex -> minimal pca among candidates with this positive leg
+  std::vector<float> min_pca_ele;     // track globalIndex -> minimal pca among candidates with this negative leg
+  std::vector<uint32_t> cand_order;   // candidate indices, sorted by (posId, eleId, v0Id) or by v0Id
+  std::vector<bool> is_accepted_cand; // candidate index -> accepted as photon
+  std::vector<int> nv0_per_collision; // collision globalIndex -> nv0
 
   template <bool isMC, bool isTriggerAnalysis, bool enableFilter, typename TCollisions, typename TV0s, typename TTracks, typename TBCs>
-  void build(TCollisions const& collisions, TV0s const& v0s, TTracks const&, TBCs const&)
+  void build(TCollisions const& collisions, TV0s const& v0s, TTracks const& tracks, TBCs const&)
   {
+    v0cands.clear();
+    nv0_per_collision.assign(collisions.size(), 0);
     for (const auto& collision : collisions) {
       if constexpr (isMC) {
         if (!collision.has_mcCollision()) {
@@ -703,8 +740,6 @@ struct PhotonConversionBuilder {
         }
       }
 
-      nv0_map[collision.globalIndex()] = 0;
-
       const auto& bc = collision.template bc_as<aod::BCsWithTimestamps>();
       initCCDB(bc);
       registry.fill(HIST("hCollisionCounter"), 1);
@@ -723,79 +758,75 @@ struct PhotonConversionBuilder {
       } // end of v0 loop
     } // end of collision loop
 
-    stored_v0Ids.reserve(pca_map.size());     // number of photon candidates per DF
-    stored_fullv0Ids.reserve(pca_map.size()); // number of photon candidates per DF
-
-    // find minimal pca
-    for (const auto& [key, value] : pca_map) {
-      auto v0Id = std::get<0>(key);
-      auto collisionId = std::get<1>(key);
-      auto posId = std::get<2>(key);
-      auto eleId = std::get<3>(key);
-      float v0pca = value;
-      float cospa = cospa_map[key];
-      bool is_closest_v0 = true;
-      bool is_most_aligned_v0 = true;
-
-      for (const auto& [key_tmp, value_tmp] : pca_map) {
-        auto v0Id_tmp = std::get<0>(key_tmp);
-        auto collisionId_tmp = std::get<1>(key_tmp);
-        auto posId_tmp = std::get<2>(key_tmp);
-        auto eleId_tmp = std::get<3>(key_tmp);
-        float v0pca_tmp = value_tmp;
-        float cospa_tmp = cospa_map[key_tmp];
-
-        if (v0Id == v0Id_tmp) { // skip exactly the same v0
-          continue;
+    // shared-leg arbitration. A candidate is rejected,
+    // - if another candidate with the same positive or negative leg has a smaller pca, or
+    // - if the same pair of legs is attached to another collision with a larger cospa.
+    // Among accepted candidates with the same pair of legs, only the one with the smallest v0Id is stored.
+    const size_t ncands = v0cands.size();
+    min_pca_pos.assign(tracks.size(), std::numeric_limits<float>::max());
+    min_pca_ele.assign(tracks.size(), std::numeric_limits<float>::max());
+    for (size_t i = 0; i < ncands; i++) {
+      min_pca_pos[v0cands.posId[i]] = std::min(min_pca_pos[v0cands.posId[i]], v0cands.pca[i]);
+      min_pca_ele[v0cands.eleId[i]] = std::min(min_pca_ele[v0cands.eleId[i]], v0cands.pca[i]);
+    }
+
+    cand_order.resize(ncands);
+    std::iota(cand_order.begin(), cand_order.end(), 0);
+    std::sort(cand_order.begin(), cand_order.end(), [&](uint32_t a, uint32_t b) {
+      return std::tie(v0cands.posId[a], v0cands.eleId[a], v0cands.v0Id[a]) < std::tie(v0cands.posId[b], v0cands.eleId[b], v0cands.v0Id[b]);
+    });
+    is_accepted_cand.assign(ncands, false);
+    for (size_t begin = 0, end = 0; begin < ncands; begin = end) {
+      // candidates with the same pair of legs: [begin, end)
+      uint32_t best = cand_order[begin]; // largest cospa
+      for (end = begin + 1; end < ncands && v0cands.posId[cand_order[end]] == v0cands.posId[best] && v0cands.eleId[cand_order[end]] == v0cands.eleId[best]; end++) {
+        if (v0cands.cospa[cand_order[end]] > v0cands.cospa[best]) {
+          best = cand_order[end];
         }
-
-        if (collisionId != collisionId_tmp && eleId == eleId_tmp && posId == posId_tmp && cospa < cospa_tmp) { // same ele and pos, but attached to different collision
-          // LOGF(info, "!reject! | collision id = %d | posid1 = %d , eleid1 = %d , posid2 = %d , eleid2 = %d , cospa1 = %f , cospa2 = %f", collisionId, posId, eleId, posId_tmp, eleId_tmp, cospa, cospa_tmp);
-          is_most_aligned_v0 = false;
-          break;
+      }
+      float max_cospa_other = -std::numeric_limits<float>::max(); // largest cospa from another collision than the one of best
+      for (size_t k = begin; k < end; k++) {
+        if (v0cands.collisionId[cand_order[k]] != v0cands.collisionId[best]) {
+          max_cospa_other = std::max(max_cospa_other, v0cands.cospa[cand_order[k]]);
         }
+      }
 
-        if ((eleId == eleId_tmp || posId == posId_tmp) && v0pca > v0pca_tmp) {
-          // LOGF(info, "!reject! | collision id = %d | posid1 = %d , eleid1 = %d , posid2 = %d , eleid2 = %d , pca1 = %f , pca2 = %f", collisionId, posId, eleId, posId_tmp, eleId_tmp, v0pca, v0pca_tmp);
-          is_closest_v0 = false;
-          break;
+      bool is_stored = false;
+      for (size_t k = begin; k < end && !is_stored; k++) {
+        uint32_t i = cand_order[k];
+        float max_cospa_other_collision = v0cands.collisionId[i] != v0cands.collisionId[best] ? v0cands.cospa[best] : max_cospa_other;
+        bool is_most_aligned_v0 = !(v0cands.cospa[i] < max_cospa_other_collision);
+        bool is_closest_v0 = !(min_pca_pos[v0cands.posId[i]] < v0cands.pca[i]) && !(min_pca_ele[v0cands.eleId[i]] < v0cands.pca[i]);
+        if (is_closest_v0 && is_most_aligned_v0) {
+          is_accepted_cand[i] = true;
+          is_stored = true;
         }
-      } // end of pca_map tmp loop
-
-      bool is_stored = std::find(stored_v0Ids.begin(), stored_v0Ids.end(), std::make_pair(posId, eleId)) != stored_v0Ids.end();
-      if (is_closest_v0 && is_most_aligned_v0 && !is_stored) {
-        // auto v0 = v0s.rawIteratorAt(v0Id);
-        // auto collision = collisions.rawIteratorAt(collisionId);
-        // auto pos = tracks.rawIteratorAt(posId);
-        // auto ele = tracks.rawIteratorAt(eleId);
-        // LOGF(info, "!accept! | collision id = %d | v0id1 = %d , posid1 = %d , eleid1 = %d , pca1 = %f , cospa = %f", collisionId, v0Id, posId, eleId, v0pca, cospa);
-
-        // fillV0Table<isMC, TCollisions, TTracks>(v0, true);
-        stored_v0Ids.emplace_back(std::make_pair(posId, eleId));
-        stored_fullv0Ids.emplace_back(std::make_tuple(v0Id, collisionId, posId, eleId));
-        nv0_map[collisionId]++;
       }
-    } // end of pca_map loop
-    // LOGF(info, "pca_map.size() = %d", pca_map.size());
+    }
 
-    for (auto& fullv0Id : stored_fullv0Ids) {
-      auto v0Id = std::get<0>(fullv0Id);
-      // auto collisionId = std::get<1>(fullv0Id);
-      // auto posId = std::get<2>(fullv0Id);
-      // auto eleId = std::get<3>(fullv0Id);
-      // LOGF(info, "!accept! | collision id = %d | v0id = %d , posid = %d , eleid = %d", collisionId, v0Id, posId, eleId);
+    // accepted candidates in the order of v0Id
+    std::sort(cand_order.begin(), cand_order.end(), [&](uint32_t a, uint32_t b) { return v0cands.v0Id[a] < v0cands.v0Id[b]; });
+    for (const auto& i : cand_order) {
+      if (is_accepted_cand[i]) {
+        nv0_per_collision[v0cands.collisionId[i]]++;
+      }
+    }
 
-      auto v0 = v0s.rawIteratorAt(v0Id);
+    for (const auto& i : cand_order) {
+      if (!is_accepted_cand[i]) {
+        continue;
+      }
+      auto v0 = v0s.rawIteratorAt(v0cands.v0Id[i]);
       if constexpr (enableFilter) {
         auto collision_tmp = v0.template collision_as<TCollisions>(); // collision where this v0 belongs.
-        if (!(collision_tmp.neeuls() >= 1 || collision_tmp.neeuls() + nv0_map[collision_tmp.globalIndex()] >= 2)) {
+        if (!(collision_tmp.neeuls() >= 1 || collision_tmp.neeuls() + nv0_per_collision[collision_tmp.globalIndex()] >= 2)) {
           continue;
         }
-        // LOGF(info, "collision_tmp.globalIndex() = %d, collision_tmp.neeuls() = %d, nv0_map = %d", collision_tmp.globalIndex(), collision_tmp.neeuls(), nv0_map[collision_tmp.globalIndex()]);
+        // LOGF(info, "collision_tmp.globalIndex() = %d, collision_tmp.neeuls() = %d, nv0 = %d", collision_tmp.globalIndex(), collision_tmp.neeuls(), nv0_per_collision[collision_tmp.globalIndex()]);
       }
 
       fillV0Table<isMC, TBCs, TCollisions, TTracks>(v0, true);
-    } // end of fullv0Id loop
+    } // end of accepted candidate loop
 
     for (auto& collision : collisions) {
       if constexpr (isMC) {
@@ -803,16 +834,10 @@ struct PhotonConversionBuilder {
           continue;
         }
       }
-      events_ngpcm(nv0_map[collision.globalIndex()]);
+      events_ngpcm(nv0_per_collision[collision.globalIndex()]);
     } // end of collision loop
 
-    pca_map.clear();
-    cospa_map.clear();
-    nv0_map.clear();
-    stored_v0Ids.clear();
-    stored_v0Ids.shrink_to_fit();
-    stored_fullv0Ids.clear();
-    stored_fullv0Ids.shrink_to_fit();
+    v0cands.clear();
   } // end of build
 
   //! type of V0. 0: built solely for cascades (does not pass standard V0 cuts), 1: standard 2, 3: photon-like with TPC-only use. Regular analysis should always use type 1 or 3.
@@ -419,6 +419,46 @@ DECLARE_SOA_TABLE(HfPvRefitDstar, "AOD", "HFPVREFITDSTAR", //!
                   hf_pv_refit::PvRefitSigmaZ2,
                   o2::soa::Marker<2>);
 
+// secondary-vertex fit of the track-index skim, reused by the candidate creators
+namespace hf_skim_vertex
+{
+DECLARE_SOA_COLUMN(SvX, svX, double);                //! x of the secondary vertex (cm)
+DECLARE_SOA_COLUMN(SvY, svY, double);                //! y of the secondary vertex (cm)
+DECLARE_SOA_COLUMN(SvZ, svZ, double);                //! z of the secondary vertex (cm)
+DECLARE_SOA_COLUMN(SvCov, svCov, float[6]);          //! covariance matrix of the secondary vertex
+DECLARE_SOA_COLUMN(SvChi2, svChi2, float);           //! chi2 of the secondary vertex at the PCA
+DECLARE_SOA_COLUMN(Prong0Par, prong0Par, float[7]);  //! prong 0 at the PCA: x, alpha, y, z, snp, tgl, q/pt
+DECLARE_SOA_COLUMN(Prong0Cov, prong0Cov, float[15]); //! covariance matrix of prong 0 at the PCA
+DECLARE_SOA_COLUMN(Prong1Par, prong1Par, float[7]);  //! prong 1 at the PCA: x, alpha, y, z, snp, tgl, q/pt
+DECLARE_SOA_COLUMN(Prong1Cov, prong1Cov, float[15]); //! covariance matrix of prong 1 at the PCA
+DECLARE_SOA_COLUMN(Prong2Par, prong2Par, float[7]);  //! prong 2 at the PCA: x, alpha, y, z, snp, tgl, q/pt
+DECLARE_SOA_COLUMN(Prong2Cov, prong2Cov, float[15]); //! covariance matrix of prong 2 at the PCA
+} // namespace hf_skim_vertex
+
+DECLARE_SOA_TABLE(HfSkimVtx2Prongs, "AOD", "HFSKIMVTX2PRONG", //! Secondary-vertex fit of HF 2-prong candidates, joinable with Hf2Prongs
+                  hf_skim_vertex::SvX,
+                  hf_skim_vertex::SvY,
+                  hf_skim_vertex::SvZ,
+                  hf_skim_vertex::SvCov,
+                  hf_skim_vertex::SvChi2,
+                  hf_skim_vertex::Prong0Par,
+                  hf_skim_vertex::Prong0Cov,
+                  hf_skim_vertex::Prong1Par,
+                  hf_skim_vertex::Prong1Cov);
+
+DECLARE_SOA_TABLE(HfSkimVtx3Prongs, "AOD", "HFSKIMVTX3PRONG", //! Secondary-vertex fit of HF 3-prong candidates, joinable with Hf3Prongs
+                  hf_skim_vertex::SvX,
+                  hf_skim_vertex::SvY,
+                  hf_skim_vertex::SvZ,
+                  hf_skim_vertex::SvCov,
+                  hf_skim_vertex::SvChi2,
+                  hf_skim_vertex::Prong0Par,
+                  hf_skim_vertex::Prong0Cov,
+                  hf_skim_vertex::Prong1Par,
+                  hf_skim_vertex::Prong1Cov,
+                  hf_skim_vertex::Prong2Par,
+                  hf_skim_vertex::Prong2Cov);
+
 // general decay properties
 namespace hf_cand
 {
@@ -27,9 +27,11 @@
 #include "PWGHF/DataModel/CandidateReconstructionTables.h"
 #include "PWGHF/DataModel/CandidateSelectionTables.h"
 #include "PWGHF/HFC/DataModel/CorrelationTables.h"
+#include "PWGHF/HFC/Utils/utilsCorrelations.h"
 
 using namespace o2;
 using namespace o2::analysis;
+using namespace o2::analysis::hf_correlations;
 using namespace o2::constants::physics;
 using namespace o2::constants::math;
 using namespace o2::framework;
@@ -175,6 +177,13 @@ struct HfCorrelatorDplusHadrons {
   Configurable<float> ptTrackMax{"ptTrackMax", 100., "max. track pT"};
   Configurable<float> multMin{"multMin", 0., "minimum multiplicity accepted"};
   Configurable<float> multMax{"multMax", 10000., "maximum multiplicity accepted"};
+  Configurable<bool> fillBinnedCorrelations{"fillBinnedCorrelations", false, "Fill the data correlations as histograms from binned associated tracks instead of pair tables (only candidates and tracks inside of the pT, #eta and mass bins are correlated)"};
+  Configurable<int> nBinsPhiBinned{"nBinsPhiBinned", 64, "Number of #varphi bins of the binned correlations (multiple of 4)"};
+  Configurable<int> nBinsEtaBinned{"nBinsEtaBinned", 16, "Number of #eta bins of the associated tracks in the binned correlations"};
+  Configurable<float> etaCandMaxBinned{"etaCandMaxBinned", 1., "max. cand. #eta in the binned correlations"};
+  Configurable<std::vector<double>> binsMassDBinned{"binsMassDBinned", std::vector<double>{1.70, 1.75, 1.78, 1.81, 1.83, 1.85, 1.86, 1.87, 1.88, 1.89, 1.91, 1.93, 1.96, 1.99, 2.02, 2.05}, "inv. mass bin limits of the binned correlations, for the signal region and the sidebands (candidates outside are not correlated)"};
+  Configurable<float> mlScoreBkgMaxBinned{"mlScoreBkgMaxBinned", 1., "max. ML score of the first class of classMl (background) of the candidates in the binned correlations"};
+  Configurable<float> mlScorePromptMinBinned{"mlScorePromptMinBinned", -1., "min. ML score of the second class of classMl (prompt) of the candidates in the binned correlations"};
   Configurable<std::vector<int>> classMl{"classMl", {0, 1, 2}, "Indexes of ML scores to be stored. Three indexes max."};
   Configurable<std::vector<double>> binsPtD{"binsPtD", std::vector<double>{o2::analysis::hf_cuts_dplus_to_pi_k_pi::vecBinsPt}, "pT bin limits for candidate mass plots"};
   Configurable<std::vector<double>> binsPtHadron{"binsPtHadron", std::vector<double>{0.3, 2., 4., 8., 12., 50.}, "pT bin limits for assoc particle"};
@@ -193,6 +202,7 @@ struct HfCorrelatorDplusHadrons {
   HfHelper hfHelper;
   SliceCache cache;
   BinningType corrBinning{{binsZVtx, binsMultiplicity}, true};
+  BinnedCorrelations binnedCorrelations;
 
   // Event Mixing for the Data Mode
   using SelCollisionsWithDplus = soa::Filtered<soa::Join<aod::Collisions, aod::Mults, aod::EvSels, aod::DmesonSelection>>;
@@ -288,6 +298,41 @@ struct HfCorrelatorDplusHadrons {
     registry.add("hPhiMcGen", "D+,Hadron particles - MC Gen", {HistType::kTH1F, {axisPhi}});
     registry.add("hMultFT0AMcGen", "D+,Hadron multiplicity FT0A - MC Gen", {HistType::kTH1F, {axisMultiplicity}});
     corrBinning = {{binsZVtx, binsMultiplicity}, true};
+
+    if (fillBinnedCorrelations) {
+      if (nBinsPhiBinned <= 0 || nBinsPhiBinned % 4 != 0) {
+        LOGF(fatal, "nBinsPhiBinned must be a positive multiple of 4");
+      }
+      // one trigger class per inv. mass bin
+      binnedCorrelations.init(nBinsPhiBinned, nBinsEtaBinned, etaTrackMax, etaCandMaxBinned, binsPtD, binsPtHadron, binsMassDBinned->size() - 1);
+      AxisSpec axisDeltaPhi = {binnedCorrelations.getNBinsDeltaPhi(), binnedCorrelations.getDeltaPhiMin(), binnedCorrelations.getDeltaPhiMax(), "#Delta#varphi"};
+      AxisSpec axisDeltaEta = {binnedCorrelations.getNBinsDeltaEta(), binnedCorrelations.getDeltaEtaMin(), binnedCorrelations.getDeltaEtaMax(), "#Delta#eta"};
+      AxisSpec axisMassDBinned = {(std::vector<double>)binsMassDBinned, "inv. mass (#pi^{+}K^{-}#pi^{+}) (GeV/#it{c}^{2})"};
+      registry.add("hCorrel2DVsPtSameEvent", "Dplus-Hadron correlations - same event;#Delta#varphi;#Delta#eta;#it{p}_{T} D+ (GeV/#it{c});#it{p}_{T} Hadron (GeV/#it{c});inv. mass (#pi^{+}K^{-}#pi^{+}) (GeV/#it{c}^{2});pool bin", {HistType::kTHnSparseF, {axisDeltaPhi, axisDeltaEta, axisPtD, axisPtHadron, axisMassDBinned, axisPoolBin}});
+      registry.add("hCorrel2DVsPtMixedEvent", "Dplus-Hadron correlations - mixed event;#Delta#varphi;#Delta#eta;#it{p}_{T} D+ (GeV/#it{c});#it{p}_{T} Hadron (GeV/#it{c});inv. mass (#pi^{+}K^{-}#pi^{+}) (GeV/#it{c}^{2});pool bin", {HistType::kTHnSparseF, {axisDeltaPhi, axisDeltaEta, axisPtD, axisPtHadron, axisMassDBinned, axisPoolBin}});
+    }
+  }
+
+  /// Inv. mass bin of a candidate in the binned correlations, -1 if outside of the mass bins or not passing the ML
+  /// score selection
+  int getBinnedTriggerClass(double invMass, std::vector<float> const& outputMl)
+  {
+    if (outputMl[0] > mlScoreBkgMaxBinned || outputMl[1] < mlScorePromptMinBinned) {
+      return -1;
+    }
+    return BinnedCorrelations::getBin(binsMassDBinned.value, invMass);
+  }
+
+  /// Bins the selected associated tracks of an event for the binned correlations
+  template <typename TTracks>
+  void fillBinnedAssociated(TTracks const& tracks)
+  {
+    binnedCorrelations.clearAssociated();
+    for (const auto& track : tracks) {
+      if (track.isGlobalTrackWoDCA()) {
+        binnedCorrelations.addAssociated(track.phi(), track.eta(), track.pt(), 1., track.globalIndex());
+      }
+    }
   }
 
   /// Dplus-hadron correlation pair builder - for real data and data-like analysis (i.e. reco-level w/o matching request via MC truth)
@@ -316,6 +361,9 @@ struct HfCorrelatorDplusHadrons {
       }
       registry.fill(HIST("hMultiplicity"), nTracks);
 
+      if (fillBinnedCorrelations) {
+        fillBinnedAssociated(tracks);
+      }
       int cntDplus = 0;
       std::vector<float> outputMl = {-1., -1., -1.};
       for (const auto& candidate : candidates) {
@@ -345,6 +393,20 @@ struct HfCorrelatorDplusHadrons {
         entryDplusCandRecoInfo(hfHelper.invMassDplusToPiKPi(candidate), candidate.pt(), outputMl[0], outputMl[1]); // 0: BkgBDTScore, 1:PromptBDTScore
         entryDplus(candidate.phi(), candidate.eta(), candidate.pt(), hfHelper.invMassDplusToPiKPi(candidate), poolBin, gCollisionId, timeStamp);
 
+        if (fillBinnedCorrelations) {
+          int trigClass = getBinnedTriggerClass(hfHelper.invMassDplusToPiKPi(candidate), outputMl);
+          if (removeDaughters) {
+            binnedCorrelations.addTrigger(candidate.phi(), candidate.eta(), candidate.pt(), trigClass, efficiencyWeightD, {candidate.prong0Id(), candidate.prong1Id(), candidate.prong2Id()});
+          } else {
+            binnedCorrelations.addTrigger(candidate.phi(), candidate.eta(), candidate.pt(), trigClass, efficiencyWeightD);
+          }
+          // the track loop is only needed for the hadron table
+          if (cntDplus > 0) {
+            cntDplus++;
+            continue;
+          }
+        }
+
         // Dplus-Hadron correlation dedicated section
         // if the candidate is a Dplus, search for Hadrons and evaluate correlations
         for (const auto& track : tracks) {
@@ -358,14 +420,16 @@ struct HfCorrelatorDplusHadrons {
               continue;
             }
           }
-          entryDplusHadronPair(getDeltaPhi(track.phi(), candidate.phi()),
-                               track.eta() - candidate.eta(),
-                               candidate.pt(),
-                               track.pt(), poolBin);
-          entryDplusHadronRecoInfo(hfHelper.invMassDplusToPiKPi(candidate), false);
-          entryDplusHadronGenInfo(false, false, 0);
-          entryDplusHadronMlInfo(outputMl[0], outputMl[1]);
-          entryTrackRecoInfo(track.dcaXY(), track.dcaZ(), track.tpcNClsCrossedRows());
+          if (!fillBinnedCorrelations) {
+            entryDplusHadronPair(getDeltaPhi(track.phi(), candidate.phi()),
+                                 track.eta() - candidate.eta(),
+                                 candidate.pt(),
+                                 track.pt(), poolBin);
+            entryDplusHadronRecoInfo(hfHelper.invMassDplusToPiKPi(candidate), false);
+            entryDplusHadronGenInfo(false, false, 0);
+            entryDplusHadronMlInfo(outputMl[0], outputMl[1]);
+            entryTrackRecoInfo(track.dcaXY(), track.dcaZ(), track.tpcNClsCrossedRows());
+          }
           if (cntDplus == 0) {
             entryHadron(track.phi(), track.eta(), track.pt(), poolBin, gCollisionId, timeStamp);
             registry.fill(HIST("hTracksBin"), poolBin);
@@ -373,6 +437,12 @@ struct HfCorrelatorDplusHadrons {
         } // Hadron Tracks loop
         cntDplus++;
       } // end outer Dplus loop
+      if (fillBinnedCorrelations) {
+        binnedCorrelations.flush([&](double deltaPhi, double deltaEta, double ptD, double ptHadron, int massBin, double weight) {
+          double massD = 0.5 * (binsMassDBinned->at(massBin) + binsMassDBinned->at(massBin + 1));
+          registry.fill(HIST("hCorrel2DVsPtSameEvent"), deltaPhi, deltaEta, ptD, ptHadron, massD, poolBin, weight);
+        });
+      }
       registry.fill(HIST("hZvtx"), collision.posZ());
       registry.fill(HIST("hMultFT0M"), collision.multFT0M());
     }
@@ -612,6 +682,23 @@ struct HfCorrelatorDplusHadrons {
     for (const auto& [c1, tracks1, c2, tracks2] : pairData) {
       // LOGF(info, "Mixed event collisions: Index = (%d, %d), tracks Size: (%d, %d), Z Vertex: (%f, %f), Pool Bin: (%d, %d)", c1.globalIndex(), c2.globalIndex(), tracks1.size(), tracks2.size(), c1.posZ(), c2.posZ(), corrBinning.getBin(std::make_tuple(c1.posZ(), c1.multFT0M())),corrBinning.getBin(std::make_tuple(c2.posZ(), c2.multFT0M()))); // For debug
       int poolBin = corrBinning.getBin(std::make_tuple(c2.posZ(), c2.multFT0M()));
+      if (fillBinnedCorrelations) {
+        fillBinnedAssociated(tracks2);
+        std::vector<float> outputMl = {-1., -1., -1.};
+        for (const auto& trigDplus : tracks1) {
+          if (std::abs(hfHelper.yDplus(trigDplus)) < yCandMax) {
+            for (unsigned int iclass = 0; iclass < classMl->size(); iclass++) {
+              outputMl[iclass] = trigDplus.mlProbDplusToPiKPi()[classMl->at(iclass)];
+            }
+            binnedCorrelations.addTrigger(trigDplus.phi(), trigDplus.eta(), trigDplus.pt(), getBinnedTriggerClass(hfHelper.invMassDplusToPiKPi(trigDplus), outputMl), 1.);
+          }
+        }
+        binnedCorrelations.flush([&](double deltaPhi, double deltaEta, double ptD, double ptHadron, int massBin, double weight) {
+          double massD = 0.5 * (binsMassDBinned->at(massBin) + binsMassDBinned->at(massBin + 1));
+          registry.fill(HIST("hCorrel2DVsPtMixedEvent"), deltaPhi, deltaEta, ptD, ptHadron, massD, poolBin, weight);
+        });
+        continue;
+      }
       for (const auto& [trigDplus, assocParticle] : o2::soa::combinations(o2::soa::CombinationsFullIndexPolicy(tracks1, tracks2))) {
 
         if (!assocParticle.isGlobalTrackWoDCA() || std::abs(hfHelper.yDplus(trigDplus)) >= yCandMax) {
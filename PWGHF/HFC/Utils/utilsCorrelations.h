@@ -0,0 +1,259 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file utilsCorrelations.h
+/// \brief Binned trigger-associated correlations for the HF correlators
+
+#ifndef PWGHF_HFC_UTILS_UTILSCORRELATIONS_H_
+#define PWGHF_HFC_UTILS_UTILSCORRELATIONS_H_
+
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+#include <vector>
+
+namespace o2::analysis::hf_correlations
+{
+/// Trigger-associated (Δφ, Δη) correlations from binned associated particles.
+///
+/// The associated particles of an event are binned once in (pT, φ, η) with their weights. The correlation of a
+/// trigger is then the associated distribution shifted by the (φ, η) bin of the trigger and added, with the trigger
+/// weight, to the correlations of its pT bin. The daughters of the trigger are subtracted from their bins. The cost
+/// per trigger is the number of occupied bins instead of the number of associated particles, and the same object
+/// serves same-event (associated particles of the trigger event) and mixed-event (associated particles of the
+/// partner event) correlations.
+///
+/// φ is binned in [0, 2π) and Δφ = φ_assoc - φ_trig in the nBinsPhi bins centred on k * 2π / nBinsPhi, for
+/// k in [-nBinsPhi / 4, 3 * nBinsPhi / 4), i.e. in [-π/2, 3π/2) up to half a bin. η is binned in
+/// [-etaAssocMax, etaAssocMax) and Δη = η_assoc - η_trig in bins centred on multiples of the η bin width. The
+/// correlations are those of the pair mode up to the bin width, for the triggers and associated particles inside of
+/// the pT and η binning.
+///
+/// The triggers can be split in classes (e.g. bins of the candidate invariant mass), whose correlations are kept
+/// separately.
+class BinnedCorrelations
+{
+ public:
+  BinnedCorrelations() = default;
+
+  /// \param nBinsPhi number of φ (and Δφ) bins, multiple of 4
+  /// \param nBinsEta number of η bins of the associated particles in [-etaAssocMax, etaAssocMax)
+  /// \param etaTrigMax max. |η| of the triggers, triggers outside are not correlated
+  /// \param binsPtTrig trigger pT bin edges
+  /// \param binsPtAssoc associated pT bin edges
+  /// \param nTrigClasses number of trigger classes
+  void init(int nBinsPhi, int nBinsEta, double etaAssocMax, double etaTrigMax, std::vector<double> const& binsPtTrig, std::vector<double> const& binsPtAssoc, int nTrigClasses = 1)
+  {
+    mNBinsPhi = nBinsPhi;
+    mNBinsEta = nBinsEta;
+    mPhiBinWidth = 2. * M_PI / nBinsPhi;
+    mEtaBinWidth = 2. * etaAssocMax / nBinsEta;
+    mEtaAssocMax = etaAssocMax;
+    mEtaTrigMax = etaTrigMax;
+    mBinsPtTrig = binsPtTrig;
+    mBinsPtAssoc = binsPtAssoc;
+    mNBinsPtTrig = mBinsPtTrig.size() - 1;
+    mNBinsPtAssoc = mBinsPtAssoc.size() - 1;
+    mNTrigClasses = nTrigClasses;
+
+    // trigger η bins on the grid of the associated particles, possibly outside of it
+    mEtaBinTrigMin = getEtaBin(-etaTrigMax);
+    mEtaBinTrigMax = getEtaBin(std::nextafter(etaTrigMax, -etaTrigMax));
+    mNBinsDeltaEta = (mNBinsEta - 1 - mEtaBinTrigMin) + mEtaBinTrigMax + 1;
+
+    mCellSlots.assign(mNBinsPtAssoc * mNBinsPhi * mNBinsEta, -1);
+    mCorrelations.assign(mNTrigClasses * mNBinsPtTrig * mNBinsPtAssoc * mNBinsPhi * mNBinsDeltaEta, 0.);
+    mIsTouched.assign(mCorrelations.size(), false);
+    clearAssociated();
+    mTouched.clear();
+  }
+
+  /// Bin of value in the bin edges bins, -1 if outside
+  static int getBin(std::vector<double> const& bins, double value)
+  {
+    if (!(value >= bins.front() && value < bins.back())) {
+      return -1;
+    }
+    return std::upper_bound(bins.begin(), bins.end(), value) - bins.begin() - 1;
+  }
+
+  int getNBinsDeltaPhi() const { return mNBinsPhi; }
+  double getDeltaPhiMin() const { return -(mNBinsPhi / 4 + 0.5) * mPhiBinWidth; }
+  double getDeltaPhiMax() const { return (3 * mNBinsPhi / 4 - 0.5) * mPhiBinWidth; }
+  int getNBinsDeltaEta() const { return mNBinsDeltaEta; }
+  double getDeltaEtaMin() const { return (-mEtaBinTrigMax - 0.5) * mEtaBinWidth; }
+  double getDeltaEtaMax() const { return (mNBinsEta - 1 - mEtaBinTrigMin + 0.5) * mEtaBinWidth; }
+
+  /// Starts a new set of associated particles (new event)
+  void clearAssociated()
+  {
+    for (const auto& cell : mCells) {
+      mCellSlots[cell.index] = -1;
+    }
+    mCells.clear();
+    mAssocIds.clear();
+    mAssocSlots.clear();
+    mAssocWeights.clear();
+    mAssocIdsSorted = true;
+  }
+
+  /// Adds an associated particle, id is used to remove the daughters of the triggers (e.g. the track global index)
+  /// \return false if the particle is outside of the binning
+  bool addAssociated(double phi, double eta, double pt, double weight, int id)
+  {
+    int ptBin = getBin(mBinsPtAssoc, pt);
+    int etaBin = getEtaBin(eta);
+    if (ptBin < 0 || etaBin < 0 || etaBin >= mNBinsEta) {
+      return false;
+    }
+    int phiBin = getPhiBin(phi);
+    int index = (ptBin * mNBinsPhi + phiBin) * mNBinsEta + etaBin;
+    int slot = mCellSlots[index];
+    if (slot < 0) {
+      slot = mCells.size();
+      mCellSlots[index] = slot;
+      mCells.push_back({index, ptBin, phiBin, etaBin, 0.});
+    }
+    mCells[slot].weight += weight;
+    if (!mAssocIds.empty() && id < mAssocIds.back()) {
+      mAssocIdsSorted = false;
+    }
+    mAssocIds.push_back(id);
+    mAssocSlots.push_back(slot);
+    mAssocWeights.push_back(weight);
+    return true;
+  }
+
+  int getNAssociated() const { return mAssocIds.size(); }
+
+  /// Correlates a trigger of class trigClass with the current associated particles, without the daughters with the
+  /// given ids
+  /// \return false if the trigger is outside of the binning
+  bool addTrigger(double phi, double eta, double pt, int trigClass, double weight, std::initializer_list<int> daughterIds = {})
+  {
+    int ptBin = getBin(mBinsPtTrig, pt);
+    int etaBin = getEtaBin(eta);
+    if (ptBin < 0 || etaBin < mEtaBinTrigMin || etaBin > mEtaBinTrigMax || trigClass < 0 || trigClass >= mNTrigClasses) {
+      return false;
+    }
+    int phiBin = getPhiBin(phi);
+    int offset = (trigClass * mNBinsPtTrig + ptBin) * mNBinsPtAssoc;
+    for (const auto& cell : mCells) {
+      add(offset, cell, phiBin, etaBin, weight * cell.weight);
+    }
+    for (int id : daughterIds) {
+      int iAssoc = findAssociated(id);
+      if (iAssoc >= 0) {
+        add(offset, mCells[mAssocSlots[iAssoc]], phiBin, etaBin, -weight * mAssocWeights[iAssoc]);
+      }
+    }
+    return true;
+  }
+
+  /// Calls f(deltaPhi, deltaEta, ptTrig, ptAssoc, trigClass, content) for the non-empty correlation bins, at the bin
+  /// centres, and resets the correlations
+  template <typename F>
+  void flush(F&& f)
+  {
+    for (int index : mTouched) {
+      double content = mCorrelations[index];
+      if (content != 0.) {
+        int deltaEtaBin = index % mNBinsDeltaEta;
+        int rest = index / mNBinsDeltaEta;
+        int deltaPhiBin = rest % mNBinsPhi;
+        rest /= mNBinsPhi;
+        int ptAssocBin = rest % mNBinsPtAssoc;
+        rest /= mNBinsPtAssoc;
+        int ptTrigBin = rest % mNBinsPtTrig;
+        int trigClass = rest / mNBinsPtTrig;
+        f((deltaPhiBin - mNBinsPhi / 4) * mPhiBinWidth,
+          (deltaEtaBin - mEtaBinTrigMax) * mEtaBinWidth,
+          0.5 * (mBinsPtTrig[ptTrigBin] + mBinsPtTrig[ptTrigBin + 1]),
+          0.5 * (mBinsPtAssoc[ptAssocBin] + mBinsPtAssoc[ptAssocBin + 1]),
+          trigClass,
+          content);
+      }
+      mCorrelations[index] = 0.;
+      mIsTouched[index] = false;
+    }
+    mTouched.clear();
+  }
+
+ private:
+  struct Cell {
+    int index; // in mCellSlots
+    int ptBin;
+    int phiBin;
+    int etaBin;
+    double weight;
+  };
+
+  int getPhiBin(double phi) const
+  {
+    phi -= 2. * M_PI * std::floor(phi / (2. * M_PI));
+    return std::min(static_cast<int>(phi / mPhiBinWidth), mNBinsPhi - 1);
+  }
+
+  int getEtaBin(double eta) const { return static_cast<int>(std::floor((eta + mEtaAssocMax) / mEtaBinWidth)); }
+
+  int findAssociated(int id) const
+  {
+    if (mAssocIdsSorted) {
+      auto found = std::lower_bound(mAssocIds.begin(), mAssocIds.end(), id);
+      return (found != mAssocIds.end() && *found == id) ? found - mAssocIds.begin() : -1;
+    }
+    auto found = std::find(mAssocIds.begin(), mAssocIds.end(), id);
+    return (found != mAssocIds.end()) ? found - mAssocIds.begin() : -1;
+  }
+
+  void add(int trigOffset, Cell const& cell, int phiBinTrig, int etaBinTrig, double weight)
+  {
+    int deltaPhiBin = (cell.phiBin - phiBinTrig + mNBinsPhi + mNBinsPhi / 4) % mNBinsPhi;
+    int deltaEtaBin = cell.etaBin - etaBinTrig + mEtaBinTrigMax;
+    int index = ((trigOffset + cell.ptBin) * mNBinsPhi + deltaPhiBin) * mNBinsDeltaEta + deltaEtaBin;
+    mCorrelations[index] += weight;
+    if (!mIsTouched[index]) {
+      mIsTouched[index] = true;
+      mTouched.push_back(index);
+    }
+  }
+
+  int mNBinsPhi = 0;
+  int mNBinsEta = 0;
+  int mNBinsDeltaEta = 0;
+  int mNBinsPtTrig = 0;
+  int mNBinsPtAssoc = 0;
+  int mNTrigClasses = 1;
+  int mEtaBinTrigMin = 0;
+  int mEtaBinTrigMax = 0;
+  double mPhiBinWidth = 0.;
+  double mEtaBinWidth = 0.;
+  double mEtaAssocMax = 0.;
+  double mEtaTrigMax = 0.;
+  std::vector<double> mBinsPtTrig;
+  std::vector<double> mBinsPtAssoc;
+
+  // associated particles of the current event
+  std::vector<int> mCellSlots; // slot in mCells per (pT, φ, η) bin, -1 if empty
+  std::vector<Cell> mCells;    // occupied bins
+  std::vector<int> mAssocIds;
+  std::vector<int> mAssocSlots;
+  std::vector<double> mAssocWeights;
+  bool mAssocIdsSorted = true;
+
+  // correlations per (trigger class, pT trig, pT assoc, Δφ, Δη) bin, accumulated until flush()
+  std::vector<double> mCorrelations;
+  std::vector<bool> mIsTouched;
+  std::vector<int> mTouched;
+};
+} // namespace o2::analysis::hf_correlations
+
+#endif // PWGHF_HFC_UTILS_UTILSCORRELATIONS_H_
@@ -97,15 +97,22 @@ struct HfCandidateCreator2Prong {
   double massPiK{0.};
   double massKPi{0.};
   double bz{0.};
+  bool isSkimFitReusable{false}; // DCAFitterN configured as in the track-index skim
 
   std::shared_ptr<TH1> hCandidates;
   HistogramRegistry registry{"registry"};
 
-  void init(InitContext const&)
+  void init(InitContext& initContext)
   {
-    std::array<bool, 6> doprocessDF{doprocessPvRefitWithDCAFitterN, doprocessNoPvRefitWithDCAFitterN,
-                                    doprocessPvRefitWithDCAFitterNCentFT0C, doprocessNoPvRefitWithDCAFitterNCentFT0C,
-                                    doprocessPvRefitWithDCAFitterNCentFT0M, doprocessNoPvRefitWithDCAFitterNCentFT0M};
+    std::array<bool, 6> doprocessSkimVertex{doprocessPvRefitWithDCAFitterNSkimVertex, doprocessNoPvRefitWithDCAFitterNSkimVertex,
+                                            doprocessPvRefitWithDCAFitterNSkimVertexCentFT0C, doprocessNoPvRefitWithDCAFitterNSkimVertexCentFT0C,
+                                            doprocessPvRefitWithDCAFitterNSkimVertexCentFT0M, doprocessNoPvRefitWithDCAFitterNSkimVertexCentFT0M};
+    std::array<bool, 12> doprocessDF{doprocessPvRefitWithDCAFitterN, doprocessNoPvRefitWithDCAFitterN,
+                                     doprocessPvRefitWithDCAFitterNCentFT0C, doprocessNoPvRefitWithDCAFitterNCentFT0C,
+                                     doprocessPvRefitWithDCAFitterNCentFT0M, doprocessNoPvRefitWithDCAFitterNCentFT0M,
+                                     doprocessPvRefitWithDCAFitterNSkimVertex, doprocessNoPvRefitWithDCAFitterNSkimVertex,
+                                     doprocessPvRefitWithDCAFitterNSkimVertexCentFT0C, doprocessNoPvRefitWithDCAFitterNSkimVertexCentFT0C,
+                                     doprocessPvRefitWithDCAFitterNSkimVertexCentFT0M, doprocessNoPvRefitWithDCAFitterNSkimVertexCentFT0M};
     std::array<bool, 6> doprocessKF{doprocessPvRefitWithKFParticle, doprocessNoPvRefitWithKFParticle,
                                     doprocessPvRefitWithKFParticleCentFT0C, doprocessNoPvRefitWithKFParticleCentFT0C,
                                     doprocessPvRefitWithKFParticleCentFT0M, doprocessNoPvRefitWithKFParticleCentFT0M};
@@ -119,13 +126,13 @@ struct HfCandidateCreator2Prong {
       LOGP(fatal, "At most one process function for collision monitoring can be enabled at a time.");
     }
     if (nProcessesCollisions == 1) {
-      if ((doprocessPvRefitWithDCAFitterN || doprocessNoPvRefitWithDCAFitterN || doprocessPvRefitWithKFParticle || doprocessNoPvRefitWithKFParticle) && !doprocessCollisions) {
+      if ((doprocessPvRefitWithDCAFitterN || doprocessNoPvRefitWithDCAFitterN || doprocessPvRefitWithDCAFitterNSkimVertex || doprocessNoPvRefitWithDCAFitterNSkimVertex || doprocessPvRefitWithKFParticle || doprocessNoPvRefitWithKFParticle) && !doprocessCollisions) {
         LOGP(fatal, "Process function for collision monitoring not correctly enabled. Did you enable \"processCollisions\"?");
       }
-      if ((doprocessPvRefitWithDCAFitterNCentFT0C || doprocessNoPvRefitWithDCAFitterNCentFT0C || doprocessPvRefitWithKFParticleCentFT0C || doprocessNoPvRefitWithKFParticleCentFT0C) && !doprocessCollisionsCentFT0C) {
+      if ((doprocessPvRefitWithDCAFitterNCentFT0C || doprocessNoPvRefitWithDCAFitterNCentFT0C || doprocessPvRefitWithDCAFitterNSkimVertexCentFT0C || doprocessNoPvRefitWithDCAFitterNSkimVertexCentFT0C || doprocessPvRefitWithKFParticleCentFT0C || doprocessNoPvRefitWithKFParticleCentFT0C) && !doprocessCollisionsCentFT0C) {
         LOGP(fatal, "Process function for collision monitoring not correctly enabled. Did you enable \"processCollisionsCentFT0C\"?");
       }
-      if ((doprocessPvRefitWithDCAFitterNCentFT0M || doprocessNoPvRefitWithDCAFitterNCentFT0M || doprocessPvRefitWithKFParticleCentFT0M || doprocessNoPvRefitWithKFParticleCentFT0M) && !doprocessCollisionsCentFT0M) {
+      if ((doprocessPvRefitWithDCAFitterNCentFT0M || doprocessNoPvRefitWithDCAFitterNCentFT0M || doprocessPvRefitWithDCAFitterNSkimVertexCentFT0M || doprocessNoPvRefitWithDCAFitterNSkimVertexCentFT0M || doprocessPvRefitWithKFParticleCentFT0M || doprocessNoPvRefitWithKFParticleCentFT0M) && !doprocessCollisionsCentFT0M) {
         LOGP(fatal, "Process function for collision monitoring not correctly enabled. Did you enable \"processCollisionsCentFT0M\"?");
       }
     }
@@ -161,6 +168,9 @@ struct HfCandidateCreator2Prong {
       df.setUseAbsDCA(useAbsDCA);
       df.setWeightedFinalPCA(useWeightedFinalPCA);
     }
+    if (std::accumulate(doprocessSkimVertex.begin(), doprocessSkimVertex.end(), 0) == 1) {
+      isSkimFitReusable = isSkimVertexFitReusable(initContext, propagateToPCA, useAbsDCA, useWeightedFinalPCA, maxR, maxDZIni, minParamChange, minRelChi2Change, isRun2);
+    }
     if (std::accumulate(doprocessKF.begin(), doprocessKF.end(), 0) == 1) {
       registry.fill(HIST("hVertexerType"), aod::hf_cand::VertexerType::KfParticle);
     }
@@ -175,7 +185,7 @@ struct HfCandidateCreator2Prong {
     setLabelHistoCands(hCandidates);
   }
 
-  template <bool doPvRefit, o2::hf_centrality::CentralityEstimator centEstimator, typename Coll, typename CandType, typename TTracks>
+  template <bool doPvRefit, o2::hf_centrality::CentralityEstimator centEstimator, bool useSkimVertex = false, typename Coll, typename CandType, typename TTracks>
   void runCreator2ProngWithDCAFitterN(Coll const&,
                                       CandType const& rowsTrackIndexProng2,
                                       TTracks const&,
@@ -212,28 +222,51 @@ struct HfCandidateCreator2Prong {
       }
       df.setBz(bz);
 
-      // reconstruct the 2-prong secondary vertex
+      // reconstruct the 2-prong secondary vertex, unless the fit of the skim was done with the same tracks and configuration
+      // (tracks of other collisions were propagated to the candidate collision in the skim)
+      bool isSkimFit{false};
+      if constexpr (useSkimVertex) {
+        isSkimFit = isSkimFitReusable && track0.collisionId() == collision.globalIndex() && track1.collisionId() == collision.globalIndex();
+      }
       hCandidates->Fill(SVFitting::BeforeFit);
-      try {
-        if (df.process(trackParVarPos1, trackParVarNeg1) == 0) {
+      if (!isSkimFit) {
+        try {
+          if (df.process(trackParVarPos1, trackParVarNeg1) == 0) {
+            continue;
+          }
+        } catch (const std::runtime_error& error) {
+          LOG(info) << "Run time error found: " << error.what() << ". DCAFitterN cannot work, skipping the candidate.";
+          hCandidates->Fill(SVFitting::Fail);
           continue;
         }
-      } catch (const std::runtime_error& error) {
-        LOG(info) << "Run time error found: " << error.what() << ". DCAFitterN cannot work, skipping the candidate.";
-        hCandidates->Fill(SVFitting::Fail);
-        continue;
       }
       hCandidates->Fill(SVFitting::FitOk);
 
-      const auto& secondaryVertex = df.getPCACandidate();
-      auto chi2PCA = df.getChi2AtPCACandidate();
-      auto covMatrixPCA = df.calcPCACovMatrixFlat();
+      std::array<double, 3> secondaryVertex;
+      float chi2PCA;
+      std::array<float, 6> covMatrixPCA;
+      o2::track::TrackParCov trackParVar0;
+      o2::track::TrackParCov trackParVar1;
+      if (isSkimFit) {
+        if constexpr (useSkimVertex) {
+          secondaryVertex = {rowTrackIndexProng2.svX(), rowTrackIndexProng2.svY(), rowTrackIndexProng2.svZ()};
+          chi2PCA = rowTrackIndexProng2.svChi2();
+          std::copy(rowTrackIndexProng2.svCov(), rowTrackIndexProng2.svCov() + covMatrixPCA.size(), covMatrixPCA.begin());
+          trackParVar0 = makeSkimVertexProng(rowTrackIndexProng2.prong0Par(), rowTrackIndexProng2.prong0Cov());
+          trackParVar1 = makeSkimVertexProng(rowTrackIndexProng2.prong1Par(), rowTrackIndexProng2.prong1Cov());
+        }
+      } else {
+        const auto& pca = df.getPCACandidate();
+        secondaryVertex = {pca[0], pca[1], pca[2]};
+        chi2PCA = df.getChi2AtPCACandidate();
+        covMatrixPCA = df.calcPCACovMatrixFlat();
+        trackParVar0 = df.getTrack(0);
+        trackParVar1 = df.getTrack(1);
+      }
       registry.fill(HIST("hCovSVXX"), covMatrixPCA[0]); // FIXME: Calculation of errorDecayLength(XY) gives wrong values without this line.
       registry.fill(HIST("hCovSVYY"), covMatrixPCA[2]);
       registry.fill(HIST("hCovSVXZ"), covMatrixPCA[3]);
       registry.fill(HIST("hCovSVZZ"), covMatrixPCA[5]);
-      auto trackParVar0 = df.getTrack(0);
-      auto trackParVar1 = df.getTrack(1);
 
       // get track momenta
       std::array<float, 3> pvec0;
@@ -611,6 +644,73 @@ struct HfCandidateCreator2Prong {
   }
   PROCESS_SWITCH(HfCandidateCreator2Prong, processNoPvRefitWithKFParticleCentFT0M, "Run candidate creator using KFParticle package w/o PV refit and w/ centrality selection on FT0M", false);
 
+  ////////////////////////////////////////////////////////////
+  ///                                                      ///
+  ///   DCA fitter reusing the secondary-vertex fit of     ///
+  ///   the track-index skim (HfSkimVtx2Prongs)            ///
+  ///                                                      ///
+  ////////////////////////////////////////////////////////////
+
+  /// @brief process function using the skim vertex fit w/ PV refit and w/o centrality selections
+  void processPvRefitWithDCAFitterNSkimVertex(soa::Join<aod::Collisions, aod::EvSels> const& collisions,
+                                              soa::Join<aod::Hf2Prongs, aod::HfPvRefit2Prong, aod::HfSkimVtx2Prongs> const& rowsTrackIndexProng2,
+                                              TracksWCovExtraPidPiKa const& tracks,
+                                              aod::BCsWithTimestamps const& bcWithTimeStamps)
+  {
+    runCreator2ProngWithDCAFitterN</*doPvRefit*/ true, CentralityEstimator::None, /*useSkimVertex*/ true>(collisions, rowsTrackIndexProng2, tracks, bcWithTimeStamps);
+  }
+  PROCESS_SWITCH(HfCandidateCreator2Prong, processPvRefitWithDCAFitterNSkimVertex, "Run candidate creator using the skim vertex fit (DCA fitter if refit needed) w/ PV refit and w/o centrality selections", false);
+
+  /// @brief process function using the skim vertex fit w/o PV refit and w/o centrality selections
+  void processNoPvRefitWithDCAFitterNSkimVertex(soa::Join<aod::Collisions, aod::EvSels> const& collisions,
+                                                soa::Join<aod::Hf2Prongs, aod::HfSkimVtx2Prongs> const& rowsTrackIndexProng2,
+                                                TracksWCovExtraPidPiKa const& tracks,
+                                                aod::BCsWithTimestamps const& bcWithTimeStamps)
+  {
+    runCreator2ProngWithDCAFitterN</*doPvRefit*/ false, CentralityEstimator::None, /*useSkimVertex*/ true>(collisions, rowsTrackIndexProng2, tracks, bcWithTimeStamps);
+  }
+  PROCESS_SWITCH(HfCandidateCreator2Prong, processNoPvRefitWithDCAFitterNSkimVertex, "Run candidate creator using the skim vertex fit (DCA fitter if refit needed) w/o PV refit and w/o centrality selections", false);
+
+  /// @brief process function using the skim vertex fit w/ PV refit and w/ centrality selection on FT0C
+  void processPvRefitWithDCAFitterNSkimVertexCentFT0C(soa::Join<aod::Collisions, aod::EvSels, aod::CentFT0Cs> const& collisions,
+                                                      soa::Join<aod::Hf2Prongs, aod::HfPvRefit2Prong, aod::HfSkimVtx2Prongs> const& rowsTrackIndexProng2,
+                                                      TracksWCovExtraPidPiKa const& tracks,
+                                                      aod::BCsWithTimestamps const& bcWithTimeStamps)
+  {
+    runCreator2ProngWithDCAFitterN</*doPvRefit*/ true, CentralityEstimator::FT0C, /*useSkimVertex*/ true>(collisions, rowsTrackIndexProng2, tracks, bcWithTimeStamps);
+  }
+  PROCESS_SWITCH(HfCandidateCreator2Prong, processPvRefitWithDCAFitterNSkimVertexCentFT0C, "Run candidate creator using the skim vertex fit (DCA fitter if refit needed) w/ PV refit and w/ centrality selection on FT0C", false);
+
+  /// @brief process function using the skim vertex fit w/o PV refit and w/ centrality selection on FT0C
+  void processNoPvRefitWithDCAFitterNSkimVertexCentFT0C(soa::Join<aod::Collisions, aod::EvSels, aod::CentFT0Cs> const& collisions,
+                                                        soa::Join<aod::Hf2Prongs, aod::HfSkimVtx2Prongs> const& rowsTrackIndexProng2,
+                                                        TracksWCovExtraPidPiKa const& tracks,
+                                                        aod::BCsWithTimestamps const& bcWithTimeStamps)
+  {
+    runCreator2ProngWithDCAFitterN</*doPvRefit*/ false, CentralityEstimator::FT0C, /*useSkimVertex*/ true>(collisions, rowsTrackIndexProng2, tracks, bcWithTimeStamps);
+  }
+  PROCESS_SWITCH(HfCandidateCreator2Prong, processNoPvRefitWithDCAFitterNSkimVertexCentFT0C, "Run candidate creator using the skim vertex fit (DCA fitter if refit needed) w/o PV refit and w/ centrality selection on FT0C", false);
+
+  /// @brief process function using the skim vertex fit w/ PV refit and w/ centrality selection on FT0M
+  void processPvRefitWithDCAFitterNSkimVertexCentFT0M(soa::Join<aod::Collisions, aod::EvSels, aod::CentFT0Ms> const& collisions,
+                                                      soa::Join<aod::Hf2Prongs, aod::HfPvRefit2Prong, aod::HfSkimVtx2Prongs> const& rowsTrackIndexProng2,
+                                                      TracksWCovExtraPidPiKa const& tracks,
+                                                      aod::BCsWithTimestamps const& bcWithTimeStamps)
+  {
+    runCreator2ProngWithDCAFitterN</*doPvRefit*/ true, CentralityEstimator::FT0M, /*useSkimVertex*/ true>(collisions, rowsTrackIndexProng2, tracks, bcWithTimeStamps);
+  }
+  PROCESS_SWITCH(HfCandidateCreator2Prong, processPvRefitWithDCAFitterNSkimVertexCentFT0M, "Run candidate creator using the skim vertex fit (DCA fitter if refit needed) w/ PV refit and w/ centrality selection on FT0M", false);
+
+  /// @brief process function using the skim vertex fit w/o PV refit and w/ centrality selection on FT0M
+  void processNoPvRefitWithDCAFitterNSkimVertexCentFT0M(soa::Join<aod::Collisions, aod::EvSels, aod::CentFT0Ms> const& collisions,
+                                                        soa::Join<aod::Hf2Prongs, aod::HfSkimVtx2Prongs> const& rowsTrackIndexProng2,
+                                                        TracksWCovExtraPidPiKa const& tracks,
+                                                        aod::BCsWithTimestamps const& bcWithTimeStamps)
+  {
+    runCreator2ProngWithDCAFitterN</*doPvRefit*/ false, CentralityEstimator::FT0M, /*useSkimVertex*/ true>(collisions, rowsTrackIndexProng2, tracks, bcWithTimeStamps);
+  }
+  PROCESS_SWITCH(HfCandidateCreator2Prong, processNoPvRefitWithDCAFitterNSkimVertexCentFT0M, "Run candidate creator using the skim vertex fit (DCA fitter if refit needed) w/o PV refit and w/ centrality selection on FT0M", false);
+
   ///////////////////////////////////////////////////////////
   ///                                                     ///
   ///   Process functions only for collision monitoring   ///
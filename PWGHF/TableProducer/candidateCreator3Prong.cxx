@@ -80,9 +80,12 @@ struct HfCandidateCreator3Prong {
   double massK{0.};
   double massPiKPi{0.};
   double bz{0.};
+  bool isSkimFitReusable{false}; // DCAFitterN configured as in the track-index skim
 
   using FilteredHf3Prongs = soa::Filtered<aod::Hf3Prongs>;
   using FilteredPvRefitHf3Prongs = soa::Filtered<soa::Join<aod::Hf3Prongs, aod::HfPvRefit3Prong>>;
+  using FilteredSkimVtxHf3Prongs = soa::Filtered<soa::Join<aod::Hf3Prongs, aod::HfSkimVtx3Prongs>>;
+  using FilteredPvRefitSkimVtxHf3Prongs = soa::Filtered<soa::Join<aod::Hf3Prongs, aod::HfPvRefit3Prong, aod::HfSkimVtx3Prongs>>;
 
   // filter candidates
   Filter filterSelected3Prongs = (createDplus && (o2::aod::hf_track_index::hfflag & static_cast<uint8_t>(BIT(aod::hf_cand_3prong::DecayType::DplusToPiKPi))) != static_cast<uint8_t>(0)) || (createDs && (o2::aod::hf_track_index::hfflag & static_cast<uint8_t>(BIT(aod::hf_cand_3prong::DecayType::DsToKKPi))) != static_cast<uint8_t>(0)) || (createLc && (o2::aod::hf_track_index::hfflag & static_cast<uint8_t>(BIT(aod::hf_cand_3prong::DecayType::LcToPKPi))) != static_cast<uint8_t>(0)) || (createXic && (o2::aod::hf_track_index::hfflag & static_cast<uint8_t>(BIT(aod::hf_cand_3prong::DecayType::XicToPKPi))) != static_cast<uint8_t>(0));
@@ -90,11 +93,17 @@ struct HfCandidateCreator3Prong {
   std::shared_ptr<TH1> hCandidates;
   HistogramRegistry registry{"registry"};
 
-  void init(InitContext const&)
+  void init(InitContext& initContext)
   {
-    std::array<bool, 6> processes = {doprocessPvRefit, doprocessNoPvRefit,
-                                     doprocessPvRefitCentFT0C, doprocessNoPvRefitCentFT0C,
-                                     doprocessPvRefitCentFT0M, doprocessNoPvRefitCentFT0M};
+    std::array<bool, 6> processesSkimVertex = {doprocessPvRefitSkimVertex, doprocessNoPvRefitSkimVertex,
+                                               doprocessPvRefitSkimVertexCentFT0C, doprocessNoPvRefitSkimVertexCentFT0C,
+                                               doprocessPvRefitSkimVertexCentFT0M, doprocessNoPvRefitSkimVertexCentFT0M};
+    std::array<bool, 12> processes = {doprocessPvRefit, doprocessNoPvRefit,
+                                      doprocessPvRefitCentFT0C, doprocessNoPvRefitCentFT0C,
+                                      doprocessPvRefitCentFT0M, doprocessNoPvRefitCentFT0M,
+                                      doprocessPvRefitSkimVertex, doprocessNoPvRefitSkimVertex,
+                                      doprocessPvRefitSkimVertexCentFT0C, doprocessNoPvRefitSkimVertexCentFT0C,
+                                      doprocessPvRefitSkimVertexCentFT0M, doprocessNoPvRefitSkimVertexCentFT0M};
     if (std::accumulate(processes.begin(), processes.end(), 0) != 1) {
       LOGP(fatal, "One and only one process function must be enabled at a time.");
     }
@@ -105,13 +114,13 @@ struct HfCandidateCreator3Prong {
       LOGP(fatal, "At most one process function for collision monitoring can be enabled at a time.");
     }
     if (nProcessesCollisions == 1) {
-      if ((doprocessPvRefit || doprocessNoPvRefit) && !doprocessCollisions) {
+      if ((doprocessPvRefit || doprocessNoPvRefit || doprocessPvRefitSkimVertex || doprocessNoPvRefitSkimVertex) && !doprocessCollisions) {
         LOGP(fatal, "Process function for collision monitoring not correctly enabled. Did you enable \"processCollisions\"?");
       }
-      if ((doprocessPvRefitCentFT0C || doprocessNoPvRefitCentFT0C) && !doprocessCollisionsCentFT0C) {
+      if ((doprocessPvRefitCentFT0C || doprocessNoPvRefitCentFT0C || doprocessPvRefitSkimVertexCentFT0C || doprocessNoPvRefitSkimVertexCentFT0C) && !doprocessCollisionsCentFT0C) {
         LOGP(fatal, "Process function for collision monitoring not correctly enabled. Did you enable \"processCollisionsCentFT0C\"?");
       }
-      if ((doprocessPvRefitCentFT0M || doprocessNoPvRefitCentFT0M) && !doprocessCollisionsCentFT0M) {
+      if ((doprocessPvRefitCentFT0M || doprocessNoPvRefitCentFT0M || doprocessPvRefitSkimVertexCentFT0M || doprocessNoPvRefitSkimVertexCentFT0M) && !doprocessCollisionsCentFT0M) {
         LOGP(fatal, "Process function for collision monitoring not correctly enabled. Did you enable \"processCollisionsCentFT0M\"?");
       }
     }
@@ -148,6 +157,9 @@ struct HfCandidateCreator3Prong {
     df.setMinRelChi2Change(minRelChi2Change);
     df.setUseAbsDCA(useAbsDCA);
     df.setWeightedFinalPCA(useWeightedFinalPCA);
+    if (std::accumulate(processesSkimVertex.begin(), processesSkimVertex.end(), 0) == 1) {
+      isSkimFitReusable = isSkimVertexFitReusable(initContext, propagateToPCA, useAbsDCA, useWeightedFinalPCA, maxR, maxDZIni, minParamChange, minRelChi2Change, isRun2);
+    }
 
     ccdb->setURL(ccdbUrl);
     ccdb->setCaching(true);
@@ -159,7 +171,7 @@ struct HfCandidateCreator3Prong {
     setLabelHistoCands(hCandidates);
   }
 
-  template <bool doPvRefit = false, o2::hf_centrality::CentralityEstimator centEstimator, typename Coll, typename Cand>
+  template <bool doPvRefit = false, o2::hf_centrality::CentralityEstimator centEstimator, bool useSkimVertex = false, typename Coll, typename Cand>
   void runCreator3Prong(Coll const&,
                         Cand const& rowsTrackIndexProng3,
                         aod::TracksWCovExtra const&,
@@ -198,29 +210,51 @@ struct HfCandidateCreator3Prong {
       }
       df.setBz(bz);
 
-      // reconstruct the 3-prong secondary vertex
+      // reconstruct the 3-prong secondary vertex, unless the fit of the skim was done with the same tracks and configuration
+      // (tracks of other collisions were propagated to the candidate collision in the skim)
+      bool isSkimFit{false};
+      if constexpr (useSkimVertex) {
+        isSkimFit = isSkimFitReusable && track0.collisionId() == collision.globalIndex() && track1.collisionId() == collision.globalIndex() && track2.collisionId() == collision.globalIndex();
+      }
       hCandidates->Fill(SVFitting::BeforeFit);
-      try {
-        if (df.process(trackParVar0, trackParVar1, trackParVar2) == 0) {
+      if (!isSkimFit) {
+        try {
+          if (df.process(trackParVar0, trackParVar1, trackParVar2) == 0) {
+            continue;
+          }
+        } catch (const std::runtime_error& error) {
+          LOG(info) << "Run time error found: " << error.what() << ". DCAFitterN cannot work, skipping the candidate.";
+          hCandidates->Fill(SVFitting::Fail);
           continue;
         }
-      } catch (const std::runtime_error& error) {
-        LOG(info) << "Run time error found: " << error.what() << ". DCAFitterN cannot work, skipping the candidate.";
-        hCandidates->Fill(SVFitting::Fail);
-        continue;
       }
       hCandidates->Fill(SVFitting::FitOk);
 
-      const auto& secondaryVertex = df.getPCACandidate();
-      auto chi2PCA = df.getChi2AtPCACandidate();
-      auto covMatrixPCA = df.calcPCACovMatrixFlat();
+      std::array<double, 3> secondaryVertex;
+      float chi2PCA;
+      std::array<float, 6> covMatrixPCA;
+      if (isSkimFit) {
+        if constexpr (useSkimVertex) {
+          secondaryVertex = {rowTrackIndexProng3.svX(), rowTrackIndexProng3.svY(), rowTrackIndexProng3.svZ()};
+          chi2PCA = rowTrackIndexProng3.svChi2();
+          std::copy(rowTrackIndexProng3.svCov(), rowTrackIndexProng3.svCov() + covMatrixPCA.size(), covMatrixPCA.begin());
+          trackParVar0 = makeSkimVertexProng(rowTrackIndexProng3.prong0Par(), rowTrackIndexProng3.prong0Cov());
+          trackParVar1 = makeSkimVertexProng(rowTrackIndexProng3.prong1Par(), rowTrackIndexProng3.prong1Cov());
+          trackParVar2 = makeSkimVertexProng(rowTrackIndexProng3.prong2Par(), rowTrackIndexProng3.prong2Cov());
+        }
+      } else {
+        const auto& pca = df.getPCACandidate();
+        secondaryVertex = {pca[0], pca[1], pca[2]};
+        chi2PCA = df.getChi2AtPCACandidate();
+        covMatrixPCA = df.calcPCACovMatrixFlat();
+        trackParVar0 = df.getTrack(0);
+        trackParVar1 = df.getTrack(1);
+        trackParVar2 = df.getTrack(2);
+      }
       registry.fill(HIST("hCovSVXX"), covMatrixPCA[0]); // FIXME: Calculation of errorDecayLength(XY) gives wrong values without this line.
       registry.fill(HIST("hCovSVYY"), covMatrixPCA[2]);
       registry.fill(HIST("hCovSVXZ"), covMatrixPCA[3]);
       registry.fill(HIST("hCovSVZZ"), covMatrixPCA[5]);
-      trackParVar0 = df.getTrack(0);
-      trackParVar1 = df.getTrack(1);
-      trackParVar2 = df.getTrack(2);
 
       // get track momenta
       std::array<float, 3> pvec0;
@@ -389,6 +423,73 @@ struct HfCandidateCreator3Prong {
   }
   PROCESS_SWITCH(HfCandidateCreator3Prong, processNoPvRefitCentFT0M, "Run candidate creator without PV refit and  w/ centrality selection on FT0M", false);
 
+  ////////////////////////////////////////////////////////////
+  ///                                                      ///
+  ///   Reusing the secondary-vertex fit of the            ///
+  ///   track-index skim (HfSkimVtx3Prongs)                ///
+  ///                                                      ///
+  ////////////////////////////////////////////////////////////
+
+  /// @brief process function using the skim vertex fit w/ PV refit and w/o centrality selections
+  void processPvRefitSkimVertex(soa::Join<aod::Collisions, aod::EvSels> const& collisions,
+                                FilteredPvRefitSkimVtxHf3Prongs const& rowsTrackIndexProng3,
+                                aod::TracksWCovExtra const& tracks,
+                                aod::BCsWithTimestamps const& bcWithTimeStamps)
+  {
+    runCreator3Prong</*doPvRefit*/ true, CentralityEstimator::None, /*useSkimVertex*/ true>(collisions, rowsTrackIndexProng3, tracks, bcWithTimeStamps);
+  }
+  PROCESS_SWITCH(HfCandidateCreator3Prong, processPvRefitSkimVertex, "Run candidate creator using the skim vertex fit (refit if needed) w/ PV refit and w/o centrality selections", false);
+
+  /// @brief process function using the skim vertex fit w/o PV refit and w/o centrality selections
+  void processNoPvRefitSkimVertex(soa::Join<aod::Collisions, aod::EvSels> const& collisions,
+                                  FilteredSkimVtxHf3Prongs const& rowsTrackIndexProng3,
+                                  aod::TracksWCovExtra const& tracks,
+                                  aod::BCsWithTimestamps const& bcWithTimeStamps)
+  {
+    runCreator3Prong</*doPvRefit*/ false, CentralityEstimator::None, /*useSkimVertex*/ true>(collisions, rowsTrackIndexProng3, tracks, bcWithTimeStamps);
+  }
+  PROCESS_SWITCH(HfCandidateCreator3Prong, processNoPvRefitSkimVertex, "Run candidate creator using the skim vertex fit (refit if needed) w/o PV refit and w/o centrality selections", false);
+
+  /// @brief process function using the skim vertex fit w/ PV refit and w/ centrality selection on FT0C
+  void processPvRefitSkimVertexCentFT0C(soa::Join<aod::Collisions, aod::EvSels, aod::CentFT0Cs> const& collisions,
+                                        FilteredPvRefitSkimVtxHf3Prongs const& rowsTrackIndexProng3,
+                                        aod::TracksWCovExtra const& tracks,
+                                        aod::BCsWithTimestamps const& bcWithTimeStamps)
+  {
+    runCreator3Prong</*doPvRefit*/ true, CentralityEstimator::FT0C, /*useSkimVertex*/ true>(collisions, rowsTrackIndexProng3, tracks, bcWithTimeStamps);
+  }
+  PROCESS_SWITCH(HfCandidateCreator3Prong, processPvRefitSkimVertexCentFT0C, "Run candidate creator using the skim vertex fit (refit if needed) w/ PV refit and w/ centrality selection on FT0C", false);
+
+  /// @brief process function using the skim vertex fit w/o PV refit and w/ centrality selection on FT0C
+  void processNoPvRefitSkimVertexCentFT0C(soa::Join<aod::Collisions, aod::EvSels, aod::CentFT0Cs> const& collisions,
+                                          FilteredSkimVtxHf3Prongs const& rowsTrackIndexProng3,
+                                          aod::TracksWCovExtra const& tracks,
+                                          aod::BCsWithTimestamps const& bcWithTimeStamps)
+  {
+    runCreator3Prong</*doPvRefit*/ false, CentralityEstimator::FT0C, /*useSkimVertex*/ true>(collisions, rowsTrackIndexProng3, tracks, bcWithTimeStamps);
+  }
+  PROCESS_SWITCH(HfCandidateCreator3Prong, processNoPvRefitSkimVertexCentFT0C, "Run candidate creator using the skim vertex fit (refit if needed) w/o PV refit and w/ centrality selection on FT0C", false);
+
+  /// @brief process function using the skim vertex fit w/ PV refit and w/ centrality selection on FT0M
+  void processPvRefitSkimVertexCentFT0M(soa::Join<aod::Collisions, aod::EvSels, aod::CentFT0Ms> const& collisions,
+                                        FilteredPvRefitSkimVtxHf3Prongs const& rowsTrackIndexProng3,
+                                        aod::TracksWCovExtra const& tracks,
+                                        aod::BCsWithTimestamps const& bcWithTimeStamps)
+  {
+    runCreator3Prong</*doPvRefit*/ true, CentralityEstimator::FT0M, /*useSkimVertex*/ true>(collisions, rowsTrackIndexProng3, tracks, bcWithTimeStamps);
+  }
+  PROCESS_SWITCH(HfCandidateCreator3Prong, processPvRefitSkimVertexCentFT0M, "Run candidate creator using the skim vertex fit (refit if needed) w/ PV refit and w/ centrality selection on FT0M", false);
+
+  /// @brief process function using the skim vertex fit w/o PV refit and w/ centrality selection on FT0M
+  void processNoPvRefitSkimVertexCentFT0M(soa::Join<aod::Collisions, aod::EvSels, aod::CentFT0Ms> const& collisions,
+                                          FilteredSkimVtxHf3Prongs const& rowsTrackIndexProng3,
+                                          aod::TracksWCovExtra const& tracks,
+                                          aod::BCsWithTimestamps const& bcWithTimeStamps)
+  {
+    runCreator3Prong</*doPvRefit*/ false, CentralityEstimator::FT0M, /*useSkimVertex*/ true>(collisions, rowsTrackIndexProng3, tracks, bcWithTimeStamps);
+  }
+  PROCESS_SWITCH(HfCandidateCreator3Prong, processNoPvRefitSkimVertexCentFT0M, "Run candidate creator using the skim vertex fit (refit if needed) w/o PV refit and w/ centrality selection on FT0M", false);
+
   ///////////////////////////////////////////////////////////
   ///                                                     ///
   ///   Process functions only for collision monitoring   ///
@@ -38,6 +38,7 @@
 #include "ReconstructionDataFormats/V0.h"
 #include "ReconstructionDataFormats/Vertex.h" // for PV refit
 
+#include "Common/Core/TableHelper.h"
 #include "Common/Core/TrackSelectorPID.h"
 #include "Common/Core/trackUtilities.h"
 #include "Common/DataModel/Centrality.h"
@@ -53,6 +54,7 @@
 #include "PWGHF/Utils/utilsAnalysis.h"
 #include "PWGHF/Utils/utilsBfieldCCDB.h"
 #include "PWGHF/Utils/utilsEvSelHf.h"
+#include "PWGHF/Utils/utilsTrkCandHf.h"
 
 using namespace o2;
 using namespace o2::analysis;
@@ -1127,6 +1129,9 @@ struct HfTrackIndexSkimCreator {
   // Tables with ML scores for HF Filters
   Produces<aod::Hf2ProngMlProbs> rowTrackIndexMlScoreProng2;
   Produces<aod::Hf3ProngMlProbs> rowTrackIndexMlScoreProng3;
+  // secondary-vertex fits, filled only if required by a candidate creator
+  Produces<aod::HfSkimVtx2Prongs> rowProng2SkimVertex;
+  Produces<aod::HfSkimVtx3Prongs> rowProng3SkimVertex;
 
   struct : ConfigurableGroup {
     Configurable<bool> isRun2{"isRun2", false, "enable Run 2 or Run 3 GRP objects for magnetic field"};
@@ -1209,6 +1214,8 @@ struct HfTrackIndexSkimCreator {
   o2::base::MatLayerCylSet* lut;
   o2::base::Propagator::MatCorrType noMatCorr = o2::base::Propagator::MatCorrType::USEMatCorrNONE;
   int runNumber;
+  bool fillSkimVertex2Prong{false};
+  bool fillSkimVertex3Prong{false};
 
   double massPi{0.};
   double massK{0.};
@@ -1266,12 +1273,15 @@ struct HfTrackIndexSkimCreator {
 
   HistogramRegistry registry{"registry"};
 
-  void init(InitContext const&)
+  void init(InitContext& initContext)
   {
     if (!doprocess2And3ProngsWithPvRefit && !doprocess2And3ProngsNoPvRefit) {
       return;
     }
 
+    fillSkimVertex2Prong = isTableRequiredInWorkflow(initContext, "HfSkimVtx2Prongs");
+    fillSkimVertex3Prong = isTableRequiredInWorkflow(initContext, "HfSkimVtx3Prongs");
+
     massPi = o2::constants::physics::MassPiPlus;
     massK = o2::constants::physics::MassKPlus;
     massProton = o2::constants::physics::MassProton;
@@ -1696,6 +1706,28 @@ struct HfTrackIndexSkimCreator {
     }
   }
 
+  /// Method to store the secondary-vertex fit of the last filled candidate, to be reused by the candidate creators
+  /// \param fitter is the DCAFitterN after a successful fit
+  /// \param cursor is the cursor of the skim vertex table
+  template <int nProngs, typename TFitter, typename TCursor>
+  void fillSkimVertex(TFitter& fitter, TCursor& cursor)
+  {
+    const auto& secondaryVertex = fitter.getPCACandidate();
+    auto covMatrixPCA = fitter.calcPCACovMatrixFlat();
+    float prongPar[nProngs][7];
+    float prongCov[nProngs][15];
+    for (int iProng = 0; iProng < nProngs; iProng++) {
+      o2::hf_trkcandsel::getSkimVertexProng(fitter.getTrack(iProng), prongPar[iProng], prongCov[iProng]);
+    }
+    if constexpr (nProngs == 2) {
+      cursor(secondaryVertex[0], secondaryVertex[1], secondaryVertex[2], covMatrixPCA.data(), fitter.getChi2AtPCACandidate(),
+             prongPar[0], prongCov[0], prongPar[1], prongCov[1]);
+    } else {
+      cursor(secondaryVertex[0], secondaryVertex[1], secondaryVertex[2], covMatrixPCA.data(), fitter.getChi2AtPCACandidate(),
+             prongPar[0], prongCov[0], prongPar[1], prongCov[1], prongPar[2], prongCov[2]);
+    }
+  }
+
   /// Method to perform selections for 2-prong candidates after vertex reconstruction
   /// \param secVtx is the secondary vertex
   /// \param primVtx is the primary vertex
@@ -2255,6 +2287,9 @@ struct HfTrackIndexSkimCreator {
                 if (isSelected2ProngCand > 0) {
                   // fill table row
                   rowTrackIndexProng2(thisCollId, trackPos1.globalIndex(), trackNeg1.globalIndex(), isSelected2ProngCand);
+                  if (fillSkimVertex2Prong) {
+                    fillSkimVertex<2>(df2, rowProng2SkimVertex);
+                  }
                   if (config.applyMlForHfFilters) {
                     rowTrackIndexMlScoreProng2(mlScoresD0);
                   }
@@ -2515,6 +2550,9 @@ struct HfTrackIndexSkimCreator {
 
               // fill table row
               rowTrackIndexProng3(thisCollId, trackPos1.globalIndex(), trackNeg1.globalIndex(), trackPos2.globalIndex(), isSelected3ProngCand);
+              if (fillSkimVertex3Prong) {
+                fillSkimVertex<3>(df3, rowProng3SkimVertex);
+              }
               if (config.applyMlForHfFilters) {
                 rowTrackIndexMlScoreProng3(mlScores3Prongs[0], mlScores3Prongs[1], mlScores3Prongs[2], mlScores3Prongs[3]);
               }
@@ -2760,6 +2798,9 @@ struct HfTrackIndexSkimCreator {
 
               // fill table row
               rowTrackIndexProng3(thisCollId, trackNeg1.globalIndex(), trackPos1.globalIndex(), trackNeg2.globalIndex(), isSelected3ProngCand);
+              if (fillSkimVertex3Prong) {
+                fillSkimVertex<3>(df3, rowProng3SkimVertex);
+              }
               if (config.applyMlForHfFilters) {
                 rowTrackIndexMlScoreProng3(mlScores3Prongs[0], mlScores3Prongs[1], mlScores3Prongs[2], mlScores3Prongs[3]);
               }
@@ -16,7 +16,15 @@
 #ifndef PWGHF_UTILS_UTILSTRKCANDHF_H_
 #define PWGHF_UTILS_UTILSTRKCANDHF_H_
 
+#include <array>
+#include <string>
+
 #include "Framework/HistogramSpec.h"
+#include "Framework/InitContext.h"
+#include "Framework/Logger.h"
+#include "ReconstructionDataFormats/Track.h"
+
+#include "Common/Core/TableHelper.h"
 
 namespace o2::hf_trkcandsel
 {
@@ -41,6 +49,67 @@ void setLabelHistoCands(Histo& hCandidates)
   hCandidates->GetXaxis()->SetBinLabel(SVFitting::Fail + 1, "Run-time error in secondary vertexing");
 }
 
+/// @brief Function to store a prong of a secondary-vertex fit in the skim vertex tables
+/// \param track is the prong at the PCA
+/// \param par is the array of 7 parameters (x, alpha, y, z, snp, tgl, q/pt)
+/// \param cov is the array of 15 covariance matrix elements
+template <typename TTrackParCov>
+void getSkimVertexProng(TTrackParCov const& track, float* par, float* cov)
+{
+  par[0] = track.getX();
+  par[1] = track.getAlpha();
+  for (int i = 0; i < o2::track::kNParams; i++) {
+    par[i + 2] = track.getParam(i);
+  }
+  for (int i = 0; i < o2::track::kCovMatSize; i++) {
+    cov[i] = track.getCov()[i];
+  }
+}
+
+/// @brief Function to restore a prong of a secondary-vertex fit from the skim vertex tables, as stored by getSkimVertexProng
+inline o2::track::TrackParCov makeSkimVertexProng(const float* par, const float* cov)
+{
+  std::array<float, o2::track::kNParams> arrayPar;
+  std::array<float, o2::track::kCovMatSize> arrayCov;
+  for (int i = 0; i < o2::track::kNParams; i++) {
+    arrayPar[i] = par[i + 2];
+  }
+  for (int i = 0; i < o2::track::kCovMatSize; i++) {
+    arrayCov[i] = cov[i];
+  }
+  return o2::track::TrackParCov(par[0], par[1], arrayPar, arrayCov);
+}
+
+/// @brief Function to check whether a candidate creator can reuse the secondary-vertex fits of the track-index skim,
+/// i.e. whether the DCAFitterN of the skim in the workflow is configured as the one of the creator
+/// \return false if the configurations differ or if the skim is not in the workflow, in which case the candidates are refitted
+inline bool isSkimVertexFitReusable(o2::framework::InitContext& initContext, bool propagateToPCA, bool useAbsDCA, bool useWeightedFinalPCA,
+                                    double maxR, double maxDZIni, double minParamChange, double minRelChi2Change, bool isRun2)
+{
+  const std::string skimTask = "hf-track-index-skim-creator";
+  bool skimPropagateToPCA{false}, skimUseAbsDCA{false}, skimUseWeightedFinalPCA{false}, skimIsRun2{false};
+  double skimMaxR{0.}, skimMaxDZIni{0.}, skimMinParamChange{0.}, skimMinRelChi2Change{0.};
+  if (!getTaskOptionValue(initContext, skimTask, "propagateToPCA", skimPropagateToPCA, false) ||
+      !getTaskOptionValue(initContext, skimTask, "useAbsDCA", skimUseAbsDCA, false) ||
+      !getTaskOptionValue(initContext, skimTask, "useWeightedFinalPCA", skimUseWeightedFinalPCA, false) ||
+      !getTaskOptionValue(initContext, skimTask, "maxR", skimMaxR, false) ||
+      !getTaskOptionValue(initContext, skimTask, "maxDZIni", skimMaxDZIni, false) ||
+      !getTaskOptionValue(initContext, skimTask, "minParamChange", skimMinParamChange, false) ||
+      !getTaskOptionValue(initContext, skimTask, "minRelChi2Change", skimMinRelChi2Change, false) ||
+      !getTaskOptionValue(initContext, skimTask, "isRun2", skimIsRun2, false)) {
+    LOGP(warning, "DCAFitterN configuration of {} not found in the workflow, the candidates are refitted", skimTask);
+    return false;
+  }
+  if (skimPropagateToPCA != propagateToPCA || skimUseAbsDCA != useAbsDCA || skimUseWeightedFinalPCA != useWeightedFinalPCA ||
+      skimMaxR != maxR || skimMaxDZIni != maxDZIni || skimMinParamChange != minParamChange || skimMinRelChi2Change != minRelChi2Change ||
+      skimIsRun2 != isRun2) {
+    LOGP(info, "DCAFitterN configuration differs from the one of {}, the candidates are refitted", skimTask);
+    return false;
+  }
+  LOGP(info, "Secondary-vertex fits of {} are reused", skimTask);
+  return true;
+}
+
 } // namespace o2::hf_trkcandsel
 
 #endif // PWGHF_UTILS_UTILSTRKCANDHF_H_
@@ -12,6 +12,7 @@
 // jet finder task
 //
 // Author: Hadi Hassan, Universiy of Jväskylä, hadi.hassan@cern.ch
+#include <algorithm>
 #include <memory>
 #include <tuple>
 #include "Framework/Logger.h"
@@ -91,6 +92,153 @@ std::tuple<double, double> JetBkgSubUtils::estimateRhoAreaMedian(const std::vect
   return std::make_tuple(rho, rhoM);
 }
 
+void JetBkgSubUtils::clusterEventForRhoAreaMedian(const std::vector<fastjet::PseudoJet>& inputParticles)
+{
+  JetBkgSubUtils::initialise();
+
+  rhoEventJets.clear();
+  rhoEventJetAreas.clear();
+  rhoEventJetMds.clear();
+  rhoEventJetNParticles.clear();
+  rhoEventJetConstituents.clear();
+  rhoEventTrackJets.clear();
+  if (inputParticles.size() == 0) {
+    return;
+  }
+
+  // cluster the kT jets, the acceptance selection is applied per candidate since the removed tracks change the jets
+  fastjet::ClusterSequenceArea clusterSeq(inputParticles, jetDefBkg, areaDefBkg);
+  std::vector<fastjet::PseudoJet> alljets = clusterSeq.inclusive_jets();
+
+  for (auto& ijet : alljets) {
+    int jetIndex = rhoEventJets.size();
+    int nParticles = 0;
+    std::vector<fastjet::PseudoJet> constituents = ijet.constituents(); // the explicit ghosts are kept for reclustering the jet per candidate
+    for (auto& constituent : constituents) {
+      if (clusterSeq.is_pure_ghost(constituent)) {
+        continue;
+      }
+      nParticles++;
+      if (constituent.has_user_info() && constituent.user_info<fastjetutilities::fastjet_user_info>().getStatus() == static_cast<int>(JetConstituentStatus::track)) {
+        rhoEventTrackJets[constituent.user_info<fastjetutilities::fastjet_user_info>().getIndex()] = jetIndex;
+      }
+    }
+    rhoEventJets.emplace_back(ijet.px(), ijet.py(), ijet.pz(), ijet.E());
+    rhoEventJets.back().set_user_index(jetIndex);
+    rhoEventJetAreas.push_back(ijet.area());
+    rhoEventJetMds.push_back(getMd(ijet));
+    rhoEventJetNParticles.push_back(nParticles);
+    rhoEventJetConstituents.push_back(std::move(constituents));
+  }
+}
+
+std::tuple<double, double> JetBkgSubUtils::estimateRhoAreaMedianWithoutTracks(const std::vector<int>& excludedTracks, bool doSparseSub)
+{
+  rhoCandidateJets.clear();
+  rhoCandidateJetAreas.clear();
+  rhoCandidateJetMds.clear();
+  rhoCandidateJetNParticles.clear();
+
+  // find the jets containing the tracks
+  std::vector<bool> isJetAffected(rhoEventJets.size(), false);
+  bool anyJetAffected = false;
+  for (auto excludedTrack : excludedTracks) {
+    auto found = rhoEventTrackJets.find(excludedTrack);
+    if (found == rhoEventTrackJets.end()) {
+      continue; // not in the input particles
+    }
+    isJetAffected[found->second] = true;
+    anyJetAffected = true;
+  }
+
+  // the jets without the tracks are reused as they are
+  for (std::size_t jetIndex = 0; jetIndex < rhoEventJets.size(); jetIndex++) {
+    if (isJetAffected[jetIndex]) {
+      continue;
+    }
+    rhoCandidateJets.push_back(rhoEventJets[jetIndex]);
+    rhoCandidateJets.back().set_user_index(rhoCandidateJets.size() - 1);
+    rhoCandidateJetAreas.push_back(rhoEventJetAreas[jetIndex]);
+    rhoCandidateJetMds.push_back(rhoEventJetMds[jetIndex]);
+    rhoCandidateJetNParticles.push_back(rhoEventJetNParticles[jetIndex]);
+  }
+
+  // recluster the constituents and ghosts of the jets with the tracks, without the tracks
+  if (anyJetAffected) {
+    std::vector<fastjet::PseudoJet> localParticles;
+    for (std::size_t jetIndex = 0; jetIndex < rhoEventJets.size(); jetIndex++) {
+      if (!isJetAffected[jetIndex]) {
+        continue;
+      }
+      for (auto& constituent : rhoEventJetConstituents[jetIndex]) {
+        if (constituent.has_user_info() && constituent.user_info<fastjetutilities::fastjet_user_info>().getStatus() == static_cast<int>(JetConstituentStatus::track) && std::find(excludedTracks.begin(), excludedTracks.end(), constituent.user_info<fastjetutilities::fastjet_user_info>().getIndex()) != excludedTracks.end()) {
+          continue;
+        }
+        localParticles.push_back(constituent);
+      }
+    }
+
+    // the ghosts are the only constituents without user info, the area of a jet is the number of its ghosts times the ghost area
+    double ghostArea = areaDefBkg.ghost_spec().actual_ghost_area();
+    fastjet::ClusterSequence localClusterSeq(localParticles, jetDefBkg);
+    for (auto& ijet : localClusterSeq.inclusive_jets()) {
+      int nParticles = 0;
+      int nGhosts = 0;
+      for (auto& constituent : ijet.constituents()) {
+        if (constituent.has_user_info()) {
+          nParticles++;
+        } else {
+          nGhosts++;
+        }
+      }
+      rhoCandidateJets.emplace_back(ijet.px(), ijet.py(), ijet.pz(), ijet.E());
+      rhoCandidateJets.back().set_user_index(rhoCandidateJets.size() - 1);
+      rhoCandidateJetAreas.push_back(nGhosts * ghostArea);
+      rhoCandidateJetMds.push_back(getMd(ijet));
+      rhoCandidateJetNParticles.push_back(nParticles);
+    }
+  }
+
+  // select jets in detector acceptance
+  std::vector<fastjet::PseudoJet> alljets = selRho(rhoCandidateJets);
+
+  double totaljetAreaPhys(0), totalAreaCovered(0);
+  std::vector<double> rhovector;
+  std::vector<double> rhoMdvector;
+
+  // Fill a vector for pT/area to be used for the median
+  for (auto& ijet : alljets) {
+    int jetIndex = ijet.user_index();
+    double area = rhoCandidateJetAreas[jetIndex];
+
+    // Physical area/ Physical jets (no ghost)
+    if (rhoCandidateJetNParticles[jetIndex] > 0) {
+      rhovector.push_back(ijet.perp() / area);
+      rhoMdvector.push_back(rhoCandidateJetMds[jetIndex] / area);
+
+      totaljetAreaPhys += area;
+    }
+    // Full area
+    totalAreaCovered += area;
+  }
+
+  double rho = 0.0;
+  double rhoM = 0.0;
+  if (rhovector.size() != 0) {
+    rho = TMath::Median<double>(rhovector.size(), rhovector.data());
+    rhoM = TMath::Median<double>(rhoMdvector.size(), rhoMdvector.data());
+  }
+
+  if (doSparseSub) {
+    // calculate The ocupancy factor, which the ratio of covered area / total area
+    double occupancyFactor = totalAreaCovered > 0 ? totaljetAreaPhys / totalAreaCovered : 1.;
+    rho *= occupancyFactor;
+    rhoM *= occupancyFactor;
+  }
+
+  return std::make_tuple(rho, rhoM);
+}
+
 std::tuple<double, double> JetBkgSubUtils::estimateRhoPerpCone(const std::vector<fastjet::PseudoJet>& inputParticles, const std::vector<fastjet::PseudoJet>& jets)
 {
 
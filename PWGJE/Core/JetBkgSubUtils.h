@@ -20,6 +20,7 @@
 #include <string>
 #include <memory>
 #include <tuple>
+#include <unordered_map>
 #include <vector>
 #include <TMath.h>
 
@@ -75,6 +76,19 @@ class JetBkgSubUtils
   /// @return Rho, RhoM the underlying event density
   std::tuple<double, double> estimateRhoAreaMedian(const std::vector<fastjet::PseudoJet>& inputParticles, bool doSparseSub);
 
+  /// @brief Clusters the event once with the kT algorithm, for estimating rho per candidate with estimateRhoAreaMedianWithoutTracks
+  /// @param inputParticles (all particles in the event, including the daughters of all the candidates)
+  void clusterEventForRhoAreaMedian(const std::vector<fastjet::PseudoJet>& inputParticles);
+
+  /// @brief Median method on the event given to clusterEventForRhoAreaMedian, with some tracks (e.g. the daughters of a candidate) removed
+  /// Only the kT jets containing the removed tracks are reclustered, from their remaining constituents and explicit ghosts, while all
+  /// the other jets are reused, instead of reclustering the whole event for each candidate. The remaining constituents can only be
+  /// reassigned among the reclustered jets, so rho is not guaranteed to be identical to estimateRhoAreaMedian on the event without the tracks
+  /// @param excludedTracks global indices of the tracks to remove
+  /// @param doSparseSub weather to do rho sparse subtraction
+  /// @return Rho, RhoM the underlying event density
+  std::tuple<double, double> estimateRhoAreaMedianWithoutTracks(const std::vector<int>& excludedTracks, bool doSparseSub);
+
   /// @brief Background estimator using the perpendicular cone method
   /// @param inputParticles
   /// @param jets (all jets in the event)
@@ -163,6 +177,18 @@ class JetBkgSubUtils
   fastjet::AreaDefinition areaDefBkg = fastjet::AreaDefinition(fastjet::active_area_explicit_ghosts, ghostAreaSpec);
   fastjet::Selector selRho = fastjet::Selector();
 
+  // kT jets of the event clustered by clusterEventForRhoAreaMedian, the user index of a jet is its position
+  std::vector<fastjet::PseudoJet> rhoEventJets;
+  std::vector<double> rhoEventJetAreas;
+  std::vector<double> rhoEventJetMds;
+  std::vector<int> rhoEventJetNParticles;                             // constituents which are not ghosts
+  std::vector<std::vector<fastjet::PseudoJet>> rhoEventJetConstituents; // including the explicit ghosts
+  std::unordered_map<int, int> rhoEventTrackJets;                     // jet per track global index
+  std::vector<fastjet::PseudoJet> rhoCandidateJets;                   // buffers for the jets per candidate
+  std::vector<double> rhoCandidateJetAreas;
+  std::vector<double> rhoCandidateJetMds;
+  std::vector<int> rhoCandidateJetNParticles;
+
 }; // class JetBkgSubUtils
 
 #endif // PWGJE_CORE_JETBKGSUBUTILS_H_
@@ -157,6 +157,25 @@ bool isDaughterTrack(T& track, U& candidate, V const& tracks)
   }
 }
 
+/**
+ * fills the global indices of the daughter tracks of the candidate, to be used instead of checking every track with isDaughterTrack
+ *
+ * @param candidate candidate whose daughters are filled
+ * @param tracks the track table
+ * @param daughterTrackIds vector which is filled with the global indices of the daughter tracks
+ */
+template <typename T, typename U>
+void fillDaughterTrackIds(T& candidate, U const& tracks, std::vector<int>& daughterTrackIds)
+{
+  if constexpr (jethfutilities::isHFCandidate<T>()) {
+    jethfutilities::fillHFDaughterTrackIds(candidate, tracks, daughterTrackIds);
+  } else if constexpr (jetv0utilities::isV0Candidate<T>()) {
+    jetv0utilities::fillV0DaughterTrackIds(candidate, tracks, daughterTrackIds);
+  } else if constexpr (jetdqutilities::isDielectronCandidate<T>()) {
+    jetdqutilities::fillDielectronDaughterTrackIds(candidate, tracks, daughterTrackIds);
+  }
+}
+
 /**
  * returns true if the particle has any daughters with the given global index
  *
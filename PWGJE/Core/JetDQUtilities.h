@@ -120,6 +120,22 @@ bool isDielectronDaughterTrack(T& track, U& candidate, V const& /*tracks*/)
   }
 }
 
+/**
+ * fills the global indices of the daughter tracks of the dielectron candidate
+ *
+ * @param candidate Dielectron candidate whose daughters are filled
+ * @param tracks the track table
+ * @param daughterTrackIds vector which is filled with the global indices of the daughter tracks
+ */
+template <typename T, typename U>
+void fillDielectronDaughterTrackIds(T& candidate, U const& /*tracks*/, std::vector<int>& daughterTrackIds)
+{
+  if constexpr (isDielectronCandidate<T>()) {
+    daughterTrackIds.push_back(candidate.prong0Id());
+    daughterTrackIds.push_back(candidate.prong1Id());
+  }
+}
+
 /**
  * returns the index of the JMcParticle matched to the Dielectron candidate
  *
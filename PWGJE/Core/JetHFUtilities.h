@@ -306,6 +306,30 @@ bool isHFDaughterTrack(T& track, U& candidate, V const& /*tracks*/)
   }
 }
 
+/**
+ * fills the global indices of the daughter tracks of the HF candidate
+ *
+ * @param candidate HF candidate whose daughters are filled
+ * @param tracks the track table
+ * @param daughterTrackIds vector which is filled with the global indices of the daughter tracks
+ */
+template <typename T, typename U>
+void fillHFDaughterTrackIds(T& candidate, U const& /*tracks*/, std::vector<int>& daughterTrackIds)
+{
+  if constexpr (isD0Candidate<T>()) {
+    daughterTrackIds.push_back(candidate.prong0Id());
+    daughterTrackIds.push_back(candidate.prong1Id());
+  } else if constexpr (isLcCandidate<T>()) {
+    daughterTrackIds.push_back(candidate.prong0Id());
+    daughterTrackIds.push_back(candidate.prong1Id());
+    daughterTrackIds.push_back(candidate.prong2Id());
+  } else if constexpr (isBplusCandidate<T>()) {
+    daughterTrackIds.push_back(candidate.template prong0_as<o2::aod::HfCand2Prong>().template prong0_as<U>().globalIndex());
+    daughterTrackIds.push_back(candidate.template prong0_as<o2::aod::HfCand2Prong>().template prong1_as<U>().globalIndex());
+    daughterTrackIds.push_back(candidate.template prong1_as<U>().globalIndex());
+  }
+}
+
 /**
  * returns the index of the JMcParticle matched to the HF candidate
  *
@@ -26,6 +26,8 @@
 #include <optional>
 #include <tuple>
 #include <algorithm>
+#include <unordered_map>
+#include <utility>
 
 #include "Framework/AnalysisTask.h"
 #include "Framework/AnalysisDataModel.h"
@@ -359,34 +361,98 @@ void MatchGeo(T const& jetsBasePerCollision, U const& jetsTagPerCollision, std::
   }
 }
 
+/**
+ * Per-collision lookup from an id (constituent id, MC particle id or candidate id) to the local indices of the jets containing it.
+ *
+ * Entries are stored contiguously and sorted by (id, jet index), so all jets sharing an id are visited in their iteration order.
+ * This turns the comparison of every base jet constituent with every tag jet constituent into one lookup per base jet constituent.
+ */
+class JetIdIndex
+{
+ public:
+  void clear()
+  {
+    mEntries.clear();
+    mRanges.clear();
+  }
+
+  void add(int64_t id, int jetIndex)
+  {
+    mEntries.emplace_back(id, jetIndex);
+  }
+
+  // sorts the entries, removes duplicate (id, jet) pairs and builds the id lookup
+  void build()
+  {
+    std::sort(mEntries.begin(), mEntries.end());
+    mEntries.erase(std::unique(mEntries.begin(), mEntries.end()), mEntries.end());
+    mRanges.clear();
+    mRanges.reserve(mEntries.size());
+    for (std::size_t iEntry = 0; iEntry < mEntries.size(); iEntry++) {
+      if (iEntry == 0 || mEntries[iEntry].first != mEntries[iEntry - 1].first) {
+        mRanges[mEntries[iEntry].first] = {iEntry, iEntry + 1};
+      } else {
+        mRanges[mEntries[iEntry].first].second = iEntry + 1;
+      }
+    }
+  }
+
+  // calls f(jetIndex) for every jet containing id
+  template <typename F>
+  void forEachJet(int64_t id, F&& f) const
+  {
+    auto range = mRanges.find(id);
+    if (range == mRanges.end()) {
+      return;
+    }
+    for (std::size_t iEntry = range->second.first; iEntry < range->second.second; iEntry++) {
+      f(mEntries[iEntry].second);
+    }
+  }
+
+ private:
+  std::vector<std::pair<int64_t, int>> mEntries;                            // (id, jet index), sorted
+  std::unordered_map<int64_t, std::pair<std::size_t, std::size_t>> mRanges; // id -> [first, last) entry
+};
+
 // function that does the HF matching of jets from jetsBasePerColl and jets from jetsTagPerColl; assumes both jetsBasePerColl and jetsTagPerColl have access to Mc information
 template <bool jetsBaseIsMc, bool jetsTagIsMc, typename T, typename U, typename V, typename M, typename N, typename O>
 void MatchHF(T const& jetsBasePerCollision, U const& jetsTagPerCollision, std::vector<std::vector<int>>& baseToTagMatchingHF, std::vector<std::vector<int>>& tagToBaseMatchingHF, V const& /*candidatesBase*/, M const& /*candidatesTag*/, N const& tracksBase, O const& tracksTag)
 {
+  // index the tag jets by the id of their candidate, so that each base jet needs a single lookup
+  JetIdIndex tagCandidateIndex;
+  std::vector<int> jetsTagGlobalIndex;
+  std::vector<float> jetsTagR;
+  for (const auto& jetTag : jetsTagPerCollision) {
+    const auto candidateTag = jetTag.template candidates_first_as<M>();
+    if constexpr (jetsBaseIsMc || jetsTagIsMc) {
+      tagCandidateIndex.add(candidateTag.mcParticleId(), jetsTagGlobalIndex.size());
+    } else {
+      tagCandidateIndex.add(candidateTag.globalIndex(), jetsTagGlobalIndex.size());
+    }
+    jetsTagGlobalIndex.push_back(jetTag.globalIndex());
+    jetsTagR.push_back(std::round(jetTag.r()));
+  }
+  tagCandidateIndex.build();
+
   for (const auto& jetBase : jetsBasePerCollision) {
     const auto candidateBase = jetBase.template candidates_first_as<V>();
-    for (const auto& jetTag : jetsTagPerCollision) {
-      if (std::round(jetBase.r()) != std::round(jetTag.r())) {
+    int64_t candidateBaseId;
+    if constexpr (jetsBaseIsMc || jetsTagIsMc) {
+      if (!jetcandidateutilities::isMatchedCandidate(candidateBase)) {
         continue;
       }
-      if constexpr (jetsBaseIsMc || jetsTagIsMc) {
-        if (jetcandidateutilities::isMatchedCandidate(candidateBase)) {
-          const auto candidateBaseMcId = jetcandidateutilities::matchedParticleId(candidateBase, tracksBase, tracksTag);
-          const auto candidateTag = jetTag.template candidates_first_as<M>();
-          const auto candidateTagId = candidateTag.mcParticleId();
-          if (candidateBaseMcId == candidateTagId) {
-            baseToTagMatchingHF[jetBase.globalIndex()].push_back(jetTag.globalIndex());
-            tagToBaseMatchingHF[jetTag.globalIndex()].push_back(jetBase.globalIndex());
-          }
-        }
-      } else {
-        const auto candidateTag = jetTag.template candidates_first_as<M>();
-        if (candidateBase.globalIndex() == candidateTag.globalIndex()) {
-          baseToTagMatchingHF[jetBase.globalIndex()].push_back(jetTag.globalIndex());
-          tagToBaseMatchingHF[jetTag.globalIndex()].push_back(jetBase.globalIndex());
-        }
-      }
+      candidateBaseId = jetcandidateutilities::matchedParticleId(candidateBase, tracksBase, tracksTag);
+    } else {
+      candidateBaseId = candidateBase.globalIndex();
     }
+    tagCandidateIndex.forEachJet(candidateBaseId, [&](int jetTagIndex) {
+      if (std::round(jetBase.r()) != jetsTagR[jetTagIndex]) {
+        return;
+      }
+      baseToTagMatchingHF[jetBase.globalIndex()].push_back(jetsTagGlobalIndex[jetTagIndex]);
+      tagToBaseMatchingHF[jetsTagGlobalIndex[jetTagIndex]].push_back(jetBase.globalIndex());
+    });
   }
 }
 
@@ -406,104 +472,121 @@ auto constexpr getConstituentId(T const& track)
   }
 }
 
-template <bool isEMCAL, bool jetsBaseIsMc, bool jetsTagIsMc, typename T, typename U, typename V, typename O>
-float getPtSum(T const& tracksBase, U const& clustersBase, V const& tracksTag, O const& clustersTag)
+template <typename T, typename U>
+auto getConstituents(T const& jet, U const& /*constituents*/)
+{
+  if constexpr (jetfindingutilities::isEMCALClusterTable<U>()) {
+    return jet.template clusters_as<U>();
+  } else if constexpr (jetfindingutilities::isDummyTable<U>()) { // this is for the case where EMCal clusters are tested but no clusters exist, like in the case of charged jet analyses
+    return NULL;
+  } else {
+    return jet.template tracks_as<U>();
+  }
+}
+
+/**
+ * Computes, for every base jet, the pT it shares with every tag jet of the same collision and fills the base to tag pT matching.
+ *
+ * The tag jet constituents are indexed once per collision, and the shared pT of a base jet with all tag jets is accumulated in a single pass over its constituents.
+ * A base constituent contributes at most once to the shared pT with a given tag jet, tracks before clusters, as in the pairwise comparison.
+ */
+template <bool isEMCAL, bool jetsBaseIsMc, bool jetsTagIsMc, typename T, typename U, typename V, typename M, typename N, typename O>
+void MatchPtOneWay(T const& jetsBasePerCollision, U const& jetsTagPerCollision, std::vector<std::vector<int>>& baseToTagMatchingPt, V const& tracksBase, M const& clustersBase, N const& tracksTag, O const& clustersTag, float minPtFraction)
 {
-  std::vector<int> particleTracker;
-  float ptSum = 0.;
-  for (const auto& trackBase : tracksBase) {
-    auto trackBaseId = getConstituentId<jetsTagIsMc>(trackBase);
-    for (const auto& trackTag : tracksTag) {
+  JetIdIndex tagTrackIndex;   // tag constituent id, as seen from the base side -> tag jets
+  JetIdIndex tagClusterIndex; // MC particle ids of tag clusters -> tag jets
+  std::vector<int> jetsTagGlobalIndex;
+  std::vector<float> jetsTagR;
+  for (const auto& jetTag : jetsTagPerCollision) {
+    int jetTagIndex = jetsTagGlobalIndex.size();
+    for (const auto& trackTag : getConstituents(jetTag, tracksTag)) {
       auto trackTagId = getConstituentId<jetsBaseIsMc>(trackTag);
-      if (trackBaseId != -1 && trackBaseId == trackTagId) {
-        ptSum += trackBase.pt();
-        if constexpr (jetsBaseIsMc) {
-          particleTracker.push_back(trackBaseId);
+      if (trackTagId != -1) {
+        tagTrackIndex.add(trackTagId, jetTagIndex);
+      }
+    }
+    if constexpr (isEMCAL && jetsBaseIsMc) {
+      for (const auto& clusterTag : getConstituents(jetTag, clustersTag)) {
+        for (const auto& clusterTagParticleId : clusterTag.mcParticleIds()) {
+          if (clusterTagParticleId != -1) {
+            tagClusterIndex.add(clusterTagParticleId, jetTagIndex);
+          }
         }
-        break;
       }
     }
+    jetsTagGlobalIndex.push_back(jetTag.globalIndex());
+    jetsTagR.push_back(std::round(jetTag.r()));
   }
-  if constexpr (isEMCAL) {
-    if constexpr (jetsTagIsMc) {
-      for (const auto& clusterBase : clustersBase) {
-        for (const auto& clusterBaseParticleId : clusterBase.mcParticleIds()) {
-          bool isClusterMatched = false;
-          for (const auto& trackTag : tracksTag) {
-            if (clusterBaseParticleId != -1 && clusterBaseParticleId == trackTag.globalIndex()) {
-              ptSum += clusterBase.energy() / std::cosh(clusterBase.eta());
-              isClusterMatched = true;
-              break;
+  tagTrackIndex.build();
+  tagClusterIndex.build();
+
+  const int nJetsTag = jetsTagGlobalIndex.size();
+  std::vector<float> ptSums(nJetsTag);
+  std::vector<int> lastFilledBy(nJetsTag); // stamp of the last base constituent that was counted for each tag jet
+  for (const auto& jetBase : jetsBasePerCollision) {
+    std::fill(ptSums.begin(), ptSums.end(), 0.);
+    std::fill(lastFilledBy.begin(), lastFilledBy.end(), -1);
+    int stamp = 0;
+    for (const auto& trackBase : getConstituents(jetBase, tracksBase)) {
+      auto trackBaseId = getConstituentId<jetsTagIsMc>(trackBase);
+      if (trackBaseId != -1) {
+        tagTrackIndex.forEachJet(trackBaseId, [&](int jetTagIndex) {
+          ptSums[jetTagIndex] += trackBase.pt();
+        });
+      }
+    }
+    if constexpr (isEMCAL) {
+      if constexpr (jetsTagIsMc) {
+        // the tag side holds MC particles, so the tag constituent ids above are their global indices
+        for (const auto& clusterBase : getConstituents(jetBase, clustersBase)) {
+          stamp++;
+          for (const auto& clusterBaseParticleId : clusterBase.mcParticleIds()) {
+            if (clusterBaseParticleId == -1) {
+              continue;
             }
-          }
-          if (isClusterMatched) {
-            break;
+            tagTrackIndex.forEachJet(clusterBaseParticleId, [&](int jetTagIndex) {
+              if (lastFilledBy[jetTagIndex] != stamp) {
+                ptSums[jetTagIndex] += clusterBase.energy() / std::cosh(clusterBase.eta());
+                lastFilledBy[jetTagIndex] = stamp;
+              }
+            });
           }
         }
       }
-    }
-    if constexpr (jetsBaseIsMc) {
-      for (const auto& trackBase : tracksBase) {
-        if (std::find(particleTracker.begin(), particleTracker.end(), trackBase.globalIndex()) != particleTracker.end()) {
-          continue;
-        }
-        auto trackBaseId = trackBase.globalIndex();
-        for (const auto& clusterTag : clustersTag) {
-          bool isClusterMatched = false;
-          for (const auto& clusterTagParticleId : clusterTag.mcParticleIds()) {
-            if (trackBaseId != -1 && trackBaseId == clusterTagParticleId) {
-              ptSum += trackBase.pt();
-              isClusterMatched = true;
-              break;
+      if constexpr (jetsBaseIsMc) {
+        // particles already matched to a tag jet through its tracks are not counted again through its clusters
+        for (const auto& trackBase : getConstituents(jetBase, tracksBase)) {
+          stamp++;
+          auto trackBaseId = trackBase.globalIndex();
+          tagTrackIndex.forEachJet(getConstituentId<jetsTagIsMc>(trackBase), [&](int jetTagIndex) {
+            lastFilledBy[jetTagIndex] = stamp;
+          });
+          tagClusterIndex.forEachJet(trackBaseId, [&](int jetTagIndex) {
+            if (lastFilledBy[jetTagIndex] != stamp) {
+              ptSums[jetTagIndex] += trackBase.pt();
+              lastFilledBy[jetTagIndex] = stamp;
             }
-          }
-          if (isClusterMatched) {
-            break;
-          }
+          });
         }
       }
     }
-  }
-  return ptSum;
-}
-
-template <typename T, typename U>
-auto getConstituents(T const& jet, U const& /*constituents*/)
-{
-  if constexpr (jetfindingutilities::isEMCALClusterTable<U>()) {
-    return jet.template clusters_as<U>();
-  } else if constexpr (jetfindingutilities::isDummyTable<U>()) { // this is for the case where EMCal clusters are tested but no clusters exist, like in the case of charged jet analyses
-    return NULL;
-  } else {
-    return jet.template tracks_as<U>();
+    for (int jetTagIndex = 0; jetTagIndex < nJetsTag; jetTagIndex++) {
+      if (std::round(jetBase.r()) != jetsTagR[jetTagIndex]) {
+        continue;
+      }
+      if (ptSums[jetTagIndex] > jetBase.pt() * minPtFraction) {
+        baseToTagMatchingPt[jetBase.globalIndex()].push_back(jetsTagGlobalIndex[jetTagIndex]);
+      }
+    }
   }
 }
 
 template <bool jetsBaseIsMc, bool jetsTagIsMc, typename T, typename U, typename V, typename M, typename N, typename O>
 void MatchPt(T const& jetsBasePerCollision, U const& jetsTagPerCollision, std::vector<std::vector<int>>& baseToTagMatchingPt, std::vector<std::vector<int>>& tagToBaseMatchingPt, V const& tracksBase, M const& clustersBase, N const& tracksTag, O const& clustersTag, float minPtFraction)
 {
-  float ptSumBase;
-  float ptSumTag;
-  for (const auto& jetBase : jetsBasePerCollision) {
-    auto jetBaseTracks = getConstituents(jetBase, tracksBase);
-    auto jetBaseClusters = getConstituents(jetBase, clustersBase);
-    for (const auto& jetTag : jetsTagPerCollision) {
-      if (std::round(jetBase.r()) != std::round(jetTag.r())) {
-        continue;
-      }
-      auto jetTagTracks = getConstituents(jetTag, tracksTag);
-      auto jetTagClusters = getConstituents(jetTag, clustersTag);
-
-      ptSumBase = getPtSum < jetfindingutilities::isEMCALClusterTable<M>() || jetfindingutilities::isEMCALClusterTable<O>(), jetsBaseIsMc, jetsTagIsMc > (jetBaseTracks, jetBaseClusters, jetTagTracks, jetTagClusters);
-      ptSumTag = getPtSum < jetfindingutilities::isEMCALClusterTable<M>() || jetfindingutilities::isEMCALClusterTable<O>(), jetsTagIsMc, jetsBaseIsMc > (jetTagTracks, jetTagClusters, jetBaseTracks, jetBaseClusters);
-      if (ptSumBase > jetBase.pt() * minPtFraction) {
-        baseToTagMatchingPt[jetBase.globalIndex()].push_back(jetTag.globalIndex());
-      }
-      if (ptSumTag > jetTag.pt() * minPtFraction) {
-        tagToBaseMatchingPt[jetTag.globalIndex()].push_back(jetBase.globalIndex());
-      }
-    }
-  }
+  constexpr bool isEMCAL = jetfindingutilities::isEMCALClusterTable<M>() || jetfindingutilities::isEMCALClusterTable<O>();
+  MatchPtOneWay<isEMCAL, jetsBaseIsMc, jetsTagIsMc>(jetsBasePerCollision, jetsTagPerCollision, baseToTagMatchingPt, tracksBase, clustersBase, tracksTag, clustersTag, minPtFraction);
+  MatchPtOneWay<isEMCAL, jetsTagIsMc, jetsBaseIsMc>(jetsTagPerCollision, jetsBasePerCollision, tagToBaseMatchingPt, tracksTag, clustersTag, tracksBase, clustersBase, minPtFraction);
 }
 
 // function that calls all the Match functions
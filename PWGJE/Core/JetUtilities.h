@@ -18,10 +18,13 @@
 #ifndef PWGJE_CORE_JETUTILITIES_H_
 #define PWGJE_CORE_JETUTILITIES_H_
 
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <limits>
 #include <numeric>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include <TKDTree.h>
@@ -138,6 +141,134 @@ std::tuple<std::vector<std::vector<int>>, std::vector<std::vector<int>>> MatchCl
   return std::make_tuple(matchIndexTrack, matchIndexCluster);
 }
 
+/**
+ * Grid of track positions in (eta, phi) for cluster-track matching.
+ *
+ * The tracks of a collision are filled once, binned in cells of size maxMatchingDistance, and can then be
+ * queried by the clusters of any number of clusterizers. A cluster only needs to be compared with the tracks
+ * of its own and the neighbouring cells. The matching criterion is the one of MatchClustersAndTracks:
+ * the maxNumberMatches closest tracks with dR < maxMatchingDistance, without wrapping around in phi.
+ */
+class TrackEtaPhiGrid
+{
+ public:
+  struct Track {
+    float eta;
+    float phi;
+    float pt;
+    int sign;
+    int64_t globalIndex;
+  };
+
+  // removes all tracks and sets the matching distance, which is also the cell size of the grid
+  void reset(float maxMatchingDistance)
+  {
+    mMaxMatchingDistance = maxMatchingDistance;
+    mTracks.clear();
+    mTrackOrder.clear();
+    mCellOffsets.clear();
+    mNCellsEta = 0;
+    mNCellsPhi = 0;
+  }
+
+  void addTrack(float eta, float phi, float pt, int sign, int64_t globalIndex)
+  {
+    mTracks.push_back({eta, phi, pt, sign, globalIndex});
+  }
+
+  // sorts the tracks into the grid cells; must be called after the last addTrack and before matching
+  void build()
+  {
+    mTrackOrder.clear();
+    mCellOffsets.clear();
+    mNCellsEta = 0;
+    mNCellsPhi = 0;
+    if (mTracks.empty() || !(mMaxMatchingDistance > 0.f)) {
+      return;
+    }
+    mEtaMin = mTracks[0].eta;
+    mPhiMin = mTracks[0].phi;
+    float etaMax = mEtaMin;
+    float phiMax = mPhiMin;
+    for (const auto& track : mTracks) {
+      mEtaMin = std::min(mEtaMin, track.eta);
+      mPhiMin = std::min(mPhiMin, track.phi);
+      etaMax = std::max(etaMax, track.eta);
+      phiMax = std::max(phiMax, track.phi);
+    }
+    mNCellsEta = static_cast<int>((etaMax - mEtaMin) / mMaxMatchingDistance) + 1;
+    mNCellsPhi = static_cast<int>((phiMax - mPhiMin) / mMaxMatchingDistance) + 1;
+    // counting sort of the tracks by cell
+    mCellOffsets.assign(mNCellsEta * mNCellsPhi + 1, 0);
+    for (const auto& track : mTracks) {
+      mCellOffsets[cellIndex(track.eta, track.phi) + 1]++;
+    }
+    std::partial_sum(mCellOffsets.begin(), mCellOffsets.end(), mCellOffsets.begin());
+    mTrackOrder.resize(mTracks.size());
+    std::vector<int> cellFill(mCellOffsets.begin(), mCellOffsets.end() - 1);
+    for (std::size_t iTrack = 0; iTrack < mTracks.size(); iTrack++) {
+      mTrackOrder[cellFill[cellIndex(mTracks[iTrack].eta, mTracks[iTrack].phi)]++] = iTrack;
+    }
+  }
+
+  /**
+   * Finds the tracks matched to a cluster.
+   *
+   * @param clusterEta cluster eta.
+   * @param clusterPhi cluster phi.
+   * @param maxNumberMatches Maximum number of matches (e.g. 5 closest).
+   * @param matchedTracks indices of the matched tracks in tracks(), ordered by increasing distance.
+   */
+  void matchCluster(float clusterEta, float clusterPhi, int maxNumberMatches, std::vector<int>& matchedTracks)
+  {
+    matchedTracks.clear();
+    mCandidates.clear();
+    if (mNCellsEta == 0) {
+      return;
+    }
+    int cellEta = static_cast<int>(std::floor((clusterEta - mEtaMin) / mMaxMatchingDistance));
+    int cellPhi = static_cast<int>(std::floor((clusterPhi - mPhiMin) / mMaxMatchingDistance));
+    for (int iEta = std::max(cellEta - 1, 0); iEta <= std::min(cellEta + 1, mNCellsEta - 1); iEta++) {
+      for (int iPhi = std::max(cellPhi - 1, 0); iPhi <= std::min(cellPhi + 1, mNCellsPhi - 1); iPhi++) {
+        int cell = iEta * mNCellsPhi + iPhi;
+        for (int iEntry = mCellOffsets[cell]; iEntry < mCellOffsets[cell + 1]; iEntry++) {
+          const auto& track = mTracks[mTrackOrder[iEntry]];
+          float dEta = track.eta - clusterEta;
+          float dPhi = track.phi - clusterPhi;
+          float distance = std::sqrt(dEta * dEta + dPhi * dPhi);
+          if (distance < mMaxMatchingDistance) {
+            mCandidates.emplace_back(distance, mTrackOrder[iEntry]);
+          }
+        }
+      }
+    }
+    std::size_t nMatches = std::min(mCandidates.size(), static_cast<std::size_t>(std::max(maxNumberMatches, 0)));
+    std::partial_sort(mCandidates.begin(), mCandidates.begin() + nMatches, mCandidates.end());
+    for (std::size_t iMatch = 0; iMatch < nMatches; iMatch++) {
+      matchedTracks.push_back(mCandidates[iMatch].second);
+    }
+  }
+
+  const std::vector<Track>& tracks() const { return mTracks; }
+  std::size_t size() const { return mTracks.size(); }
+
+ private:
+  int cellIndex(float eta, float phi) const
+  {
+    return static_cast<int>((eta - mEtaMin) / mMaxMatchingDistance) * mNCellsPhi + static_cast<int>((phi - mPhiMin) / mMaxMatchingDistance);
+  }
+
+  float mMaxMatchingDistance = 0.f;
+  float mEtaMin = 0.f;
+  float mPhiMin = 0.f;
+  int mNCellsEta = 0;
+  int mNCellsPhi = 0;
+  std::vector<Track> mTracks;
+  std::vector<int> mTrackOrder;                   // track indices sorted by cell
+  std::vector<int> mCellOffsets;                  // first entry of each cell in mTrackOrder
+  std::vector<std::pair<float, int>> mCandidates; // (distance, track index), reused between clusters
+};
+
 template <typename T, typename U>
 float deltaR(T const& A, U const& B)
 {
@@ -106,6 +106,22 @@ bool isV0DaughterTrack(T& track, U& candidate, V const& /*tracks*/)
   }
 }
 
+/**
+ * fills the global indices of the daughter tracks of the V0 candidate
+ *
+ * @param candidate V0 candidate whose daughters are filled
+ * @param tracks the track table
+ * @param daughterTrackIds vector which is filled with the global indices of the daughter tracks
+ */
+template <typename T, typename U>
+void fillV0DaughterTrackIds(T& candidate, U const& /*tracks*/, std::vector<int>& daughterTrackIds)
+{
+  if constexpr (isV0Candidate<T>()) {
+    daughterTrackIds.push_back(candidate.posTrackId());
+    daughterTrackIds.push_back(candidate.negTrackId());
+  }
+}
+
 /**
  * returns the index of the JMcParticle matched to the V0 candidate
  *
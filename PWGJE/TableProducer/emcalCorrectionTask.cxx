@@ -75,6 +75,7 @@ struct EmcalCorrectionTask {
   Configurable<int> selectedCellType{"selectedCellType", 1, "EMCAL Cell type"};
   Configurable<std::string> clusterDefinitions{"clusterDefinition", "kV3Default", "cluster definition to be selected, e.g. V3Default. Multiple definitions can be specified separated by comma"};
   Configurable<float> maxMatchingDistance{"maxMatchingDistance", 0.4f, "Max matching distance track-cluster"};
+  Configurable<int> maxNumberMatches{"maxNumberMatches", 20, "Max number of tracks matched to a cluster (closest first)"};
   Configurable<bool> hasPropagatedTracks{"hasPropagatedTracks", false, "temporary flag, only set to true when running over data which has the tracks propagated to EMCal/PHOS!"};
   Configurable<std::string> nonlinearityFunction{"nonlinearityFunction", "DATA_TestbeamFinal", "Nonlinearity correction at cluster level"};
   Configurable<bool> disableNonLin{"disableNonLin", false, "Disable NonLin correction if set to true"};
@@ -104,6 +105,9 @@ struct EmcalCorrectionTask {
   // Cells and clusters
   std::vector<o2::emcal::AnalysisCluster> mAnalysisClusters;
   std::vector<o2::emcal::ClusterLabel> mClusterLabels;
+  // Tracks of the current collision, shared by the track matching of all clusterizers
+  jetutilities::TrackEtaPhiGrid mTrackGrid;
+  std::vector<int> mMatchedTrackIndices;
 
   std::vector<o2::aod::EMCALClusterDefinition> mClusterDefinitions;
   // QA
@@ -288,15 +292,14 @@ struct EmcalCorrectionTask {
               mHistManager.fill(HIST("hCollisionType"), 1);
               math_utils::Point3D<float> vertex_pos = {col.posX(), col.posY(), col.posZ()};
 
-              std::vector<std::vector<int>> clusterToTrackIndexMap;
-              std::vector<std::vector<int>> trackToClusterIndexMap;
-              std::tuple<std::vector<std::vector<int>>, std::vector<std::vector<int>>> IndexMapPair{clusterToTrackIndexMap, trackToClusterIndexMap};
-              std::vector<int64_t> trackGlobalIndex;
-              doTrackMatching<collEventSels::filtered_iterator>(col, tracks, IndexMapPair, vertex_pos, trackGlobalIndex);
+              // The tracks of the collision are placed on the grid only once and shared by all clusterizers
+              if (iClusterizer == 0) {
+                FillTrackGrid<collEventSels::filtered_iterator>(col, tracks);
+              }
 
               // Store the clusters in the table where a matching collision could
               // be identified.
-              FillClusterTable<collEventSels::filtered_iterator>(col, vertex_pos, iClusterizer, cellIndicesBC, IndexMapPair, trackGlobalIndex);
+              FillClusterTable<collEventSels::filtered_iterator>(col, vertex_pos, iClusterizer, cellIndicesBC, true);
             }
           }
         } else { // ambiguous
@@ -407,15 +410,14 @@ struct EmcalCorrectionTask {
               mHistManager.fill(HIST("hCollisionType"), 1);
               math_utils::Point3D<float> vertex_pos = {col.posX(), col.posY(), col.posZ()};
 
-              std::vector<std::vector<int>> clusterToTrackIndexMap;
-              std::vector<std::vector<int>> trackToClusterIndexMap;
-              std::tuple<std::vector<std::vector<int>>, std::vector<std::vector<int>>> IndexMapPair{clusterToTrackIndexMap, trackToClusterIndexMap};
-              std::vector<int64_t> trackGlobalIndex;
-              doTrackMatching<collEventSels::filtered_iterator>(col, tracks, IndexMapPair, vertex_pos, trackGlobalIndex);
+              // The tracks of the collision are placed on the grid only once and shared by all clusterizers
+              if (iClusterizer == 0) {
+                FillTrackGrid<collEventSels::filtered_iterator>(col, tracks);
+              }
 
               // Store the clusters in the table where a matching collision could
               // be identified.
-              FillClusterTable<collEventSels::filtered_iterator>(col, vertex_pos, iClusterizer, cellIndicesBC, IndexMapPair, trackGlobalIndex);
+              FillClusterTable<collEventSels::filtered_iterator>(col, vertex_pos, iClusterizer, cellIndicesBC, true);
             }
           }
         } else { // ambiguous
@@ -568,7 +570,7 @@ struct EmcalCorrectionTask {
   }
 
   template <typename Collision>
-  void FillClusterTable(Collision const& col, math_utils::Point3D<float> const& vertex_pos, size_t iClusterizer, const gsl::span<int64_t> cellIndicesBC, std::optional<std::tuple<std::vector<std::vector<int>>, std::vector<std::vector<int>>>> const& IndexMapPair = std::nullopt, std::optional<std::vector<int64_t>> const& trackGlobalIndex = std::nullopt)
+  void FillClusterTable(Collision const& col, math_utils::Point3D<float> const& vertex_pos, size_t iClusterizer, const gsl::span<int64_t> cellIndicesBC, bool matchTracks = false)
   {
     // we found a collision, put the clusters into the none ambiguous table
     clusters.reserve(mAnalysisClusters.size());
@@ -618,12 +620,11 @@ struct EmcalCorrectionTask {
       // fill histograms
       mHistManager.fill(HIST("hClusterE"), cluster.E());
       mHistManager.fill(HIST("hClusterEtaPhi"), pos.Eta(), TVector2::Phi_0_2pi(pos.Phi()));
-      if (IndexMapPair && trackGlobalIndex) {
-        for (unsigned int iTrack = 0; iTrack < std::get<0>(*IndexMapPair)[iCluster].size(); iTrack++) {
-          if (std::get<0>(*IndexMapPair)[iCluster][iTrack] >= 0) {
-            LOG(debug) << "Found track " << (*trackGlobalIndex)[std::get<0>(*IndexMapPair)[iCluster][iTrack]] << " in cluster " << cluster.getID();
-            matchedTracks(clusters.lastIndex(), (*trackGlobalIndex)[std::get<0>(*IndexMapPair)[iCluster][iTrack]]);
-          }
+      if (matchTracks) {
+        mTrackGrid.matchCluster(pos.Eta(), TVector2::Phi_0_2pi(pos.Phi()), maxNumberMatches, mMatchedTrackIndices);
+        for (const auto& iTrack : mMatchedTrackIndices) {
+          LOG(debug) << "Found track " << mTrackGrid.tracks()[iTrack].globalIndex << " in cluster " << cluster.getID();
+          matchedTracks(clusters.lastIndex(), mTrackGrid.tracks()[iTrack].globalIndex);
         }
       }
       iCluster++;
@@ -673,47 +674,12 @@ struct EmcalCorrectionTask {
   }
 
   template <typename Collision>
-  void doTrackMatching(Collision const& col, myGlobTracks const& tracks, std::tuple<std::vector<std::vector<int>>, std::vector<std::vector<int>>>& IndexMapPair, math_utils::Point3D<float>& vertex_pos, std::vector<int64_t>& trackGlobalIndex)
+  void FillTrackGrid(Collision const& col, myGlobTracks const& tracks)
   {
     auto groupedTracks = tracks.sliceBy(perCollision, col.globalIndex());
-    int NTracksInCol = groupedTracks.size();
-    std::vector<double> trackPhi;
-    std::vector<double> trackEta;
-    // reserve memory to reduce on the fly memory allocation
-    trackPhi.reserve(NTracksInCol);
-    trackEta.reserve(NTracksInCol);
-    trackGlobalIndex.reserve(NTracksInCol);
-    FillTrackInfo<decltype(groupedTracks)>(groupedTracks, trackPhi, trackEta, trackGlobalIndex);
-
-    int NClusterInCol = mAnalysisClusters.size();
-    std::vector<double> clusterPhi;
-    std::vector<double> clusterEta;
-    clusterPhi.reserve(NClusterInCol);
-    clusterEta.reserve(NClusterInCol);
-
-    // TODO one loop that could in principle be combined with the other
-    // loop to improve performance
-    for (const auto& cluster : mAnalysisClusters) {
-      // Determine the cluster eta, phi, correcting for the vertex
-      // position.
-      auto pos = cluster.getGlobalPosition();
-      pos = pos - vertex_pos;
-      // Normalize the vector and rescale by energy.
-      pos *= (cluster.E() / std::sqrt(pos.Mag2()));
-      clusterPhi.emplace_back(TVector2::Phi_0_2pi(pos.Phi()));
-      clusterEta.emplace_back(pos.Eta());
-    }
-    IndexMapPair =
-      jetutilities::MatchClustersAndTracks(clusterPhi, clusterEta,
-                                           trackPhi, trackEta,
-                                           maxMatchingDistance, 20);
-  }
-
-  template <typename Tracks>
-  void FillTrackInfo(Tracks const& tracks, std::vector<double>& trackPhi, std::vector<double>& trackEta, std::vector<int64_t>& trackGlobalIndex)
-  {
+    mTrackGrid.reset(maxMatchingDistance);
     int NTrack = 0;
-    for (auto& track : tracks) {
+    for (auto& track : groupedTracks) {
       // TODO only consider tracks in current emcal/dcal acceptanc
       if (!track.isGlobalTrack()) { // only global tracks
         continue;
@@ -721,18 +687,16 @@ struct EmcalCorrectionTask {
       NTrack++;
       if (hasPropagatedTracks) { // only temporarily while not every data
                                  // has the tracks propagated to EMCal/PHOS
-        trackPhi.emplace_back(TVector2::Phi_0_2pi(track.trackPhiEmcal()));
-        trackEta.emplace_back(track.trackEtaEmcal());
+        mTrackGrid.addTrack(track.trackEtaEmcal(), TVector2::Phi_0_2pi(track.trackPhiEmcal()), track.pt(), track.sign(), track.globalIndex());
         mHistManager.fill(HIST("hGlobalTrackEtaPhi"), track.trackEtaEmcal(),
                           TVector2::Phi_0_2pi(track.trackPhiEmcal()));
       } else {
-        trackPhi.emplace_back(TVector2::Phi_0_2pi(track.phi()));
-        trackEta.emplace_back(track.eta());
+        mTrackGrid.addTrack(track.eta(), TVector2::Phi_0_2pi(track.phi()), track.pt(), track.sign(), track.globalIndex());
         mHistManager.fill(HIST("hGlobalTrackEtaPhi"), track.eta(),
                           TVector2::Phi_0_2pi(track.phi()));
       }
-      trackGlobalIndex.emplace_back(track.globalIndex());
     }
+    mTrackGrid.build();
     mHistManager.fill(HIST("hGlobalTrackMult"), NTrack);
   }
 
@@ -13,6 +13,9 @@
 //
 /// \author Nima Zardoshti <nima.zardoshti@cern.ch>
 
+#include <algorithm>
+#include <vector>
+
 #include "Framework/AnalysisTask.h"
 #include "Framework/AnalysisDataModel.h"
 #include "Framework/ASoA.h"
@@ -49,11 +52,22 @@ struct eventWiseConstituentSubtractorTask {
   Configurable<float> rMax{"rMax", 0.24, "maximum distance of subtraction"};
   Configurable<float> eventEtaMax{"eventEtaMax", 0.9, "maximum pseudorapidity of event"};
   Configurable<bool> doRhoMassSub{"doRhoMassSub", true, "perfom mass subtraction as well"};
+  Configurable<float> regionReuseDistance{"regionReuseDistance", -1.0, "for HF candidates, if > 0: when a candidate has the same rho as the last fully subtracted candidate of the collision but different daughters, only the tracks within this distance of the differing daughters are subtracted again (from the tracks within twice this distance) and the other subtracted tracks are reused. Constituent subtraction is a global matching of ghosts to particles, so this is an approximation which improves with the distance in units of rMax"};
 
   JetBkgSubUtils eventWiseConstituentSubtractor;
   float bkgPhiMax_;
   std::vector<fastjet::PseudoJet> inputParticles;
   std::vector<fastjet::PseudoJet> tracksSubtracted;
+  std::vector<fastjet::PseudoJet> eventParticles; // all the selected tracks of the collision, shared by its candidates
+  std::vector<int> eventParticleTracks;           // track global index per event particle
+  std::vector<bool> isCandidateDaughter;          // per event particle
+  std::vector<int> candidateDaughterTracks;       // track global indices of the daughters of the current candidate
+  std::vector<int> candidateDaughters;            // event particles removed for the current candidate
+  std::vector<fastjet::PseudoJet> changedDaughters;
+  std::vector<fastjet::PseudoJet> referenceTracksSubtracted; // last full subtraction of the collision
+  std::vector<int> referenceCandidateDaughters;
+  double referenceRho = -1.;
+  double referenceRhoM = -1.;
   int trackSelection = -1;
 
   void init(o2::framework::InitContext&)
@@ -70,13 +84,97 @@ struct eventWiseConstituentSubtractorTask {
   template <typename T, typename U, typename V>
   void analyseHF(T const& tracks, U const& candidates, V& trackSubtractedTable)
   {
+    if (candidates.size() == 0) {
+      return;
+    }
+
+    // the tracks are randomly dropped per candidate with a tracking efficiency, so the event particles cannot be shared between candidates
+    if (trackingEfficiency < 0.999) {
+      for (auto& candidate : candidates) {
+        inputParticles.clear();
+        jetfindingutilities::analyseTracks(inputParticles, tracks, trackSelection, trackingEfficiency, std::optional{candidate});
+        tracksSubtracted = eventWiseConstituentSubtractor.JetBkgSubUtils::doEventConstSub(inputParticles, candidate.rho(), candidate.rhoM());
+        for (auto const& trackSubtracted : tracksSubtracted) {
+          trackSubtractedTable(candidate.globalIndex(), trackSubtracted.pt(), trackSubtracted.eta(), trackSubtracted.phi(), trackSubtracted.E(), jetderiveddatautilities::setSingleTrackSelectionBit(trackSelection));
+        }
+      }
+      return;
+    }
+
+    // the tracks of the collision are selected once, the daughters of each candidate are then removed from this list
+    eventParticles.clear();
+    eventParticleTracks.clear();
+    jetfindingutilities::analyseTracks<T, typename T::iterator>(eventParticles, tracks, trackSelection, trackingEfficiency);
+    for (auto const& particle : eventParticles) {
+      eventParticleTracks.push_back(particle.template user_info<fastjetutilities::fastjet_user_info>().getIndex());
+    }
+    isCandidateDaughter.assign(eventParticles.size(), false);
+    referenceTracksSubtracted.clear();
+    referenceCandidateDaughters.clear();
+    referenceRho = -1.;
+    referenceRhoM = -1.;
 
     for (auto& candidate : candidates) {
-      inputParticles.clear();
-      tracksSubtracted.clear();
-      jetfindingutilities::analyseTracks(inputParticles, tracks, trackSelection, trackingEfficiency, std::optional{candidate});
+      candidateDaughterTracks.clear();
+      jetcandidateutilities::fillDaughterTrackIds(candidate, tracks, candidateDaughterTracks);
+      candidateDaughters.clear();
+      for (std::size_t iParticle = 0; iParticle < eventParticles.size(); iParticle++) {
+        isCandidateDaughter[iParticle] = std::find(candidateDaughterTracks.begin(), candidateDaughterTracks.end(), eventParticleTracks[iParticle]) != candidateDaughterTracks.end();
+        if (isCandidateDaughter[iParticle]) {
+          candidateDaughters.push_back(iParticle);
+        }
+      }
 
-      tracksSubtracted = eventWiseConstituentSubtractor.JetBkgSubUtils::doEventConstSub(inputParticles, candidate.rho(), candidate.rhoM());
+      bool isSameRho = candidate.rho() == referenceRho && candidate.rhoM() == referenceRhoM;
+      if (isSameRho && candidateDaughters == referenceCandidateDaughters) {
+        // the subtraction depends only on the input particles and on rho
+        tracksSubtracted = referenceTracksSubtracted;
+      } else if (isSameRho && regionReuseDistance > 0.) {
+        // only the region around the daughters removed for one of the two candidates is subtracted again
+        changedDaughters.clear();
+        for (auto iParticle : candidateDaughters) {
+          if (std::find(referenceCandidateDaughters.begin(), referenceCandidateDaughters.end(), iParticle) == referenceCandidateDaughters.end()) {
+            changedDaughters.push_back(eventParticles[iParticle]);
+          }
+        }
+        for (auto iParticle : referenceCandidateDaughters) {
+          if (std::find(candidateDaughters.begin(), candidateDaughters.end(), iParticle) == candidateDaughters.end()) {
+            changedDaughters.push_back(eventParticles[iParticle]);
+          }
+        }
+        auto isInRegion = [&](const fastjet::PseudoJet& particle, float distance) {
+          return std::any_of(changedDaughters.begin(), changedDaughters.end(), [&](const fastjet::PseudoJet& daughter) { return particle.delta_R(daughter) < distance; });
+        };
+        inputParticles.clear();
+        for (std::size_t iParticle = 0; iParticle < eventParticles.size(); iParticle++) {
+          if (!isCandidateDaughter[iParticle] && isInRegion(eventParticles[iParticle], 2. * regionReuseDistance)) {
+            inputParticles.push_back(eventParticles[iParticle]);
+          }
+        }
+        tracksSubtracted.clear();
+        for (auto const& trackSubtracted : referenceTracksSubtracted) {
+          if (!isInRegion(trackSubtracted, regionReuseDistance)) {
+            tracksSubtracted.push_back(trackSubtracted);
+          }
+        }
+        for (auto const& trackSubtracted : eventWiseConstituentSubtractor.JetBkgSubUtils::doEventConstSub(inputParticles, candidate.rho(), candidate.rhoM())) {
+          if (isInRegion(trackSubtracted, regionReuseDistance)) {
+            tracksSubtracted.push_back(trackSubtracted);
+          }
+        }
+      } else {
+        inputParticles.clear();
+        for (std::size_t iParticle = 0; iParticle < eventParticles.size(); iParticle++) {
+          if (!isCandidateDaughter[iParticle]) {
+            inputParticles.push_back(eventParticles[iParticle]);
+          }
+        }
+        tracksSubtracted = eventWiseConstituentSubtractor.JetBkgSubUtils::doEventConstSub(inputParticles, candidate.rho(), candidate.rhoM());
+        referenceTracksSubtracted = tracksSubtracted;
+        referenceCandidateDaughters = candidateDaughters;
+        referenceRho = candidate.rho();
+        referenceRhoM = candidate.rhoM();
+      }
       for (auto const& trackSubtracted : tracksSubtracted) {
 
         trackSubtractedTable(candidate.globalIndex(), trackSubtracted.pt(), trackSubtracted.eta(), trackSubtracted.phi(), trackSubtracted.E(), jetderiveddatautilities::setSingleTrackSelectionBit(trackSelection));
@@ -13,8 +13,12 @@
 //
 /// \author Nima Zardoshti <nima.zardoshti@cern.ch>
 
+#include <algorithm>
+#include <vector>
+
 #include "Framework/AnalysisTask.h"
 #include "Framework/AnalysisDataModel.h"
+#include "Framework/HistogramRegistry.h"
 #include "Framework/ASoA.h"
 #include "Framework/O2DatabasePDGPlugin.h"
 
@@ -51,10 +55,16 @@ struct RhoEstimatorTask {
   Configurable<float> bkgPhiMin{"bkgPhiMin", 0., "minimim phi for determining background density"};
   Configurable<float> bkgPhiMax{"bkgPhiMax", 99.0, "maximum phi for determining background density"};
   Configurable<bool> doSparse{"doSparse", false, "perfom sparse estimation"};
+  Configurable<bool> doCandidateRhoFromEventClustering{"doCandidateRhoFromEventClustering", false, "for HF candidates: cluster the event once and only recluster the kT jets containing the daughters of each candidate, instead of reclustering the whole event without the daughters per candidate. The remaining constituents are only reassigned among the reclustered jets, so rho can differ from the per-candidate clustering. Not used when trackingEfficiency < 0.999, as the tracks are then randomly dropped per candidate"};
+  Configurable<bool> doCandidateRhoValidation{"doCandidateRhoValidation", false, "with doCandidateRhoFromEventClustering: also recluster the whole event without the daughters per candidate and fill the differences of rho and rhoM"};
+
+  HistogramRegistry registry{"registry", {}, OutputObjHandlingPolicy::AnalysisObject};
 
   JetBkgSubUtils bkgSub;
   float bkgPhiMax_;
   std::vector<fastjet::PseudoJet> inputParticles;
+  std::vector<fastjet::PseudoJet> candidateInputParticles;
+  std::vector<int> candidateDaughters;
   int trackSelection = -1;
 
   void init(o2::framework::InitContext&)
@@ -67,10 +77,57 @@ struct RhoEstimatorTask {
       bkgPhiMax_ = 2.0 * M_PI;
     }
     bkgSub.setPhiMinMax(bkgPhiMin, bkgPhiMax_);
+
+    if (doCandidateRhoValidation) {
+      registry.add("h2_rho_candidate_event_clustering", ";#it{#rho} per-candidate clustering (GeV/#it{c});#it{#rho} event clustering (GeV/#it{c})", {HistType::kTH2F, {{400, 0., 400.}, {400, 0., 400.}}});
+      registry.add("h_rho_difference", ";#it{#rho} event clustering - #it{#rho} per-candidate clustering (GeV/#it{c});entries", {HistType::kTH1F, {{400, -2., 2.}}});
+      registry.add("h_rhom_difference", ";#it{#rho}_{m} event clustering - #it{#rho}_{m} per-candidate clustering (GeV/#it{c});entries", {HistType::kTH1F, {{400, -0.2, 0.2}}});
+    }
   }
 
   Filter trackCuts = (aod::jtrack::pt >= trackPtMin && aod::jtrack::pt < trackPtMax && aod::jtrack::eta > trackEtaMin && aod::jtrack::eta < trackEtaMax && aod::jtrack::phi >= trackPhiMin && aod::jtrack::phi <= trackPhiMax);
 
+  template <typename T, typename U, typename V>
+  void analyseHF(T const& tracks, U const& candidates, V& rhoTable)
+  {
+    inputParticles.clear();
+    if (!doCandidateRhoFromEventClustering || trackingEfficiency < 0.999) {
+      for (auto& candidate : candidates) {
+        inputParticles.clear();
+        jetfindingutilities::analyseTracks(inputParticles, tracks, trackSelection, trackingEfficiency, std::optional{candidate});
+
+        auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, doSparse);
+        rhoTable(rho, rhoM);
+      }
+      return;
+    }
+
+    if (candidates.size() == 0) {
+      return;
+    }
+    jetfindingutilities::analyseTracks<T, typename T::iterator>(inputParticles, tracks, trackSelection, trackingEfficiency);
+    bkgSub.clusterEventForRhoAreaMedian(inputParticles);
+    for (auto& candidate : candidates) {
+      candidateDaughters.clear();
+      jetcandidateutilities::fillDaughterTrackIds(candidate, tracks, candidateDaughters);
+      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedianWithoutTracks(candidateDaughters, doSparse);
+      rhoTable(rho, rhoM);
+
+      if (doCandidateRhoValidation) {
+        candidateInputParticles.clear();
+        for (auto& particle : inputParticles) {
+          if (std::find(candidateDaughters.begin(), candidateDaughters.end(), particle.user_info<fastjetutilities::fastjet_user_info>().getIndex()) == candidateDaughters.end()) {
+            candidateInputParticles.push_back(particle);
+          }
+        }
+        auto [rhoReference, rhoMReference] = bkgSub.estimateRhoAreaMedian(candidateInputParticles, doSparse);
+        registry.fill(HIST("h2_rho_candidate_event_clustering"), rhoReference, rho);
+        registry.fill(HIST("h_rho_difference"), rho - rhoReference);
+        registry.fill(HIST("h_rhom_difference"), rhoM - rhoMReference);
+      }
+    }
+  }
+
   void processChargedCollisions(aod::JetCollision const& collision, soa::Filtered<aod::JetTracks> const& tracks)
   {
     inputParticles.clear();
@@ -82,53 +139,25 @@ struct RhoEstimatorTask {
 
   void processD0Collisions(aod::JetCollision const&, soa::Filtered<aod::JetTracks> const& tracks, aod::CandidatesD0Data const& candidates)
   {
-    inputParticles.clear();
-    for (auto& candidate : candidates) {
-      inputParticles.clear();
-      jetfindingutilities::analyseTracks(inputParticles, tracks, trackSelection, trackingEfficiency, std::optional{candidate});
-
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, doSparse);
-      rhoD0Table(rho, rhoM);
-    }
+    analyseHF(tracks, candidates, rhoD0Table);
   }
   PROCESS_SWITCH(RhoEstimatorTask, processD0Collisions, "Fill rho tables for collisions with D0 candidates", false);
 
   void processLcCollisions(aod::JetCollision const&, soa::Filtered<aod::JetTracks> const& tracks, aod::CandidatesLcData const& candidates)
   {
-    inputParticles.clear();
-    for (auto& candidate : candidates) {
-      inputParticles.clear();
-      jetfindingutilities::analyseTracks(inputParticles, tracks, trackSelection, trackingEfficiency, std::optional{candidate});
-
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, doSparse);
-      rhoLcTable(rho, rhoM);
-    }
+    analyseHF(tracks, candidates, rhoLcTable);
   }
   PROCESS_SWITCH(RhoEstimatorTask, processLcCollisions, "Fill rho tables for collisions with Lc candidates", false);
 
   void processBplusCollisions(aod::JetCollision const&, soa::Filtered<aod::JetTracks> const& tracks, aod::CandidatesBplusData const& candidates)
   {
-    inputParticles.clear();
-    for (auto& candidate : candidates) {
-      inputParticles.clear();
-      jetfindingutilities::analyseTracks(inputParticles, tracks, trackSelection, trackingEfficiency, std::optional{candidate});
-
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, doSparse);
-      rhoBplusTable(rho, rhoM);
-    }
+    analyseHF(tracks, candidates, rhoBplusTable);
   }
   PROCESS_SWITCH(RhoEstimatorTask, processBplusCollisions, "Fill rho tables for collisions with Bplus candidates", false);
 
   void processDielectronCollisions(aod::JetCollision const&, soa::Filtered<aod::JetTracks> const& tracks, aod::CandidatesDielectronData const& candidates)
   {
-    inputParticles.clear();
-    for (auto& candidate : candidates) {
-      inputParticles.clear();
-      jetfindingutilities::analyseTracks(inputParticles, tracks, trackSelection, trackingEfficiency, std::optional{candidate});
-
-      auto [rho, rhoM] = bkgSub.estimateRhoAreaMedian(inputParticles, doSparse);
-      rhoDielectronTable(rho, rhoM);
-    }
+    analyseHF(tracks, candidates, rhoDielectronTable);
   }
   PROCESS_SWITCH(RhoEstimatorTask, processDielectronCollisions, "Fill rho tables for collisions with Dielectron candidates", false);
 };
@@ -12,10 +12,14 @@
 // This 3-body method is not recommended due to high cost of computing resources
 // author: yuanzhe.wang@cern.ch
 
+#include <algorithm>
 #include <cmath>
 #include <array>
 #include <cstdlib>
 #include <iterator>
+#include <numeric>
+#include <unordered_map>
+#include <vector>
 
 #include "Framework/runDataProcessing.h"
 #include "Framework/AnalysisTask.h"
@@ -39,6 +43,7 @@
 #include "DataFormatsParameters/GRPObject.h"
 #include "DataFormatsParameters/GRPMagField.h"
 #include "CCDB/BasicCCDBManager.h"
+#include "CommonConstants/MathConstants.h"
 
 using namespace o2;
 using namespace o2::framework;
@@ -239,6 +244,9 @@ struct hypertriton3bodyFinder {
 
   // for 3 body reconstructed Vertex
   Configurable<float> minbachPt = {"minbachPt", 0.6, ""};           ///< Minimum bachelor Pt
+  Configurable<float> maxBachDeltaPhiToV0 = {"maxBachDeltaPhiToV0", -1, "Max azimuthal distance of the bachelor to the 2-body momentum, rad, looked up in the bachelors sorted in phi (<0: all bachelors)"};
+  Configurable<float> maxBachDeltaEtaToV0 = {"maxBachDeltaEtaToV0", -1, "Max pseudorapidity distance of the bachelor to the 2-body momentum (<0: no selection)"};
+  Configurable<float> maxBachDCAToV0 = {"maxBachDCAToV0", -1, "Max DCA of the bachelor to the 2-body vertex before the 3-body fit, cm (<0: no preselection)"};
   Configurable<float> maxRDiff3bodyV0 = {"maxRDiff3bodyV0", 3, ""}; ///< Maximum difference between V0 and 3body radii
   Configurable<float> minPt3Body = {"minPt3Body", 0.01, ""};        // minimum pT of 3body Vertex
   Configurable<float> maxTgl3Body = {"maxTgl3Body", 2, ""};         // maximum tgLambda of 3body Vertex
@@ -513,12 +521,206 @@ struct hypertriton3bodyFinder {
   }
 
   o2::dataformats::VertexBase mMeanVertex{{0., 0., 0.}, {0.1 * 0.1, 0., 0.1 * 0.1, 0., 0., 6. * 6.}};
+
+  //------------------------------------------------------------------
+  // Per-collision cache of the good tracks: track parameters and MC truth are extracted once per track,
+  // the DCAs to the PV once per track which ends up in a candidate
+  struct {
+    std::vector<int> globalIndex;
+    std::vector<int> collisionId;
+    std::vector<int> sign;
+    std::vector<o2::track::TrackParCov> trackParCov;
+    std::vector<int> mcPdg;       // 0 if no MC particle
+    std::vector<int> mcH3LMother; // index of the hypertriton mother, -1 if none
+    std::vector<bool> hasDcaToPV; // DCAs below are filled on demand
+    std::vector<float> dcaXYToPV;
+    std::vector<float> dcaToPV;
+    std::unordered_map<int, int> slot; // track global index -> position in the cache
+  } trackCache;
+
+  // 2-body (p, pi) sub-vertex accepted by the V0 finder, reused for all bachelors
+  struct SubVertex {
+    int pos;                  // position of the positive track in the track cache
+    int neg;                  // position of the negative track in the track cache
+    float rv0;                // radius to the mean vertex
+    std::array<float, 3> xyz; // position of the 2-body vertex
+    float phi;                // azimuth of the 2-body momentum
+    float eta;                // pseudorapidity of the 2-body momentum
+    bool isTrue3bodyV0;
+  };
+  std::vector<SubVertex> subVertices;
+
+  // Bachelors of the collision sorted by the azimuth of their momentum. The bachelors of a sub-vertex are looked up in
+  // a window in phi (and eta) around the 2-body momentum: with the small Q value of the 3-body decay, the daughters
+  // are collimated with the mother.
+  struct BachelorIndex {
+    std::vector<int> slot; // positions in the track cache, sorted by phi
+    std::vector<float> phi;
+    std::vector<float> eta;
+  } bachIndex;
+  std::vector<int> bachSlots; // bachelors of the current sub-vertex
+  std::vector<int> posSlots; // positions of the positive tracks in the track cache
+  std::vector<int> negSlots; // positions of the negative tracks in the track cache
+
+  // Adds a track to the cache if not there yet, returns its position in the cache
+  template <bool isMC, typename TTrack>
+  int AddToTrackCache(TTrack const& track)
+  {
+    auto found = trackCache.slot.find(track.globalIndex());
+    if (found != trackCache.slot.end()) {
+      return found->second;
+    }
+    const int slot = trackCache.globalIndex.size();
+    trackCache.slot[track.globalIndex()] = slot;
+    trackCache.globalIndex.push_back(track.globalIndex());
+    trackCache.collisionId.push_back(track.collisionId());
+    trackCache.sign.push_back(track.sign());
+    trackCache.trackParCov.push_back(getTrackParCov(track));
+    trackCache.hasDcaToPV.push_back(false);
+    trackCache.dcaXYToPV.push_back(0.f);
+    trackCache.dcaToPV.push_back(0.f);
+    int pdg = 0, h3lMother = -1;
+    if constexpr (isMC) {
+      if (track.has_mcParticle()) {
+        auto mcparticle = track.template mcParticle_as<aod::McParticles>();
+        pdg = mcparticle.pdgCode();
+        if (mcparticle.has_mothers()) {
+          for (auto& mother : mcparticle.template mothers_as<aod::McParticles>()) {
+            if (std::abs(mother.pdgCode()) == 1010010030) {
+              h3lMother = mother.globalIndex();
+              break;
+            }
+          }
+        }
+      }
+    }
+    trackCache.mcPdg.push_back(pdg);
+    trackCache.mcH3LMother.push_back(h3lMother);
+    return slot;
+  }
+
+  // Fills the cache with the good tracks, which are the bachelor candidates and occupy the first positions of the cache
+  template <class TTrackClass, bool isMC, typename TGoodTrackTable>
+  void FillTrackCache(TGoodTrackTable const& dGoodtracks)
+  {
+    trackCache.globalIndex.clear();
+    trackCache.collisionId.clear();
+    trackCache.sign.clear();
+    trackCache.trackParCov.clear();
+    trackCache.mcPdg.clear();
+    trackCache.mcH3LMother.clear();
+    trackCache.hasDcaToPV.clear();
+    trackCache.dcaXYToPV.clear();
+    trackCache.dcaToPV.clear();
+    trackCache.slot.clear();
+    for (auto& goodtrackid : dGoodtracks) {
+      AddToTrackCache<isMC>(goodtrackid.template goodTrack_as<TTrackClass>());
+    }
+  }
+
+  // Positions of the positive and negative tracks in the cache. They are added to the cache if they are not among the
+  // good tracks, as in the processCheck mode of the prefilter, where the 3 daughters are written to separate tables.
+  template <class TTrackClass, bool isMC, typename TPosTrackTable, typename TNegTrackTable>
+  void FillSlots(TPosTrackTable const& dPtracks, TNegTrackTable const& dNtracks, std::vector<int>& posSlots, std::vector<int>& negSlots)
+  {
+    posSlots.clear();
+    negSlots.clear();
+    for (auto& t0id : dPtracks) {
+      posSlots.push_back(AddToTrackCache<isMC>(t0id.template goodTrack_as<TTrackClass>()));
+    }
+    for (auto& t1id : dNtracks) {
+      negSlots.push_back(AddToTrackCache<isMC>(t1id.template goodTrack_as<TTrackClass>()));
+    }
+  }
+
+  // DCA of a cached track to the PV, propagated only once per track
+  template <typename TCollisionTable>
+  void GetDcaToPV(TCollisionTable const& dCollision, int slot, float& dcaXY, float& dca)
+  {
+    if (!trackCache.hasDcaToPV[slot]) {
+      gpu::gpustd::array<float, 2> dcaInfo;
+      o2::track::TrackPar trackPar = trackCache.trackParCov[slot];
+      o2::base::Propagator::Instance()->propagateToDCABxByBz({dCollision.posX(), dCollision.posY(), dCollision.posZ()}, trackPar, 2.f, fitter3body.getMatCorrType(), &dcaInfo);
+      trackCache.dcaXYToPV[slot] = dcaInfo[0];
+      trackCache.dcaToPV[slot] = std::sqrt(dcaInfo[0] * dcaInfo[0] + dcaInfo[1] * dcaInfo[1]);
+      trackCache.hasDcaToPV[slot] = true;
+    }
+    dcaXY = trackCache.dcaXYToPV[slot];
+    dca = trackCache.dcaToPV[slot];
+  }
+
+  void FillBachelorIndex(int nBach)
+  {
+    bachIndex.slot.resize(nBach);
+    std::iota(bachIndex.slot.begin(), bachIndex.slot.end(), 0);
+    std::sort(bachIndex.slot.begin(), bachIndex.slot.end(), [this](int a, int b) { return trackCache.trackParCov[a].getPhi() < trackCache.trackParCov[b].getPhi(); });
+    bachIndex.phi.clear();
+    bachIndex.eta.clear();
+    for (const auto& slot : bachIndex.slot) {
+      bachIndex.phi.push_back(trackCache.trackParCov[slot].getPhi());
+      bachIndex.eta.push_back(trackCache.trackParCov[slot].getEta());
+    }
+  }
+
+  // Bachelors within maxBachDeltaPhiToV0 and maxBachDeltaEtaToV0 of the sub-vertex momentum, in track cache order
+  void GetBachelors(SubVertex const& subVertex, int nBach, std::vector<int>& slots)
+  {
+    slots.clear();
+    if (maxBachDeltaPhiToV0 < 0 || maxBachDeltaPhiToV0 >= o2::constants::math::PI) {
+      for (int bach = 0; bach < nBach; bach++) {
+        if (maxBachDeltaEtaToV0 < 0 || std::abs(trackCache.trackParCov[bach].getEta() - subVertex.eta) < maxBachDeltaEtaToV0) {
+          slots.push_back(bach);
+        }
+      }
+      return;
+    }
+    auto addRange = [&](float phiMin, float phiMax) {
+      auto first = std::lower_bound(bachIndex.phi.begin(), bachIndex.phi.end(), phiMin) - bachIndex.phi.begin();
+      auto last = std::upper_bound(bachIndex.phi.begin(), bachIndex.phi.end(), phiMax) - bachIndex.phi.begin();
+      for (auto i = first; i < last; i++) {
+        if (maxBachDeltaEtaToV0 < 0 || std::abs(bachIndex.eta[i] - subVertex.eta) < maxBachDeltaEtaToV0) {
+          slots.push_back(bachIndex.slot[i]);
+        }
+      }
+    };
+    // the phi of the tracks is in [0, 2pi), a window across 0 is split in two ranges
+    float phiMin = subVertex.phi - maxBachDeltaPhiToV0, phiMax = subVertex.phi + maxBachDeltaPhiToV0;
+    if (phiMin < 0) {
+      addRange(0, phiMax);
+      addRange(phiMin + o2::constants::math::TwoPI, o2::constants::math::TwoPI);
+    } else if (phiMax >= o2::constants::math::TwoPI) {
+      addRange(phiMin, o2::constants::math::TwoPI);
+      addRange(0, phiMax - o2::constants::math::TwoPI);
+    } else {
+      addRange(phiMin, phiMax);
+    }
+    std::sort(slots.begin(), slots.end());
+  }
+
+  bool IsTrue3bodyV0(int pos, int neg)
+  {
+    int pdgP = trackCache.mcPdg[pos], pdgN = trackCache.mcPdg[neg];
+    if (!((pdgP == 2212 && pdgN == -211) || (pdgP == 211 && pdgN == -2212))) {
+      return false;
+    }
+    return trackCache.mcH3LMother[pos] >= 0 && trackCache.mcH3LMother[pos] == trackCache.mcH3LMother[neg];
+  }
+
+  bool IsTrue3bodyVtx(int pos, int neg, int bach)
+  {
+    int pdgP = trackCache.mcPdg[pos], pdgN = trackCache.mcPdg[neg], pdgB = trackCache.mcPdg[bach];
+    if (!((pdgP == 2212 && pdgN == -211 && pdgB == 1000010020) || (pdgP == 211 && pdgN == -2212 && pdgB == -1000010020))) {
+      return false;
+    }
+    return trackCache.mcH3LMother[pos] >= 0 && trackCache.mcH3LMother[pos] == trackCache.mcH3LMother[neg] && trackCache.mcH3LMother[pos] == trackCache.mcH3LMother[bach];
+  }
+
   //------------------------------------------------------------------
   // Virtual Lambda V0 finder
-  template <class TTrackClass, typename TCollisionTable, typename TTrackTable>
-  bool DecayV0Finder(TCollisionTable const& dCollision, TTrackTable const& dPtrack, TTrackTable const& dNtrack, float& rv0, bool isTrue3bodyV0 = false)
+  template <typename TCollisionTable>
+  bool DecayV0Finder(TCollisionTable const& dCollision, int pos, int neg, float& rv0, bool isTrue3bodyV0 = false)
   {
-    if (dPtrack.collisionId() != dNtrack.collisionId()) {
+    if (trackCache.collisionId[pos] != trackCache.collisionId[neg]) {
       return false;
     }
     FillV0Counter(kV0All, isTrue3bodyV0);
@@ -526,9 +728,7 @@ struct hypertriton3bodyFinder {
       return false;
     }
 
-    auto Track0 = getTrackParCov(dPtrack);
-    auto Track1 = getTrackParCov(dNtrack);
-    int nCand = fitter.process(Track0, Track1);
+    int nCand = fitter.process(trackCache.trackParCov[pos], trackCache.trackParCov[neg]);
     if (nCand == 0) {
       return false;
     }
@@ -604,13 +804,14 @@ struct hypertriton3bodyFinder {
   }
   //------------------------------------------------------------------
   // 3body decay vertex finder
-  template <class TTrackClass, typename TCollisionTable, typename TTrackTable>
-  void Decay3bodyFinder(TCollisionTable const& dCollision, TTrackTable const& dPtrack, TTrackTable const& dNtrack, TTrackTable const& dBachtrack, float const& rv0, bool isTrue3bodyVtx = false)
+  template <typename TCollisionTable>
+  void Decay3bodyFinder(TCollisionTable const& dCollision, SubVertex const& subVertex, int bach, bool isTrue3bodyVtx = false)
   {
-    if (dPtrack.collisionId() != dBachtrack.collisionId()) {
+    const int pos = subVertex.pos, neg = subVertex.neg;
+    if (trackCache.collisionId[pos] != trackCache.collisionId[bach]) {
       return;
     }
-    if (dPtrack.globalIndex() == dBachtrack.globalIndex()) {
+    if (pos == bach) {
       return; // skip the track used by V0
     }
     FillVtxCounter(kVtxAll, isTrue3bodyVtx);
@@ -618,16 +819,24 @@ struct hypertriton3bodyFinder {
       return;
     }
 
-    auto track0 = getTrackParCov(dPtrack);
-    auto track1 = getTrackParCov(dNtrack);
-    auto bach = getTrackParCov(dBachtrack);
+    const auto& track0 = trackCache.trackParCov[pos];
+    const auto& track1 = trackCache.trackParCov[neg];
+    const auto& bachTrack = trackCache.trackParCov[bach];
 
-    if (bach.getPt() < minbachPt) {
+    if (bachTrack.getPt() < minbachPt) {
       return;
     }
     FillVtxCounter(kVtxbachPt, isTrue3bodyVtx);
 
-    int n3bodyVtx = fitter3body.process(track0, track1, bach);
+    // optional preselection of the bachelor around the 2-body vertex, before the 3-body fit
+    if (maxBachDCAToV0 > 0) {
+      o2::track::TrackPar bachPar = bachTrack;
+      if (!bachPar.propagateParamToDCA({subVertex.xyz[0], subVertex.xyz[1], subVertex.xyz[2]}, d_bz, nullptr, maxBachDCAToV0)) {
+        return;
+      }
+    }
+
+    int n3bodyVtx = fitter3body.process(track0, track1, bachTrack);
     if (n3bodyVtx == 0) { // discard this pair
       return;
     }
@@ -637,7 +846,7 @@ struct hypertriton3bodyFinder {
     // make sure the cascade radius is smaller than that of the vertex
     float dxc = vertexXYZ[0] - dCollision.posX(), dyc = vertexXYZ[1] - dCollision.posY(), dzc = vertexXYZ[2] - dCollision.posZ(), r2vertex = dxc * dxc + dyc * dyc;
     float rvertex = std::sqrt(r2vertex);
-    if (std::abs(rv0 - rvertex) > maxRDiff3bodyV0 || rvertex < minRToMeanVertex) {
+    if (std::abs(subVertex.rv0 - rvertex) > maxRDiff3bodyV0 || rvertex < minRToMeanVertex) {
       return;
     }
     FillVtxCounter(kVtxRadius, isTrue3bodyVtx);
@@ -682,26 +891,14 @@ struct hypertriton3bodyFinder {
     FillVtxCounter(kVtxDcaDau, isTrue3bodyVtx);
 
     // Calculate DCA with respect to the collision associated to the V0, not individual tracks
-    gpu::gpustd::array<float, 2> dcaInfo;
-
-    auto Track0Par = getTrackPar(dPtrack);
-    o2::base::Propagator::Instance()->propagateToDCABxByBz({dCollision.posX(), dCollision.posY(), dCollision.posZ()}, Track0Par, 2.f, fitter3body.getMatCorrType(), &dcaInfo);
-    auto Track0dcaXY = dcaInfo[0];
-    auto Track0dca = std::sqrt(Track0dcaXY * Track0dcaXY + dcaInfo[1] * dcaInfo[1]);
-
-    auto Track1Par = getTrackPar(dNtrack);
-    o2::base::Propagator::Instance()->propagateToDCABxByBz({dCollision.posX(), dCollision.posY(), dCollision.posZ()}, Track1Par, 2.f, fitter3body.getMatCorrType(), &dcaInfo);
-    auto Track1dcaXY = dcaInfo[0];
-    auto Track1dca = std::sqrt(Track1dcaXY * Track1dcaXY + dcaInfo[1] * dcaInfo[1]);
-
-    auto Track2Par = getTrackPar(dBachtrack);
-    o2::base::Propagator::Instance()->propagateToDCABxByBz({dCollision.posX(), dCollision.posY(), dCollision.posZ()}, Track2Par, 2.f, fitter3body.getMatCorrType(), &dcaInfo);
-    auto Track2dcaXY = dcaInfo[0];
-    auto Track2dca = std::sqrt(Track2dcaXY * Track2dcaXY + dcaInfo[1] * dcaInfo[1]);
+    float Track0dcaXY, Track0dca, Track1dcaXY, Track1dca, Track2dcaXY, Track2dca;
+    GetDcaToPV(dCollision, pos, Track0dcaXY, Track0dca);
+    GetDcaToPV(dCollision, neg, Track1dcaXY, Track1dca);
+    GetDcaToPV(dCollision, bach, Track2dcaXY, Track2dca);
 
     // H3L DCA Check
     // auto track3B = o2::track::TrackParCov(vertexXYZ, p3B, fitter3body.calcPCACovMatrixFlat(), t2.sign());
-    auto track3B = o2::track::TrackParCov(vertexXYZ, p3B, dBachtrack.sign());
+    auto track3B = o2::track::TrackParCov(vertexXYZ, p3B, trackCache.sign[bach]);
     o2::dataformats::DCA dca;
     if (d_UseH3LDCACut && (!track3B.propagateToDCA({{dCollision.posX(), dCollision.posY(), dCollision.posZ()}, {dCollision.covXX(), dCollision.covXY(), dCollision.covYY(), dCollision.covXZ(), dCollision.covYZ(), dCollision.covZZ()}}, fitter3body.getBz(), &dca, 5.) ||
                            std::abs(dca.getY()) > maxDCAXY3Body || std::abs(dca.getZ()) > maxDCAZ3Body)) {
@@ -710,7 +907,7 @@ struct hypertriton3bodyFinder {
     FillVtxCounter(kVtxDcaH3L, isTrue3bodyVtx);
 
     vtx3bodydata(
-      dPtrack.globalIndex(), dNtrack.globalIndex(), dBachtrack.globalIndex(), dCollision.globalIndex(), 0,
+      trackCache.globalIndex[pos], trackCache.globalIndex[neg], trackCache.globalIndex[bach], dCollision.globalIndex(), 0,
       vertexXYZ[0], vertexXYZ[1], vertexXYZ[2],
       p0[0], p0[1], p0[2], p1[0], p1[1], p1[2], p2[0], p2[1], p2[2],
       fitter3body.getChi2AtPCACandidate(),
@@ -720,88 +917,43 @@ struct hypertriton3bodyFinder {
   }
   //------------------------------------------------------------------
   // 3body decay finder for a collsion
-  template <class TTrackClass, typename TCollisionTable, typename TPosTrackTable, typename TNegTrackTable, typename TGoodTrackTable>
+  // The accepted 2-body sub-vertices are collected first, then each of them is combined with the bachelors found around
+  // its momentum in the bachelor index (all bachelors by default).
+  template <class TTrackClass, bool isMC = false, typename TCollisionTable, typename TPosTrackTable, typename TNegTrackTable, typename TGoodTrackTable>
   void DecayFinder(TCollisionTable const& dCollision, TPosTrackTable const& dPtracks, TNegTrackTable const& dNtracks, TGoodTrackTable const& dGoodtracks)
   {
-    for (auto& t0id : dPtracks) { // FIXME: turn into combination(...)
-      auto t0 = t0id.template goodTrack_as<TTrackClass>();
-
-      for (auto& t1id : dNtracks) {
-        auto t1 = t1id.template goodTrack_as<TTrackClass>();
-        float rv0;
-        if (!DecayV0Finder<TTrackClass>(dCollision, t0, t1, rv0)) {
+    FillTrackCache<TTrackClass, isMC>(dGoodtracks);
+    const int nBach = trackCache.globalIndex.size(); // the good tracks are the first entries of the cache
+    FillSlots<TTrackClass, isMC>(dPtracks, dNtracks, posSlots, negSlots);
+
+    subVertices.clear();
+    for (const auto& pos : posSlots) {
+      for (const auto& neg : negSlots) {
+        if (isMC && trackCache.collisionId[pos] != trackCache.collisionId[neg]) {
           continue;
         }
-
-        for (auto& t2id : dGoodtracks) {
-          auto t2 = t2id.template goodTrack_as<TTrackClass>();
-          Decay3bodyFinder<TTrackClass>(dCollision, t0, t1, t2, rv0);
-        }
-      }
-    }
-    fillHistos();
-    resetHistos();
-  }
-  //------------------------------------------------------------------
-  // MC 3body decay vertex finder
-  template <class TTrackClass, typename TCollisionTable, typename TPosTrackTable, typename TNegTrackTable, typename TGoodTrackTable>
-  void DecayFinderMC(TCollisionTable const& dCollision, TPosTrackTable const& dPtracks, TNegTrackTable const& dNtracks, TGoodTrackTable const& dGoodtracks)
-  {
-    for (auto& t0id : dPtracks) { // FIXME: turn into combination(...)
-      auto t0 = t0id.template goodTrack_as<TTrackClass>();
-      for (auto& t1id : dNtracks) {
-        auto t1 = t1id.template goodTrack_as<TTrackClass>();
-        if (t0.collisionId() != t1.collisionId()) {
-          continue;
-        }
-
-        bool isTrue3bodyV0 = false;
-        if (t0.has_mcParticle() && t1.has_mcParticle()) {
-          auto t0mc = t0.template mcParticle_as<aod::McParticles>();
-          auto t1mc = t1.template mcParticle_as<aod::McParticles>();
-          if ((t0mc.pdgCode() == 2212 && t1mc.pdgCode() == -211) || (t0mc.pdgCode() == 211 && t1mc.pdgCode() == -2212)) {
-            if (t0mc.has_mothers() && t1mc.has_mothers()) {
-              for (auto& t0mother : t0mc.template mothers_as<aod::McParticles>()) {
-                for (auto& t1mother : t1mc.template mothers_as<aod::McParticles>()) {
-                  if (t0mother.globalIndex() == t1mother.globalIndex() && std::abs(t0mother.pdgCode()) == 1010010030) {
-                    isTrue3bodyV0 = true;
-                  }
-                }
-              }
-            }
-          }
-        }
-
+        bool isTrue3bodyV0 = isMC && IsTrue3bodyV0(pos, neg);
         float rv0;
-        if (!DecayV0Finder<TTrackClass>(dCollision, t0, t1, rv0, isTrue3bodyV0)) {
+        if (!DecayV0Finder(dCollision, pos, neg, rv0, isTrue3bodyV0)) {
           continue;
         }
+        const auto& v0XYZ = fitter.getPCACandidate();
+        std::array<float, 3> pP, pN;
+        fitter.getTrack(0).getPxPyPzGlo(pP);
+        fitter.getTrack(1).getPxPyPzGlo(pN);
+        std::array<float, 3> pV0 = {pP[0] + pN[0], pP[1] + pN[1], pP[2] + pN[2]};
+        subVertices.push_back({pos, neg, rv0, {static_cast<float>(v0XYZ[0]), static_cast<float>(v0XYZ[1]), static_cast<float>(v0XYZ[2])}, static_cast<float>(RecoDecay::phi(pV0)), static_cast<float>(RecoDecay::eta(pV0)), isTrue3bodyV0});
+      }
+    }
 
-        for (auto& t2id : dGoodtracks) {
-          auto t2 = t2id.template goodTrack_as<TTrackClass>();
-
-          bool isTrue3bodyVtx = false;
-          if (t0.has_mcParticle() && t1.has_mcParticle() && t2.has_mcParticle()) {
-            auto t0mc = t0.template mcParticle_as<aod::McParticles>();
-            auto t1mc = t1.template mcParticle_as<aod::McParticles>();
-            auto t2mc = t2.template mcParticle_as<aod::McParticles>();
-            if ((t0mc.pdgCode() == 2212 && t1mc.pdgCode() == -211 && t2mc.pdgCode() == 1000010020) || (t0mc.pdgCode() == 211 && t1mc.pdgCode() == -2212 && t2mc.pdgCode() == -1000010020)) {
-              if (t0mc.has_mothers() && t1mc.has_mothers() && t2mc.has_mothers()) {
-                for (auto& t0mother : t0mc.template mothers_as<aod::McParticles>()) {
-                  for (auto& t1mother : t1mc.template mothers_as<aod::McParticles>()) {
-                    for (auto& t2mother : t2mc.template mothers_as<aod::McParticles>()) {
-                      if (t0mother.globalIndex() == t1mother.globalIndex() && t0mother.globalIndex() == t2mother.globalIndex() && std::abs(t0mother.pdgCode()) == 1010010030) {
-                        isTrue3bodyVtx = true;
-                      }
-                    }
-                  }
-                }
-              }
-            }
-          }
-
-          Decay3bodyFinder<TTrackClass>(dCollision, t0, t1, t2, rv0, isTrue3bodyVtx);
-        }
+    if (maxBachDeltaPhiToV0 >= 0) {
+      FillBachelorIndex(nBach);
+    }
+    for (const auto& subVertex : subVertices) {
+      GetBachelors(subVertex, nBach, bachSlots);
+      for (const auto& bach : bachSlots) {
+        bool isTrue3bodyVtx = isMC && IsTrue3bodyVtx(subVertex.pos, subVertex.neg, bach);
+        Decay3bodyFinder(dCollision, subVertex, bach, isTrue3bodyVtx);
       }
     }
     fillHistos();
@@ -882,7 +1034,7 @@ struct hypertriton3bodyFinder {
     registry.fill(HIST("hEventCounter"), 0.5);
 
     CheckGoodTracks<MCLabeledTracksIU>(goodtracks, particlesMC);
-    DecayFinderMC<MCLabeledTracksIU>(collision, ptracks, ntracks, goodtracks);
+    DecayFinder<MCLabeledTracksIU, true>(collision, ptracks, ntracks, goodtracks);
   }
   PROCESS_SWITCH(hypertriton3bodyFinder, processMC, "Produce StoredVtx3BodyDatas with MC", false);
 
@@ -912,7 +1064,7 @@ struct hypertriton3bodyFinder {
 
       VirtualLambdaCheck<MCLabeledTracksIU>(collision, v0s, 6);
       VirtualLambdaCheck<MCLabeledTracksIU>(collision, fullv0s, 9);
-      DecayFinderMC<MCLabeledTracksIU>(collision, ptracks, ntracks, goodtracks);
+      DecayFinder<MCLabeledTracksIU, true>(collision, ptracks, ntracks, goodtracks);
     }
   }
   PROCESS_SWITCH(hypertriton3bodyFinder, processCFFilteredMC, "Produce StoredVtx3BodyDatas with MC using CFtriggers", false);
@@ -57,6 +57,7 @@
 
 #include "PWGLF/DataModel/EPCalibrationTables.h"
 #include "PWGLF/DataModel/LFSlimNucleiTables.h"
+#include "PWGLF/Utils/nucleiUtils.h"
 
 #include "TRandom3.h"
 
@@ -298,6 +299,8 @@ struct nucleiSpectra {
   Configurable<std::string> cfgZorroCCDBpath{"cfgZorroCCDBpath", "/Users/m/mpuccio/EventFiltering/OTS/", "path to the zorro ccdb objects"};
   int mRunNumber = 0;
   float mBz = 0.f;
+  nuclei::TpcNsigmaKernel<nuclei::species> mTpcNsigmaKernel;
+  std::vector<int> mTrackEntries; // index of the tracks in mTpcNsigmaKernel, -1 if not selected
 
   Filter trackFilter = nabs(aod::track::eta) < cfgCutEta && aod::track::tpcInnerParam > cfgCutTpcMom;
 
@@ -457,6 +460,13 @@ struct nucleiSpectra {
         nuclei::pidCuts[0][iS][iMax] = cfgNsigmaTPC->get(iS, iMax);
       }
     }
+    for (int iS{0}; iS < nuclei::species; ++iS) {
+      const unsigned int iScaling = iS == 4 ? 3u : iS; /// the alpha uses the momentum scaling of the He3
+      mTpcNsigmaKernel.setHypothesis(iS,
+                                     {nuclei::charges[iS] * cfgMomentumScalingBetheBloch->get(iScaling, 0u) / nuclei::masses[iS], nuclei::charges[iS] * cfgMomentumScalingBetheBloch->get(iScaling, 1u) / nuclei::masses[iS]},
+                                     {cfgBetheBlochParams->get(iS, 0u), cfgBetheBlochParams->get(iS, 1u), cfgBetheBlochParams->get(iS, 2u), cfgBetheBlochParams->get(iS, 3u), cfgBetheBlochParams->get(iS, 4u)},
+                                     cfgBetheBlochParams->get(iS, 5u), nuclei::pidCuts[0][iS][0], nuclei::pidCuts[0][iS][1]);
+    }
 
     nuclei::lut = o2::base::MatLayerCylSet::rectifyPtrFromFile(ccdb->get<o2::base::MatLayerCylSet>("GLO/Param/MatLUT"));
     // TrackTuner initialization
@@ -508,15 +518,13 @@ struct nucleiSpectra {
 
     float centrality = getCentrality(collision);
 
-    const double bgScalings[5][2]{
-      {nuclei::charges[0] * cfgMomentumScalingBetheBloch->get(0u, 0u) / nuclei::masses[0], nuclei::charges[0] * cfgMomentumScalingBetheBloch->get(0u, 1u) / nuclei::masses[0]},
-      {nuclei::charges[1] * cfgMomentumScalingBetheBloch->get(1u, 0u) / nuclei::masses[1], nuclei::charges[1] * cfgMomentumScalingBetheBloch->get(1u, 1u) / nuclei::masses[1]},
-      {nuclei::charges[2] * cfgMomentumScalingBetheBloch->get(2u, 0u) / nuclei::masses[2], nuclei::charges[2] * cfgMomentumScalingBetheBloch->get(2u, 1u) / nuclei::masses[2]},
-      {nuclei::charges[3] * cfgMomentumScalingBetheBloch->get(3u, 0u) / nuclei::masses[3], nuclei::charges[3] * cfgMomentumScalingBetheBloch->get(3u, 1u) / nuclei::masses[3]},
-      {nuclei::charges[4] * cfgMomentumScalingBetheBloch->get(3u, 0u) / nuclei::masses[4], nuclei::charges[4] * cfgMomentumScalingBetheBloch->get(3u, 1u) / nuclei::masses[4]}};
-
+    /// first pass: track quality selection and TPC PID of all the hypotheses in one go
     int nGloTracks[2]{0, 0}, nTOFTracks[2]{0, 0};
-    for (auto& track : tracks) { // start loop over tracks
+    mTpcNsigmaKernel.clear();
+    mTrackEntries.assign(tracks.size(), -1);
+    int iRow{-1};
+    for (auto& track : tracks) {
+      iRow++;
       if (track.itsNCls() < cfgCutNclusITS ||
           track.tpcNClsFound() < cfgCutNclusTPC ||
           track.tpcNClsCrossedRows() < 70 ||
@@ -531,9 +539,6 @@ struct nucleiSpectra {
       float correctedTpcInnerParam = (heliumPID && cfgCompensatePIDinTracking) ? track.tpcInnerParam() / 2 : track.tpcInnerParam();
 
       spectra.fill(HIST("hTpcSignalData"), correctedTpcInnerParam * track.sign(), track.tpcSignal());
-      float nSigma[2][5]{
-        {-10., -10., -10., -10., -10.},
-        {0.f, 0.f, 0.f, 0.f, 0.f}}; /// then we will calibrate the TOF mass for the He3 and Alpha
       const int iC{track.sign() < 0};
 
       /// Checking if we have outliers in the TPC-TOF correlation
@@ -541,23 +546,34 @@ struct nucleiSpectra {
       if (track.hasTOF()) {
         nTOFTracks[iC]++;
       }
+      mTrackEntries[iRow] = mTpcNsigmaKernel.add(correctedTpcInnerParam, track.tpcSignal(), iC);
+    }
+    mTpcNsigmaKernel.evaluate();
+
+    /// second pass: tracks selected by the TPC PID of at least one hypothesis
+    iRow = -1;
+    for (auto& track : tracks) { // start loop over tracks
+      iRow++;
+      const int iEntry{mTrackEntries[iRow]};
+      if (iEntry < 0 || !mTpcNsigmaKernel.isSelected(iEntry)) {
+        continue;
+      }
+      const float correctedTpcInnerParam{mTpcNsigmaKernel.getTpcInnerParam(iEntry)};
+      float nSigma[2][5]{
+        {-10., -10., -10., -10., -10.},
+        {0.f, 0.f, 0.f, 0.f, 0.f}}; /// then we will calibrate the TOF mass for the He3 and Alpha
+      const int iC{track.sign() < 0};
 
-      bool selectedTPC[5]{false}, goodToAnalyse{false};
+      bool selectedTPC[5]{false};
       std::array<float, 5> nSigmaTPC;
       for (int iS{0}; iS < nuclei::species; ++iS) {
-        double expBethe{tpc::BetheBlochAleph(static_cast<double>(correctedTpcInnerParam * bgScalings[iS][iC]), cfgBetheBlochParams->get(iS, 0u), cfgBetheBlochParams->get(iS, 1u), cfgBetheBlochParams->get(iS, 2u), cfgBetheBlochParams->get(iS, 3u), cfgBetheBlochParams->get(iS, 4u))};
-        double expSigma{expBethe * cfgBetheBlochParams->get(iS, 5u)};
-        nSigma[0][iS] = static_cast<float>((track.tpcSignal() - expBethe) / expSigma);
+        nSigma[0][iS] = mTpcNsigmaKernel.getNsigma(iS, iEntry);
         nSigmaTPC[iS] = nSigma[0][iS];
-        selectedTPC[iS] = (nSigma[0][iS] > nuclei::pidCuts[0][iS][0] && nSigma[0][iS] < nuclei::pidCuts[0][iS][1]);
-        goodToAnalyse = goodToAnalyse || selectedTPC[iS];
+        selectedTPC[iS] = mTpcNsigmaKernel.isSelected(iEntry, iS);
         if (selectedTPC[iS] && track.p() > 0.2) {
           nuclei::hDeltaP[iC][iS]->Fill(track.p(), 1 - correctedTpcInnerParam / track.p());
         }
       }
-      if (!goodToAnalyse) {
-        continue;
-      }
 
       mDcaInfoCov.set(999, 999, 999, 999, 999);
       setTrackParCov(track, mTrackParCov);
@@ -42,6 +42,7 @@
 #include <map>
 #include <iterator>
 #include <utility>
+#include <vector>
 
 #include "Framework/runDataProcessing.h"
 #include "Framework/RunningWorkflowInfo.h"
@@ -165,6 +166,7 @@ struct cascadeBuilder {
   Configurable<bool> d_QA_checkMC{"d_QA_checkMC", true, "check MC truth in QA"};
   Configurable<bool> d_QA_checkdEdx{"d_QA_checkdEdx", false, "check dEdx in QA"};
   Configurable<bool> calculateBachBaryonVars{"calculateBachBaryonVars", false, "calculate variables for removing cascade inv mass bump"};
+  Configurable<bool> useV0Cache{"useV0Cache", true, "build each V0 once per DF and reuse it for all the cascades sharing it"};
 
   // CCDB options
   struct : ConfigurableGroup {
@@ -328,6 +330,31 @@ struct cascadeBuilder {
   o2::track::TrackParCov lV0Track;
   o2::track::TrackParCov lCascadeTrack;
 
+  // Per-DF cache of the V0 part of the cascade building, indexed by V0 (a V0 is shared by many bachelors)
+  // status: -1 not built yet, 0 rejected, 1 accepted
+  struct V0CacheEntry {
+    int8_t v0TrackStatus = -1;
+    o2::track::TrackParCov v0Track; // from the V0 tables (standard building)
+
+    int8_t dcaFitStatus = -1;
+    float v0dcadau = 0.f;
+    o2::track::TrackParCov posTrackParCov; // daughters at the DCA fitter minimum (KF building)
+    o2::track::TrackParCov negTrackParCov;
+
+    std::array<int8_t, 2> kfStatus = {-1, -1}; // per bachelor charge, i.e. per daughter mass hypothesis
+    std::array<KFParticle, 2> kfV0;
+    std::array<o2::track::TrackParCov, 2> kfV0TrackParCov;
+  };
+  std::vector<V0CacheEntry> v0Cache;
+
+  void resetV0Cache(std::size_t nV0s)
+  {
+    v0Cache.clear();
+    if (useV0Cache) {
+      v0Cache.resize(nV0s);
+    }
+  }
+
   // Helper struct to do bookkeeping of building parameters
   struct {
     std::array<int32_t, kNCascSteps> cascstats;
@@ -336,12 +363,15 @@ struct cascadeBuilder {
     std::array<int32_t, 10> bachITSclu;
     int32_t exceptions;
     int32_t eventCounter;
+    int32_t v0CacheLookups;
+    int32_t v0CacheHits;
   } statisticsRegistry;
 
   HistogramRegistry registry{
     "registry",
     {{"hEventCounter", "hEventCounter", {HistType::kTH1D, {{1, 0.0f, 1.0f}}}},
      {"hCaughtExceptions", "hCaughtExceptions", {HistType::kTH1D, {{1, 0.0f, 1.0f}}}},
+     {"hV0CacheStatistics", "hV0CacheStatistics", {HistType::kTH1D, {{2, -0.5f, 1.5f}}}},
      {"hPositiveITSClusters", "hPositiveITSClusters", {HistType::kTH1D, {{10, -0.5f, 9.5f}}}},
      {"hNegativeITSClusters", "hNegativeITSClusters", {HistType::kTH1D, {{10, -0.5f, 9.5f}}}},
      {"hBachelorITSClusters", "hBachelorITSClusters", {HistType::kTH1D, {{10, -0.5f, 9.5f}}}}}};
@@ -369,6 +399,8 @@ struct cascadeBuilder {
   {
     statisticsRegistry.exceptions = 0;
     statisticsRegistry.eventCounter = 0;
+    statisticsRegistry.v0CacheLookups = 0;
+    statisticsRegistry.v0CacheHits = 0;
     for (Int_t ii = 0; ii < kNCascSteps; ii++)
       statisticsRegistry.cascstats[ii] = 0;
     for (Int_t ii = 0; ii < 10; ii++) {
@@ -382,6 +414,8 @@ struct cascadeBuilder {
   {
     registry.fill(HIST("hEventCounter"), 0.0, statisticsRegistry.eventCounter);
     registry.fill(HIST("hCaughtExceptions"), 0.0, statisticsRegistry.exceptions);
+    registry.fill(HIST("hV0CacheStatistics"), 0.0, statisticsRegistry.v0CacheLookups);
+    registry.fill(HIST("hV0CacheStatistics"), 1.0, statisticsRegistry.v0CacheHits);
     for (Int_t ii = 0; ii < kNCascSteps; ii++)
       registry.fill(HIST("hCascadeCriteria"), ii, statisticsRegistry.cascstats[ii]);
     if (d_doTrackQA) {
@@ -397,6 +431,8 @@ struct cascadeBuilder {
   {
     resetHistos();
     registry.add("hKFParticleStatistics", "hKFParticleStatistics", kTH1F, {{10, -0.5f, 9.5f}});
+    registry.get<TH1>(HIST("hV0CacheStatistics"))->GetXaxis()->SetBinLabel(1, "Lookups");
+    registry.get<TH1>(HIST("hV0CacheStatistics"))->GetXaxis()->SetBinLabel(2, "Hits");
 
     auto h = registry.add<TH1>("hCascadeCriteria", "hCascadeCriteria", kTH1D, {{10, -0.5f, 9.5f}});
     h->GetXaxis()->SetBinLabel(1, "All sel");
@@ -702,6 +738,7 @@ struct cascadeBuilder {
     if (mRunNumber == bc.runNumber()) {
       return;
     }
+    resetV0Cache(v0Cache.size()); // V0s built with the previous magnetic field
 
     // machine learning initialization if requested
     if (mlConfigurations.calculateXiMinusScores ||
@@ -933,7 +970,7 @@ struct cascadeBuilder {
   }
 
   template <class TTrackTo, typename TCascObject, typename TV0Object>
-  bool buildCascadeCandidate(TCascObject const& cascade, TV0Object const& v0)
+  bool buildCascadeCandidate(TCascObject const& cascade, TV0Object const& v0, int v0CacheIndex = -1)
   {
     // value 0.5: any considered cascade
     statisticsRegistry.cascstats[kCascAll]++;
@@ -997,19 +1034,33 @@ struct cascadeBuilder {
     // Do actual minimization
     lBachelorTrack = getTrackParCov(bachTrack);
 
-    // Set up covariance matrices (should in fact be optional)
-    std::array<float, 21> covV = {0.};
-    constexpr int MomInd[6] = {9, 13, 14, 18, 19, 20}; // cov matrix elements for momentum component
-    for (int i = 0; i < 6; i++) {
-      covV[MomInd[i]] = v0.momentumCovMat()[i];
-      covV[i] = v0.positionCovMat()[i];
+    V0CacheEntry* cached = nullptr;
+    if (v0CacheIndex >= 0 && v0CacheIndex < static_cast<int>(v0Cache.size())) {
+      cached = &v0Cache[v0CacheIndex];
+      statisticsRegistry.v0CacheLookups++;
+    }
+    if (cached && cached->v0TrackStatus == 1) {
+      statisticsRegistry.v0CacheHits++;
+      lV0Track = cached->v0Track;
+    } else {
+      // Set up covariance matrices (should in fact be optional)
+      std::array<float, 21> covV = {0.};
+      constexpr int MomInd[6] = {9, 13, 14, 18, 19, 20}; // cov matrix elements for momentum component
+      for (int i = 0; i < 6; i++) {
+        covV[MomInd[i]] = v0.momentumCovMat()[i];
+        covV[i] = v0.positionCovMat()[i];
+      }
+      lV0Track = o2::track::TrackParCov(
+        {v0.x(), v0.y(), v0.z()},
+        {v0.pxpos() + v0.pxneg(), v0.pypos() + v0.pyneg(), v0.pzpos() + v0.pzneg()},
+        covV, 0, true);
+      lV0Track.setAbsCharge(0);
+      lV0Track.setPID(o2::track::PID::Lambda);
+      if (cached) {
+        cached->v0TrackStatus = 1;
+        cached->v0Track = lV0Track;
+      }
     }
-    lV0Track = o2::track::TrackParCov(
-      {v0.x(), v0.y(), v0.z()},
-      {v0.pxpos() + v0.pxneg(), v0.pypos() + v0.pyneg(), v0.pzpos() + v0.pzneg()},
-      covV, 0, true);
-    lV0Track.setAbsCharge(0);
-    lV0Track.setPID(o2::track::PID::Lambda);
 
     //---/---/---/
     // Move close to minima
@@ -1235,6 +1286,111 @@ struct cascadeBuilder {
     return true;
   }
 
+  // V0 of the KF cascade building: DCA fitter pre-minimisation of the daughters (optional), KF V0 with mass window
+  // and mass constraint, V0 track at the decay vertex. It depends only on the V0 and on the mass hypotheses of the
+  // daughters (i.e. on the bachelor charge), so it is done once per DF, V0 and hypothesis if the cache is enabled.
+  bool buildKFV0(int v0Index, int iCharge, float massPosTrack, float massNegTrack,
+                 o2::track::TrackParCov& posTrackParCov, o2::track::TrackParCov& negTrackParCov,
+                 KFParticle& KFV0, o2::track::TrackParCov& v0TrackParCov)
+  {
+    V0CacheEntry* cached = nullptr;
+    if (v0Index >= 0 && v0Index < static_cast<int>(v0Cache.size())) {
+      cached = &v0Cache[v0Index];
+      statisticsRegistry.v0CacheLookups++;
+      if (cached->kfStatus[iCharge] >= 0 || cached->dcaFitStatus == 0) {
+        statisticsRegistry.v0CacheHits++;
+      }
+    }
+
+    //__________________________________________
+    //*>~<* step 1 : V0 with dca fitter, uses material corrections implicitly
+    // This is optional - move close to minima and therefore take material
+    if (kfDoDCAFitterPreMinimV0) {
+      if (!cached || cached->dcaFitStatus < 0) {
+        int nCand = 0;
+        try {
+          nCand = fitter.process(posTrackParCov, negTrackParCov);
+        } catch (...) {
+          LOG(error) << "Exception caught in DCA fitter process call!";
+        }
+        if (cached) {
+          cached->dcaFitStatus = (nCand == 0) ? 0 : 1;
+        }
+        if (nCand == 0) {
+          return false;
+        }
+        // save classical DCA daughters
+        cascadecandidate.v0dcadau = TMath::Sqrt(fitter.getChi2AtPCACandidate());
+
+        // re-acquire from DCA fitter
+        posTrackParCov = fitter.getTrack(0);
+        negTrackParCov = fitter.getTrack(1);
+        if (cached) {
+          cached->v0dcadau = cascadecandidate.v0dcadau;
+          cached->posTrackParCov = posTrackParCov;
+          cached->negTrackParCov = negTrackParCov;
+        }
+      } else {
+        if (cached->dcaFitStatus == 0) {
+          return false;
+        }
+        cascadecandidate.v0dcadau = cached->v0dcadau;
+        posTrackParCov = cached->posTrackParCov;
+        negTrackParCov = cached->negTrackParCov;
+      }
+    }
+
+    if (cached && cached->kfStatus[iCharge] >= 0) {
+      if (cached->kfStatus[iCharge] == 0) {
+        return false;
+      }
+      KFV0 = cached->kfV0[iCharge];
+      v0TrackParCov = cached->kfV0TrackParCov[iCharge];
+      return true;
+    }
+    if (cached) {
+      cached->kfStatus[iCharge] = 0; // until the V0 is accepted
+    }
+
+    //__________________________________________
+    //*>~<* step 2 : V0 with KF
+    // create KFParticle objects from trackParCovs
+    KFParticle kfpPos = createKFParticleFromTrackParCov(posTrackParCov, posTrackParCov.getCharge(), massPosTrack);
+    KFParticle kfpNeg = createKFParticleFromTrackParCov(negTrackParCov, negTrackParCov.getCharge(), massNegTrack);
+    const KFParticle* V0Daughters[2] = {&kfpPos, &kfpNeg};
+
+    // construct V0
+    KFV0.SetConstructMethod(kfConstructMethod);
+    try {
+      KFV0.Construct(V0Daughters, 2);
+    } catch (std::runtime_error& e) {
+      LOG(debug) << "Failed to construct cascade V0 from daughter tracks: " << e.what();
+      return false;
+    }
+
+    // mass window cut on lambda before mass constraint
+    float massLam, sigLam;
+    KFV0.GetMass(massLam, sigLam);
+    if (TMath::Abs(massLam - 1.116) > lambdaMassWindow)
+      return false;
+
+    if (kfUseV0MassConstraint) {
+      KFV0.SetNonlinearMassConstraint(o2::constants::physics::MassLambda);
+    }
+
+    // V0 constructed, now recovering TrackParCov for dca fitter minimization (with material correction)
+    KFV0.TransportToDecayVertex();
+    v0TrackParCov = getTrackParCovFromKFP(KFV0, o2::track::PID::Lambda, 0);
+    v0TrackParCov.setAbsCharge(0); // to be sure
+
+    if (cached) {
+      cached->kfStatus[iCharge] = 1;
+      cached->kfV0[iCharge] = KFV0;
+      cached->kfV0TrackParCov[iCharge] = v0TrackParCov;
+    }
+    return true;
+  }
+
   template <class TTrackTo, typename TCascObject>
   bool buildCascadeCandidateWithKF(TCascObject const& cascade)
   {
@@ -1299,59 +1455,13 @@ struct cascadeBuilder {
     }
 
     //__________________________________________
-    //*>~<* step 1 : V0 with dca fitter, uses material corrections implicitly
-    // This is optional - move close to minima and therefore take material
-    if (kfDoDCAFitterPreMinimV0) {
-      int nCand = 0;
-      try {
-        nCand = fitter.process(posTrackParCov, negTrackParCov);
-      } catch (...) {
-        LOG(error) << "Exception caught in DCA fitter process call!";
-        return false;
-      }
-      if (nCand == 0) {
-        return false;
-      }
-      // save classical DCA daughters
-      cascadecandidate.v0dcadau = TMath::Sqrt(fitter.getChi2AtPCACandidate());
-
-      // re-acquire from DCA fitter
-      posTrackParCov = fitter.getTrack(0);
-      negTrackParCov = fitter.getTrack(1);
-    }
-
-    //__________________________________________
-    //*>~<* step 2 : V0 with KF
-    // create KFParticle objects from trackParCovs
-    KFParticle kfpPos = createKFParticleFromTrackParCov(posTrackParCov, posTrackParCov.getCharge(), massPosTrack);
-    KFParticle kfpNeg = createKFParticleFromTrackParCov(negTrackParCov, negTrackParCov.getCharge(), massNegTrack);
-    const KFParticle* V0Daughters[2] = {&kfpPos, &kfpNeg};
-
-    // construct V0
+    //*>~<* steps 1 and 2 : V0, shared by all the cascades built on it
     KFParticle KFV0;
-    KFV0.SetConstructMethod(kfConstructMethod);
-    try {
-      KFV0.Construct(V0Daughters, 2);
-    } catch (std::runtime_error& e) {
-      LOG(debug) << "Failed to construct cascade V0 from daughter tracks: " << e.what();
+    o2::track::TrackParCov v0TrackParCov;
+    if (!buildKFV0(cascade.v0Id(), cascadecandidate.charge < 0 ? 0 : 1, massPosTrack, massNegTrack, posTrackParCov, negTrackParCov, KFV0, v0TrackParCov)) {
       return false;
     }
 
-    // mass window cut on lambda before mass constraint
-    float massLam, sigLam;
-    KFV0.GetMass(massLam, sigLam);
-    if (TMath::Abs(massLam - 1.116) > lambdaMassWindow)
-      return false;
-
-    if (kfUseV0MassConstraint) {
-      KFV0.SetNonlinearMassConstraint(o2::constants::physics::MassLambda);
-    }
-
-    // V0 constructed, now recovering TrackParCov for dca fitter minimization (with material correction)
-    KFV0.TransportToDecayVertex();
-    o2::track::TrackParCov v0TrackParCov = getTrackParCovFromKFP(KFV0, o2::track::PID::Lambda, 0);
-    v0TrackParCov.setAbsCharge(0); // to be sure
-
     //__________________________________________
     //*>~<* step 3 : Cascade with dca fitter (with material corrections)
     if (kfDoDCAFitterPreMinimCasc) {
@@ -1547,11 +1657,11 @@ struct cascadeBuilder {
     if (v0index.has_v0Data()) {
       // this V0 passed both standard V0 and cascade V0 selections
       auto v0row = v0index.template v0Data_as<V0full>();
-      validCascadeCandidate = buildCascadeCandidate<TTrackTo>(cascade, v0row);
+      validCascadeCandidate = buildCascadeCandidate<TTrackTo>(cascade, v0row, v0index.globalIndex());
     } else if (v0index.has_v0fCData()) {
       // this V0 passes only V0-for-cascade selections, use that instead
       auto v0row = v0index.template v0fCData_as<V0fCfull>();
-      validCascadeCandidate = buildCascadeCandidate<TTrackTo>(cascade, v0row);
+      validCascadeCandidate = buildCascadeCandidate<TTrackTo>(cascade, v0row, v0index.globalIndex());
     } else {
       return; // this was inadequately linked, should not happen
     }
@@ -1725,11 +1835,11 @@ struct cascadeBuilder {
       if (v0index.has_v0Data()) {
         // this V0 passed both standard V0 and cascade V0 selections
         auto v0row = v0index.template v0Data_as<V0full>();
-        validCascadeCandidate = buildCascadeCandidate<TTrackTo>(cascade, v0row);
+        validCascadeCandidate = buildCascadeCandidate<TTrackTo>(cascade, v0row, v0index.globalIndex());
       } else if (v0index.has_v0fCData()) {
         // this V0 passes only V0-for-cascade selections, use that instead
         auto v0row = v0index.template v0fCData_as<V0fCfull>();
-        validCascadeCandidate = buildCascadeCandidate<TTrackTo>(cascade, v0row);
+        validCascadeCandidate = buildCascadeCandidate<TTrackTo>(cascade, v0row, v0index.globalIndex());
       } else {
         continue; // this was inadequately linked, should not happen
       }
@@ -1939,8 +2049,9 @@ struct cascadeBuilder {
     resetHistos();
   }
 
-  void processRun2(aod::Collisions const& collisions, aod::V0sLinked const&, V0full const&, V0fCfull const&, soa::Filtered<TaggedCascades> const& cascades, FullTracksExt const&, aod::BCsWithTimestamps const&)
+  void processRun2(aod::Collisions const& collisions, aod::V0sLinked const& v0sLinked, V0full const&, V0fCfull const&, soa::Filtered<TaggedCascades> const& cascades, FullTracksExt const&, aod::BCsWithTimestamps const&)
   {
+    resetV0Cache(v0sLinked.size());
     for (const auto& collision : collisions) {
       // Fire up CCDB
       auto bc = collision.bc_as<aod::BCsWithTimestamps>();
@@ -1953,8 +2064,9 @@ struct cascadeBuilder {
   }
   PROCESS_SWITCH(cascadeBuilder, processRun2, "Produce Run 2 cascade tables", false);
 
-  void processRun3(aod::Collisions const& collisions, aod::V0sLinked const&, V0full const&, V0fCfull const&, soa::Filtered<TaggedCascades> const& cascades, FullTracksExtIU const&, aod::BCsWithTimestamps const&)
+  void processRun3(aod::Collisions const& collisions, aod::V0sLinked const& v0sLinked, V0full const&, V0fCfull const&, soa::Filtered<TaggedCascades> const& cascades, FullTracksExtIU const&, aod::BCsWithTimestamps const&)
   {
+    resetV0Cache(v0sLinked.size());
     for (const auto& collision : collisions) {
       // Fire up CCDB
       auto bc = collision.bc_as<aod::BCsWithTimestamps>();
@@ -1967,8 +2079,9 @@ struct cascadeBuilder {
   }
   PROCESS_SWITCH(cascadeBuilder, processRun3, "Produce Run 3 cascade tables", true);
 
-  void processFindableRun3(aod::Collisions const& collisions, aod::FindableV0sLinked const&, V0full const&, soa::Filtered<TaggedFindableCascades> const& cascades, FullTracksExtIU const&, aod::BCsWithTimestamps const&)
+  void processFindableRun3(aod::Collisions const& collisions, aod::FindableV0sLinked const& findableV0sLinked, V0full const&, soa::Filtered<TaggedFindableCascades> const& cascades, FullTracksExtIU const&, aod::BCsWithTimestamps const&)
   {
+    resetV0Cache(findableV0sLinked.size());
     for (const auto& collision : collisions) {
       // Fire up CCDB
       auto bc = collision.bc_as<aod::BCsWithTimestamps>();
@@ -1981,8 +2094,9 @@ struct cascadeBuilder {
   }
   PROCESS_SWITCH(cascadeBuilder, processFindableRun3, "Produce Run 3 findable cascade tables", false);
 
-  void processRun3withKFParticle(aod::Collisions const& collisions, soa::Filtered<TaggedCascades> const& cascades, FullTracksExtIU const&, aod::BCsWithTimestamps const&, aod::V0s const&)
+  void processRun3withKFParticle(aod::Collisions const& collisions, soa::Filtered<TaggedCascades> const& cascades, FullTracksExtIU const&, aod::BCsWithTimestamps const&, aod::V0s const& v0s)
   {
+    resetV0Cache(v0s.size());
     for (const auto& collision : collisions) {
       // Fire up CCDB
       auto bc = collision.bc_as<aod::BCsWithTimestamps>();
@@ -1995,8 +2109,9 @@ struct cascadeBuilder {
   }
   PROCESS_SWITCH(cascadeBuilder, processRun3withKFParticle, "Produce Run 3 KF cascade tables", false);
 
-  void processRun3withStrangenessTracking(aod::Collisions const& collisions, aod::V0sLinked const&, V0full const&, V0fCfull const&, soa::Filtered<TaggedCascades> const& cascades, FullTracksExtIU const&, aod::BCsWithTimestamps const&, aod::TrackedCascades const& trackedCascades)
+  void processRun3withStrangenessTracking(aod::Collisions const& collisions, aod::V0sLinked const& v0sLinked, V0full const&, V0fCfull const&, soa::Filtered<TaggedCascades> const& cascades, FullTracksExtIU const&, aod::BCsWithTimestamps const&, aod::TrackedCascades const& trackedCascades)
   {
+    resetV0Cache(v0sLinked.size());
     for (const auto& collision : collisions) {
       // Fire up CCDB
       auto bc = collision.bc_as<aod::BCsWithTimestamps>();
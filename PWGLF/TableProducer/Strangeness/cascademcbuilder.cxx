@@ -34,6 +34,7 @@
 #include "Common/Core/RecoDecay.h"
 #include "Common/Core/trackUtilities.h"
 #include "PWGLF/DataModel/LFStrangenessTables.h"
+#include "PWGLF/Utils/mcTruthAssociation.h"
 
 using namespace o2;
 using namespace o2::framework;
@@ -90,6 +91,7 @@ struct cascademcbuilder {
     int mcParticleBachelor;
   };
   mcCascinfo thisInfo;
+  o2::pwglf::McTruthAssociation mcTruth; // track -> MC particle -> mothers, per DF
   //*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*
 
   template <typename TCascadeTable, typename TMCParticleTable>
@@ -99,6 +101,10 @@ struct cascademcbuilder {
     // to be used if using the asymmetric mode, kept empty otherwise
     std::vector<mcCascinfo> mcCascinfos;                           // V0MCCore information
     std::vector<bool> mcParticleIsReco(mcParticles.size(), false); // mc Particle not recoed by V0s
+    std::vector<int> mcCascinfoIndex;                              // index in mcCascinfos per mc Particle, -1 if none
+    if (populateCascMCCoresAsymmetric) {
+      mcCascinfoIndex.assign(mcParticles.size(), -1);
+    }
 
     for (auto& casc : cascTable) {
       thisInfo.pdgCode = -1, thisInfo.pdgCodeMother = -1;
@@ -148,51 +154,39 @@ struct cascademcbuilder {
         thisInfo.processBachelor = lMCBachTrack.getProcess();
 
         // Step 1: check if the mother is the same, go up a level
-        if (lMCNegTrack.has_mothers() && lMCPosTrack.has_mothers()) {
-          for (auto& lNegMother : lMCNegTrack.template mothers_as<aod::McParticles>()) {
-            for (auto& lPosMother : lMCPosTrack.template mothers_as<aod::McParticles>()) {
-              if (lNegMother == lPosMother) {
-                // acquire information
-                thisInfo.lxyz[0] = lMCPosTrack.vx();
-                thisInfo.lxyz[1] = lMCPosTrack.vy();
-                thisInfo.lxyz[2] = lMCPosTrack.vz();
-                thisInfo.pdgCodeV0 = lNegMother.pdgCode();
-
-                // if we got to this level, it means the mother particle exists and is the same
-                // now we have to go one level up and compare to the bachelor mother too
-                if (lNegMother.has_mothers() && lMCBachTrack.has_mothers()) {
-                  for (auto& lV0Mother : lNegMother.template mothers_as<aod::McParticles>()) {
-                    for (auto& lBachMother : lMCBachTrack.template mothers_as<aod::McParticles>()) {
-                      if (lV0Mother == lBachMother) {
-                        thisInfo.label = lV0Mother.globalIndex();
-
-                        if (lV0Mother.has_mcCollision()) {
-                          thisInfo.mcCollision = lV0Mother.mcCollisionId(); // save this reference, please
-                        }
-
-                        thisInfo.pdgCode = lV0Mother.pdgCode();
-                        thisInfo.isPhysicalPrimary = lV0Mother.isPhysicalPrimary();
-                        thisInfo.xyz[0] = lMCBachTrack.vx();
-                        thisInfo.xyz[1] = lMCBachTrack.vy();
-                        thisInfo.xyz[2] = lMCBachTrack.vz();
-                        thisInfo.momentum[0] = lV0Mother.px();
-                        thisInfo.momentum[1] = lV0Mother.py();
-                        thisInfo.momentum[2] = lV0Mother.pz();
-                        if (lV0Mother.has_mothers()) {
-                          for (auto& lV0GrandMother : lV0Mother.template mothers_as<aod::McParticles>()) {
-                            thisInfo.pdgCodeMother = lV0GrandMother.pdgCode();
-                            thisInfo.motherLabel = lV0GrandMother.globalIndex();
-                          }
-                        }
-                      }
-                    }
-                  } // end conditional V0-bach pair
-                }   // end has mothers
-              }   // end neg = pos mother conditional
-            }
-          } // end loop neg/pos mothers
-        }   // end conditional of mothers existing
-      }     // end association check
+        // if it is, compare the mother of the V0 to the bachelor mother too
+        int lV0Mother = -1;
+        int lCascMother = mcTruth.findCascadeMother(lMCNegTrack.globalIndex(), lMCPosTrack.globalIndex(), lMCBachTrack.globalIndex(), lV0Mother);
+        if (lV0Mother > -1) {
+          // acquire information
+          thisInfo.lxyz[0] = lMCPosTrack.vx();
+          thisInfo.lxyz[1] = lMCPosTrack.vy();
+          thisInfo.lxyz[2] = lMCPosTrack.vz();
+          thisInfo.pdgCodeV0 = mcTruth.getPdgCode(lV0Mother);
+        }
+        if (lCascMother > -1) {
+          auto lCascade = mcParticles.rawIteratorAt(lCascMother);
+          thisInfo.label = lCascMother;
+
+          if (lCascade.has_mcCollision()) {
+            thisInfo.mcCollision = lCascade.mcCollisionId(); // save this reference, please
+          }
+
+          thisInfo.pdgCode = lCascade.pdgCode();
+          thisInfo.isPhysicalPrimary = lCascade.isPhysicalPrimary();
+          thisInfo.xyz[0] = lMCBachTrack.vx();
+          thisInfo.xyz[1] = lMCBachTrack.vy();
+          thisInfo.xyz[2] = lMCBachTrack.vz();
+          thisInfo.momentum[0] = lCascade.px();
+          thisInfo.momentum[1] = lCascade.py();
+          thisInfo.momentum[2] = lCascade.pz();
+          int lCascGrandMother = mcTruth.getLastMother(lCascMother);
+          if (lCascGrandMother > -1) {
+            thisInfo.pdgCodeMother = mcTruth.getPdgCode(lCascGrandMother);
+            thisInfo.motherLabel = lCascGrandMother;
+          }
+        }
+      } // end association check
       // Construct label table (note: this will be joinable with CascDatas)
       casclabels(
         thisInfo.label, thisInfo.motherLabel);
@@ -219,15 +213,15 @@ struct cascademcbuilder {
         int thisCascMCCoreIndex = -1;
         // step 1: check if this element is already provided in the table
         //         using the packedIndices variable calculated above
-        for (uint32_t ii = 0; ii < mcCascinfos.size(); ii++) {
-          if (thisInfo.label == mcCascinfos[ii].label && mcCascinfos[ii].label > -1) {
-            thisCascMCCoreIndex = ii;
-            break; // this exists already in list
-          }
+        if (thisInfo.label > -1 && mcCascinfoIndex[thisInfo.label] > -1) {
+          thisCascMCCoreIndex = mcCascinfoIndex[thisInfo.label]; // this exists already in list
         }
         if (thisCascMCCoreIndex < 0) {
           // this CascMCCore does not exist yet. Create it and reference it
           thisCascMCCoreIndex = mcCascinfos.size();
+          if (thisInfo.label > -1) {
+            mcCascinfoIndex[thisInfo.label] = thisCascMCCoreIndex;
+          }
           mcCascinfos.push_back(thisInfo);
         }
         cascCoreMClabels(thisCascMCCoreIndex); // interlink: reconstructed -> MC index
@@ -344,55 +338,29 @@ struct cascademcbuilder {
 
   //*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*
   // build cascade labels
-  void processCascades(aod::CascDatas const& casctable, aod::V0sLinked const&, aod::V0Datas const& /*v0table*/, aod::McTrackLabels const&, aod::McParticles const& mcParticles)
+  void processCascades(aod::CascDatas const& casctable, aod::V0sLinked const&, aod::V0Datas const& /*v0table*/, aod::McTrackLabels const& trackLabels, aod::McParticles const& mcParticles)
   {
+    mcTruth.build(trackLabels, mcParticles);
     generateCascadeMCinfo(casctable, mcParticles);
   }
 
   //*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*
   // build findable cascade labels
-  void processFindableCascades(aod::CascDatas const& casctable, aod::FindableV0sLinked const&, aod::V0Datas const& /*v0table*/, aod::McTrackLabels const&, aod::McParticles const& mcParticles)
+  void processFindableCascades(aod::CascDatas const& casctable, aod::FindableV0sLinked const&, aod::V0Datas const& /*v0table*/, aod::McTrackLabels const& trackLabels, aod::McParticles const& mcParticles)
   {
+    mcTruth.build(trackLabels, mcParticles);
     generateCascadeMCinfo(casctable, mcParticles);
   }
 
   //*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*
   // build kf cascade labels
-  void processKFCascades(aod::KFCascDatas const& casctable, aod::V0s const&, aod::McTrackLabels const&, aod::McParticles const&)
+  void processKFCascades(aod::KFCascDatas const& casctable, aod::V0s const&, aod::McTrackLabels const& trackLabels, aod::McParticles const& mcParticles)
   {
+    mcTruth.build(trackLabels, mcParticles);
     for (auto& casc : casctable) {
-      int lLabel = -1;
-
-      // Acquire all three daughter tracks, please
-      auto lBachTrack = casc.template bachelor_as<aod::McTrackLabels>();
-      auto lNegTrack = casc.template negTrack_as<aod::McTrackLabels>();
-      auto lPosTrack = casc.template posTrack_as<aod::McTrackLabels>();
-
-      // Association check
-      // There might be smarter ways of doing this in the future
-      if (lNegTrack.has_mcParticle() && lPosTrack.has_mcParticle() && lBachTrack.has_mcParticle()) {
-        auto lMCBachTrack = lBachTrack.template mcParticle_as<aod::McParticles>();
-        auto lMCNegTrack = lNegTrack.template mcParticle_as<aod::McParticles>();
-        auto lMCPosTrack = lPosTrack.template mcParticle_as<aod::McParticles>();
-        // Step 1: check if the mother is the same, go up a level
-        if (lMCNegTrack.has_mothers() && lMCPosTrack.has_mothers()) {
-          for (auto& lNegMother : lMCNegTrack.template mothers_as<aod::McParticles>()) {
-            for (auto& lPosMother : lMCPosTrack.template mothers_as<aod::McParticles>()) {
-              if (lNegMother == lPosMother) {
-                // if we got to this level, it means the mother particle exists and is the same
-                // now we have to go one level up and compare to the bachelor mother too
-                for (auto& lV0Mother : lNegMother.template mothers_as<aod::McParticles>()) {
-                  for (auto& lBachMother : lMCBachTrack.template mothers_as<aod::McParticles>()) {
-                    if (lV0Mother == lBachMother) {
-                      lLabel = lV0Mother.globalIndex();
-                    }
-                  }
-                } // end conditional V0-bach pair
-              }   // end neg = pos mother conditional
-            }
-          } // end loop neg/pos mothers
-        }   // end conditional of mothers existing
-      }     // end association check
+      // Association check: mother shared by the V0 (mother of the V0 daughters) and the bachelor
+      int lV0Mother = -1;
+      int lLabel = mcTruth.findCascadeMother(mcTruth.getMcParticle(casc.negTrackId()), mcTruth.getMcParticle(casc.posTrackId()), mcTruth.getMcParticle(casc.bachelorId()), lV0Mother);
       // Construct label table (note: this will be joinable with CascDatas)
       kfcasclabels(
         lLabel);
@@ -401,41 +369,13 @@ struct cascademcbuilder {
 
   //*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*
   // build tracked cascade labels
-  void processTrackedCascades(aod::TraCascDatas const& casctable, aod::V0sLinked const&, aod::V0Datas const& /*v0table*/, aod::McTrackLabels const&, aod::McParticles const&)
+  void processTrackedCascades(aod::TraCascDatas const& casctable, aod::V0sLinked const&, aod::V0Datas const& /*v0table*/, aod::McTrackLabels const& trackLabels, aod::McParticles const& mcParticles)
   {
+    mcTruth.build(trackLabels, mcParticles);
     for (auto& casc : casctable) {
-      int lLabel = -1;
-
-      // Acquire all three daughter tracks, please
-      auto lBachTrack = casc.bachelor_as<aod::McTrackLabels>();
-      auto lNegTrack = casc.negTrack_as<aod::McTrackLabels>();
-      auto lPosTrack = casc.posTrack_as<aod::McTrackLabels>();
-
-      // Association check
-      // There might be smarter ways of doing this in the future
-      if (lNegTrack.has_mcParticle() && lPosTrack.has_mcParticle() && lBachTrack.has_mcParticle()) {
-        auto lMCBachTrack = lBachTrack.mcParticle_as<aod::McParticles>();
-        auto lMCNegTrack = lNegTrack.mcParticle_as<aod::McParticles>();
-        auto lMCPosTrack = lPosTrack.mcParticle_as<aod::McParticles>();
-        // Step 1: check if the mother is the same, go up a level
-        if (lMCNegTrack.has_mothers() && lMCPosTrack.has_mothers()) {
-          for (auto& lNegMother : lMCNegTrack.mothers_as<aod::McParticles>()) {
-            for (auto& lPosMother : lMCPosTrack.mothers_as<aod::McParticles>()) {
-              if (lNegMother == lPosMother) {
-                // if we got to this level, it means the mother particle exists and is the same
-                // now we have to go one level up and compare to the bachelor mother too
-                for (auto& lV0Mother : lNegMother.mothers_as<aod::McParticles>()) {
-                  for (auto& lBachMother : lMCBachTrack.mothers_as<aod::McParticles>()) {
-                    if (lV0Mother == lBachMother) {
-                      lLabel = lV0Mother.globalIndex();
-                    }
-                  }
-                } // end conditional V0-bach pair
-              }   // end neg = pos mother conditional
-            }
-          } // end loop neg/pos mothers
-        }   // end conditional of mothers existing
-      }     // end association check
+      // Association check: mother shared by the V0 (mother of the V0 daughters) and the bachelor
+      int lV0Mother = -1;
+      int lLabel = mcTruth.findCascadeMother(mcTruth.getMcParticle(casc.negTrackId()), mcTruth.getMcParticle(casc.posTrackId()), mcTruth.getMcParticle(casc.bachelorId()), lV0Mother);
       // Construct label table (note: this will be joinable with CascDatas)
       tracasclabels(
         lLabel);
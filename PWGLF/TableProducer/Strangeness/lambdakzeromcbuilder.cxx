@@ -34,6 +34,7 @@
 #include "Common/Core/RecoDecay.h"
 #include "Common/Core/trackUtilities.h"
 #include "PWGLF/DataModel/LFStrangenessTables.h"
+#include "PWGLF/Utils/mcTruthAssociation.h"
 
 using namespace o2;
 using namespace o2::framework;
@@ -114,6 +115,7 @@ struct lambdakzeromcbuilder {
     uint64_t packedMcParticleIndices;
   };
   mcV0info thisInfo;
+  o2::pwglf::McTruthAssociation mcTruth; // track -> MC particle -> mothers, per DF
   //*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*
 
   // prong index combiner
@@ -124,11 +126,17 @@ struct lambdakzeromcbuilder {
 
   //*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*+-+*
   // build V0 labels
-  void process(aod::V0Datas const& v0table, aod::McTrackLabels const&, aod::McParticles const& mcParticles)
+  void process(aod::V0Datas const& v0table, aod::McTrackLabels const& trackLabels, aod::McParticles const& mcParticles)
   {
     // to be used if using the populateV0MCCoresAsymmetric mode, kept empty otherwise
     std::vector<mcV0info> mcV0infos; // V0MCCore information
     std::vector<bool> mcParticleIsReco(mcParticles.size(), false); // mc Particle not recoed by V0s
+    std::vector<int> mcV0infoIndex;                                 // index in mcV0infos per mc Particle, -1 if none
+    if (populateV0MCCoresAsymmetric) {
+      mcV0infoIndex.assign(mcParticles.size(), -1);
+    }
+
+    mcTruth.build(trackLabels, mcParticles);
 
     for (auto& v0 : v0table) {
       thisInfo.packedMcParticleIndices = 0; // not de-referenced properly yet
@@ -163,64 +171,59 @@ struct lambdakzeromcbuilder {
         thisInfo.negP[0] = lMCNegTrack.px();
         thisInfo.negP[1] = lMCNegTrack.py();
         thisInfo.negP[2] = lMCNegTrack.pz();
-        if (lMCNegTrack.has_mothers() && lMCPosTrack.has_mothers()) {
-          for (auto& lNegMother : lMCNegTrack.mothers_as<aod::McParticles>()) {
-            for (auto& lPosMother : lMCPosTrack.mothers_as<aod::McParticles>()) {
-              if (lNegMother.globalIndex() == lPosMother.globalIndex()) {
-                thisInfo.label = lNegMother.globalIndex();
-                thisInfo.xyz[0] = lMCPosTrack.vx();
-                thisInfo.xyz[1] = lMCPosTrack.vy();
-                thisInfo.xyz[2] = lMCPosTrack.vz();
-
-                // MC pos. and neg. daughters are the same! Looking for replacement...
-                if (lMCPosTrack.globalIndex() == lMCNegTrack.globalIndex()) {
-                  auto const& daughters = lNegMother.daughters_as<aod::McParticles>();
-                  for (auto& ldau : daughters) {
-                    // check if the candidate originate from a decay
-                    // if not, this is not a suitable candidate for one of the decay daughters
-                    if (ldau.getProcess() != 4) // see TMCProcess.h
-                      continue;
-
-                    if (lMCPosTrack.pdgCode() < 0 && ldau.pdgCode() > 0) { // the positive track needs to be changed
-                      thisInfo.pdgCodePositive = ldau.pdgCode();
-                      thisInfo.processPositive = ldau.getProcess();
-                      thisInfo.posP[0] = ldau.px();
-                      thisInfo.posP[1] = ldau.py();
-                      thisInfo.posP[2] = ldau.pz();
-                      thisInfo.xyz[0] = ldau.vx();
-                      thisInfo.xyz[1] = ldau.vy();
-                      thisInfo.xyz[2] = ldau.vz();
-                    }
-                    if (lMCNegTrack.pdgCode() > 0 && ldau.pdgCode() < 0) { // the negative track needs to be changed
-                      thisInfo.pdgCodeNegative = ldau.pdgCode();
-                      thisInfo.processNegative = ldau.getProcess();
-                      thisInfo.negP[0] = ldau.px();
-                      thisInfo.negP[1] = ldau.py();
-                      thisInfo.negP[2] = ldau.pz();
-                    }
-                  }
-                }
-
-                if (lNegMother.has_mcCollision()) {
-                  thisInfo.mcCollision = lNegMother.mcCollisionId(); // save this reference, please
-                }
-
-                // acquire information
-                thisInfo.pdgCode = lNegMother.pdgCode();
-                thisInfo.isPhysicalPrimary = lNegMother.isPhysicalPrimary();
-                thisInfo.momentum[0] = lNegMother.px();
-                thisInfo.momentum[1] = lNegMother.py();
-                thisInfo.momentum[2] = lNegMother.pz();
-
-                if (lNegMother.has_mothers()) {
-                  for (auto& lNegGrandMother : lNegMother.mothers_as<aod::McParticles>()) {
-                    thisInfo.pdgCodeMother = lNegGrandMother.pdgCode();
-                    thisInfo.motherLabel = lNegGrandMother.globalIndex();
-                  }
-                }
+        int v0McParticle = mcTruth.findCommonMother(lNegTrack.mcParticleId(), lPosTrack.mcParticleId());
+        if (v0McParticle > -1) {
+          auto lNegMother = mcParticles.rawIteratorAt(v0McParticle);
+          thisInfo.label = lNegMother.globalIndex();
+          thisInfo.xyz[0] = lMCPosTrack.vx();
+          thisInfo.xyz[1] = lMCPosTrack.vy();
+          thisInfo.xyz[2] = lMCPosTrack.vz();
+
+          // MC pos. and neg. daughters are the same! Looking for replacement...
+          if (lMCPosTrack.globalIndex() == lMCNegTrack.globalIndex()) {
+            auto const& daughters = lNegMother.daughters_as<aod::McParticles>();
+            for (auto& ldau : daughters) {
+              // check if the candidate originate from a decay
+              // if not, this is not a suitable candidate for one of the decay daughters
+              if (ldau.getProcess() != 4) // see TMCProcess.h
+                continue;
+
+              if (lMCPosTrack.pdgCode() < 0 && ldau.pdgCode() > 0) { // the positive track needs to be changed
+                thisInfo.pdgCodePositive = ldau.pdgCode();
+                thisInfo.processPositive = ldau.getProcess();
+                thisInfo.posP[0] = ldau.px();
+                thisInfo.posP[1] = ldau.py();
+                thisInfo.posP[2] = ldau.pz();
+                thisInfo.xyz[0] = ldau.vx();
+                thisInfo.xyz[1] = ldau.vy();
+                thisInfo.xyz[2] = ldau.vz();
+              }
+              if (lMCNegTrack.pdgCode() > 0 && ldau.pdgCode() < 0) { // the negative track needs to be changed
+                thisInfo.pdgCodeNegative = ldau.pdgCode();
+                thisInfo.processNegative = ldau.getProcess();
+                thisInfo.negP[0] = ldau.px();
+                thisInfo.negP[1] = ldau.py();
+                thisInfo.negP[2] = ldau.pz();
               }
             }
           }
+
+          if (lNegMother.has_mcCollision()) {
+            thisInfo.mcCollision = lNegMother.mcCollisionId(); // save this reference, please
+          }
+
+          // acquire information
+          thisInfo.pdgCode = lNegMother.pdgCode();
+          thisInfo.isPhysicalPrimary = lNegMother.isPhysicalPrimary();
+          thisInfo.momentum[0] = lNegMother.px();
+          thisInfo.momentum[1] = lNegMother.py();
+          thisInfo.momentum[2] = lNegMother.pz();
+
+          int lNegGrandMother = mcTruth.getLastMother(lNegMother.globalIndex());
+          if (lNegGrandMother > -1) {
+            thisInfo.pdgCodeMother = mcTruth.getPdgCode(lNegGrandMother);
+            thisInfo.motherLabel = lNegGrandMother;
+          }
         }
       } // end association check
       // Construct label table (note: this will be joinable with V0Datas!)
@@ -259,17 +262,15 @@ struct lambdakzeromcbuilder {
         int thisV0MCCoreIndex = -1;
         // step 1: check if this element is already provided in the table
         //         using the packedIndices variable calculated above
-        for (uint32_t ii = 0; ii < mcV0infos.size(); ii++) {
-          if (thisInfo.label == mcV0infos[ii].label && mcV0infos[ii].label > -1) {
-            thisV0MCCoreIndex = ii;
-            histos.fill(HIST("hBuildingStatistics"), 2.0f); // found
-            break;                                          // this exists already in list
-          }
+        if (thisInfo.label > -1 && mcV0infoIndex[thisInfo.label] > -1) {
+          thisV0MCCoreIndex = mcV0infoIndex[thisInfo.label];
+          histos.fill(HIST("hBuildingStatistics"), 2.0f); // found, this exists already in list
         }
         if (thisV0MCCoreIndex < 0 && thisInfo.label > -1) {
           // this V0MCCore does not exist yet. Create it and reference it
           histos.fill(HIST("hBuildingStatistics"), 3.0f); // new
           thisV0MCCoreIndex = mcV0infos.size();
+          mcV0infoIndex[thisInfo.label] = thisV0MCCoreIndex;
           mcV0infos.push_back(thisInfo);
 
           // For bookkeeping
@@ -29,6 +29,7 @@
 #include "Framework/ASoAHelpers.h"
 #include "DCAFitter/DCAFitterN.h"
 #include "ReconstructionDataFormats/Track.h"
+#include "Common/Core/IndexRemapping.h"
 #include "Common/Core/RecoDecay.h"
 #include "Common/Core/trackUtilities.h"
 #include "PWGLF/DataModel/LFStrangenessTables.h"
@@ -207,6 +208,15 @@ struct strangederivedbuilder {
   std::vector<uint32_t> genOmegaMinus;
   std::vector<uint32_t> genOmegaPlus;
 
+  // old-to-new index maps of the reduced track and MC particle tables, buffers reused between DFs
+  indexremapping::IndexRemapper trackMap;
+  indexremapping::IndexRemapper motherReference;
+  static constexpr auto posTrackOf = [](auto const& row) { return row.posTrackId(); };
+  static constexpr auto negTrackOf = [](auto const& row) { return row.negTrackId(); };
+  static constexpr auto bachelorOf = [](auto const& row) { return row.bachelorId(); };
+  static constexpr auto strangeTrackOf = [](auto const& row) { return row.strangeTrackId(); };
+  static constexpr auto mcMotherParticleOf = [](auto const& row) { return row.mcMotherParticleId(); };
+
   float roundToPrecision(float number, float step = 0.01)
   {
     // this function rounds a certain number in an axis that is quantized by
@@ -446,37 +456,25 @@ struct strangederivedbuilder {
 
   void processTrackExtrasV0sOnly(aod::V0Datas const& V0s, TracksWithExtra const& tracksExtra)
   {
-    std::vector<int> trackMap(tracksExtra.size(), -1); // index -1: not used
+    trackMap.reset(tracksExtra.size());
 
     //__________________________________________________
     // mark tracks that belong to V0s
-    for (auto const& v0 : V0s) {
-      auto const& posTrack = v0.posTrack_as<TracksWithExtra>();
-      auto const& negTrack = v0.negTrack_as<TracksWithExtra>();
-      trackMap[posTrack.globalIndex()] = 0;
-      trackMap[negTrack.globalIndex()] = 0;
-    }
+    trackMap.keepReferenced(V0s, posTrackOf, negTrackOf);
     //__________________________________________________
     // Figure out the numbering of the new tracks table
     // assume filling per order
-    int nTracks = 0;
-    for (int i = 0; i < static_cast<int>(trackMap.size()); i++) {
-      if (trackMap[i] >= 0) {
-        trackMap[i] = nTracks++;
-      }
-    }
+    trackMap.build();
     //__________________________________________________
     // populate track references
     for (auto const& v0 : V0s) {
-      auto const& posTrack = v0.posTrack_as<TracksWithExtra>();
-      auto const& negTrack = v0.negTrack_as<TracksWithExtra>();
-      v0Extras(trackMap[posTrack.globalIndex()],
-               trackMap[negTrack.globalIndex()]); // joinable with V0Datas
+      v0Extras(trackMap[v0.posTrackId()],
+               trackMap[v0.negTrackId()]); // joinable with V0Datas
     }
     //__________________________________________________
     // circle back and populate actual DauTrackExtra table
     for (auto const& tr : tracksExtra) {
-      if (trackMap[tr.globalIndex()] >= 0) {
+      if (trackMap.isKept(tr.globalIndex())) {
         dauTrackExtras(tr.itsChi2NCl(),
                        tr.detectorMap(), tr.itsClusterSizes(),
                        tr.tpcNClsFound(), tr.tpcNClsCrossedRows());
@@ -488,86 +486,40 @@ struct strangederivedbuilder {
   template <typename V0Datas, typename CascDatas, typename KFCascDatas, typename TraCascDatas, typename tracksWithExtra>
   void fillTrackExtras(V0Datas const& V0s, CascDatas const& Cascades, KFCascDatas const& KFCascades, TraCascDatas const& TraCascades, tracksWithExtra const& tracksExtra)
   {
-    std::vector<int> trackMap(tracksExtra.size(), -1); // index -1: not used
-
-    //__________________________________________________
-    // mark tracks that belong to V0s
-    for (auto const& v0 : V0s) {
-      auto const& posTrack = v0.template posTrack_as<tracksWithExtra>();
-      auto const& negTrack = v0.template negTrack_as<tracksWithExtra>();
-      trackMap[posTrack.globalIndex()] = 0;
-      trackMap[negTrack.globalIndex()] = 0;
-    }
+    trackMap.reset(tracksExtra.size());
 
     //__________________________________________________
-    // index tracks that belong to CascDatas
-    for (auto const& casc : Cascades) {
-      auto bachTrack = casc.template bachelor_as<tracksWithExtra>();
-      auto posTrack = casc.template posTrack_as<tracksWithExtra>();
-      auto negTrack = casc.template negTrack_as<tracksWithExtra>();
-      trackMap[posTrack.globalIndex()] = 0;
-      trackMap[negTrack.globalIndex()] = 0;
-      trackMap[bachTrack.globalIndex()] = 0;
-    }
-    //__________________________________________________
-    // index tracks that belong to KFCascDatas
-    for (auto const& casc : KFCascades) {
-      auto bachTrack = casc.template bachelor_as<tracksWithExtra>();
-      auto posTrack = casc.template posTrack_as<tracksWithExtra>();
-      auto negTrack = casc.template negTrack_as<tracksWithExtra>();
-      trackMap[posTrack.globalIndex()] = 0;
-      trackMap[negTrack.globalIndex()] = 0;
-      trackMap[bachTrack.globalIndex()] = 0;
-    }
-    //__________________________________________________
-    // index tracks that belong to TraCascDatas
-    for (auto const& casc : TraCascades) {
-      auto bachTrack = casc.template bachelor_as<tracksWithExtra>();
-      auto posTrack = casc.template posTrack_as<tracksWithExtra>();
-      auto negTrack = casc.template negTrack_as<tracksWithExtra>();
-      auto strangeTrack = casc.template strangeTrack_as<tracksWithExtra>();
-      trackMap[posTrack.globalIndex()] = 0;
-      trackMap[negTrack.globalIndex()] = 0;
-      trackMap[bachTrack.globalIndex()] = 0;
-      trackMap[strangeTrack.globalIndex()] = 0;
-    }
+    // mark tracks that belong to V0s, CascDatas, KFCascDatas and TraCascDatas
+    trackMap.keepReferenced(V0s, posTrackOf, negTrackOf);
+    trackMap.keepReferenced(Cascades, posTrackOf, negTrackOf, bachelorOf);
+    trackMap.keepReferenced(KFCascades, posTrackOf, negTrackOf, bachelorOf);
+    trackMap.keepReferenced(TraCascades, posTrackOf, negTrackOf, bachelorOf, strangeTrackOf);
     //__________________________________________________
     // Figure out the numbering of the new tracks table
     // assume filling per order
-    int nTracks = 0;
-    for (int i = 0; i < static_cast<int>(trackMap.size()); i++) {
-      if (trackMap[i] >= 0) {
-        trackMap[i] = nTracks++;
-      }
-    }
+    trackMap.build();
     //__________________________________________________
     // populate track references
     for (auto const& v0 : V0s) {
-      auto const& posTrack = v0.template posTrack_as<tracksWithExtra>();
-      auto const& negTrack = v0.template negTrack_as<tracksWithExtra>();
-      v0Extras(trackMap[posTrack.globalIndex()],
-               trackMap[negTrack.globalIndex()]); // joinable with V0Datas
+      v0Extras(trackMap[v0.posTrackId()],
+               trackMap[v0.negTrackId()]); // joinable with V0Datas
     }
     //__________________________________________________
     // populate track references
     for (auto const& casc : Cascades) {
-      auto bachTrack = casc.template bachelor_as<tracksWithExtra>();
-      auto posTrack = casc.template posTrack_as<tracksWithExtra>();
-      auto negTrack = casc.template negTrack_as<tracksWithExtra>();
-      cascExtras(trackMap[posTrack.globalIndex()],
-                 trackMap[negTrack.globalIndex()],
-                 trackMap[bachTrack.globalIndex()]); // joinable with CascDatas
+      cascExtras(trackMap[casc.posTrackId()],
+                 trackMap[casc.negTrackId()],
+                 trackMap[casc.bachelorId()]); // joinable with CascDatas
     }
     //__________________________________________________
     // populate track references
     for (auto const& casc : TraCascades) {
-      auto strangeTrack = casc.template strangeTrack_as<tracksWithExtra>();
-      straTrackExtras(trackMap[strangeTrack.globalIndex()]); // joinable with TraCascDatas
+      straTrackExtras(trackMap[casc.strangeTrackId()]); // joinable with TraCascDatas
     }
     //__________________________________________________
     // circle back and populate actual DauTrackExtra table
     for (auto const& tr : tracksExtra) {
-      if (trackMap[tr.globalIndex()] >= 0) {
+      if (trackMap.isKept(tr.globalIndex())) {
         dauTrackExtras(tr.itsChi2NCl(),
                        tr.detectorMap(), tr.itsClusterSizes(),
                        tr.tpcNClsFound(), tr.tpcNClsCrossedRows());
@@ -613,25 +565,16 @@ struct strangederivedbuilder {
 
   void processStrangeMothers(soa::Join<aod::V0Datas, aod::McV0Labels> const& V0s, soa::Join<aod::CascDatas, aod::McCascLabels> const& Cascades, aod::McParticles const& mcParticles)
   {
-    std::vector<int> motherReference(mcParticles.size(), -1); // index -1: not used / no reference
+    motherReference.reset(mcParticles.size());
 
     //__________________________________________________
-    // mark mcParticles for referencing
-    for (auto const& v0 : V0s)
-      if (v0.has_mcMotherParticle())
-        motherReference[v0.mcMotherParticleId()] = 0;
-    for (auto const& ca : Cascades)
-      if (ca.has_mcMotherParticle())
-        motherReference[ca.mcMotherParticleId()] = 0;
+    // mark mcParticles for referencing (index -1: no reference)
+    motherReference.keepReferenced(V0s, mcMotherParticleOf);
+    motherReference.keepReferenced(Cascades, mcMotherParticleOf);
     //__________________________________________________
     // Figure out the numbering of the new mcMother table
     // assume filling per order
-    int nParticles = 0;
-    for (int i = 0; i < static_cast<int>(motherReference.size()); i++) {
-      if (motherReference[i] >= 0) {
-        motherReference[i] = nParticles++; // count particles of interest
-      }
-    }
+    motherReference.build();
     //__________________________________________________
     // populate track references
     for (auto const& v0 : V0s)
@@ -641,7 +584,7 @@ struct strangederivedbuilder {
     //__________________________________________________
     // populate motherMCParticles
     for (auto const& tr : mcParticles) {
-      if (motherReference[tr.globalIndex()] >= 0) {
+      if (motherReference.isKept(tr.globalIndex())) {
         motherMCParts(tr.px(), tr.py(), tr.pz(), tr.pdgCode(), tr.isPhysicalPrimary());
       }
     }
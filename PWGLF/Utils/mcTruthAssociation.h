@@ -0,0 +1,132 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   mcTruthAssociation.h
+/// \since  19/10/2026
+/// \brief  Per-DF reconstructed-to-generated association for the MC builders
+///
+
+#ifndef PWGLF_UTILS_MCTRUTHASSOCIATION_H_
+#define PWGLF_UTILS_MCTRUTHASSOCIATION_H_
+
+#include <cstddef>
+#include <vector>
+
+namespace o2
+{
+namespace pwglf
+{
+
+/// @brief MC particle of each track and mothers of each MC particle, read once per DF
+///
+/// The MC builders decide whether the daughters of a V0 or cascade come from the same generated particle by
+/// comparing the mothers of their MC particles. With this class the labels and mothers are read in one pass over
+/// McTrackLabels and McParticles and stored in flat arrays (mothers in compressed-row form), so that the truth
+/// decisions are made on indices without creating table iterators. The results are those of the nested loops over
+/// mothers_as() that they replace: when several mothers are shared, the last one in (first particle, second particle)
+/// loop order is returned.
+class McTruthAssociation
+{
+ public:
+  /// Reads the labels of the tracks and the mothers of the MC particles
+  /// \param trackLabels McTrackLabels, joinable with the tracks
+  /// \param mcParticles McParticles
+  template <typename TTrackLabels, typename TMcParticles>
+  void build(TTrackLabels const& trackLabels, TMcParticles const& mcParticles)
+  {
+    mTrackMcParticle.clear();
+    mTrackMcParticle.reserve(trackLabels.size());
+    for (const auto& label : trackLabels) {
+      mTrackMcParticle.push_back(label.has_mcParticle() ? label.mcParticleId() : -1);
+    }
+
+    mMotherOffsets.clear();
+    mMotherOffsets.reserve(mcParticles.size() + 1);
+    mMothers.clear();
+    mPdgCodes.clear();
+    mPdgCodes.reserve(mcParticles.size());
+    mMotherOffsets.push_back(0);
+    for (const auto& particle : mcParticles) {
+      if (particle.has_mothers()) {
+        for (const auto& motherId : particle.mothersIds()) {
+          if (motherId >= 0) {
+            mMothers.push_back(motherId);
+          }
+        }
+      }
+      mMotherOffsets.push_back(mMothers.size());
+      mPdgCodes.push_back(particle.pdgCode());
+    }
+  }
+
+  /// MC particle of track, -1 if none
+  int getMcParticle(int track) const { return track >= 0 ? mTrackMcParticle[track] : -1; }
+  int getPdgCode(int mcParticle) const { return mPdgCodes[mcParticle]; }
+  int getNMothers(int mcParticle) const { return mMotherOffsets[mcParticle + 1] - mMotherOffsets[mcParticle]; }
+  int getMother(int mcParticle, int iMother) const { return mMothers[mMotherOffsets[mcParticle] + iMother]; }
+  /// Last mother of mcParticle, -1 if none
+  int getLastMother(int mcParticle) const
+  {
+    return (mcParticle >= 0 && getNMothers(mcParticle) > 0) ? mMothers[mMotherOffsets[mcParticle + 1] - 1] : -1;
+  }
+
+  /// Mother shared by two MC particles, -1 if none or if one of them is -1
+  int findCommonMother(int mcParticle0, int mcParticle1) const
+  {
+    if (mcParticle0 < 0 || mcParticle1 < 0) {
+      return -1;
+    }
+    int common = -1;
+    for (auto i0 = mMotherOffsets[mcParticle0]; i0 < mMotherOffsets[mcParticle0 + 1]; i0++) {
+      for (auto i1 = mMotherOffsets[mcParticle1]; i1 < mMotherOffsets[mcParticle1 + 1]; i1++) {
+        if (mMothers[i0] == mMothers[i1]) {
+          common = mMothers[i0];
+        }
+      }
+    }
+    return common;
+  }
+
+  /// Mother shared by a mother of the V0 daughters (the V0) and the bachelor, -1 if none
+  /// \param v0Mother set to the last mother shared by the V0 daughters, -1 if none
+  int findCascadeMother(int mcNegative, int mcPositive, int mcBachelor, int& v0Mother) const
+  {
+    v0Mother = -1;
+    if (mcNegative < 0 || mcPositive < 0 || mcBachelor < 0) {
+      return -1;
+    }
+    int cascadeMother = -1;
+    for (auto iNeg = mMotherOffsets[mcNegative]; iNeg < mMotherOffsets[mcNegative + 1]; iNeg++) {
+      for (auto iPos = mMotherOffsets[mcPositive]; iPos < mMotherOffsets[mcPositive + 1]; iPos++) {
+        if (mMothers[iNeg] == mMothers[iPos]) {
+          v0Mother = mMothers[iNeg];
+          int common = findCommonMother(v0Mother, mcBachelor);
+          if (common > -1) {
+            cascadeMother = common;
+          }
+        }
+      }
+    }
+    return cascadeMother;
+  }
+
+ private:
+  std::vector<int> mTrackMcParticle;
+  std::vector<std::size_t> mMotherOffsets; // mothers of particle i in [mMotherOffsets[i], mMotherOffsets[i + 1])
+  std::vector<int> mMothers;
+  std::vector<int> mPdgCodes;
+};
+
+} // namespace pwglf
+} // namespace o2
+
+#endif // PWGLF_UTILS_MCTRUTHASSOCIATION_H_
@@ -0,0 +1,113 @@
+// Copyright 2019-2024 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+///
+/// \file nucleiUtils.h
+/// \brief Columnar TPC PID pre-selection of light-nuclei candidates
+
+#ifndef PWGLF_UTILS_NUCLEIUTILS_H_
+#define PWGLF_UTILS_NUCLEIUTILS_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "DataFormatsTPC/BetheBlochAleph.h"
+
+namespace nuclei
+{
+/// TPC nsigma of the tracks of a collision for all the light-nuclei hypotheses at once.
+///
+/// The TPC momentum, dE/dx and charge of the tracks are collected in columns with add(). evaluate() then computes,
+/// one hypothesis at a time over all the tracks, the expected dE/dx (Bethe-Bloch with the ALEPH parametrisation, with
+/// a momentum scaling per charge) and the nsigma, and sets the selection bit of the hypothesis (bit iS) for the tracks
+/// in its nsigma window. The inner loops have no branches and only the tracks with at least one bit have to be
+/// analysed further. The nsigma values are the same as from the per-track computation.
+template <int NSpecies>
+class TpcNsigmaKernel
+{
+  static_assert(NSpecies <= 8, "The selection bits of a track are stored in 8 bits");
+
+ public:
+  /// Sets the response and the nsigma window of hypothesis iS
+  /// \param bgScalings scaling from the TPC momentum to beta*gamma, for positive and negative tracks
+  /// \param betheBloch parameters of tpc::BetheBlochAleph
+  /// \param resolution relative dE/dx resolution
+  void setHypothesis(int iS, std::array<double, 2> const& bgScalings, std::array<double, 5> const& betheBloch, double resolution, float nSigmaMin, float nSigmaMax)
+  {
+    mHypotheses[iS] = {bgScalings, betheBloch, resolution, nSigmaMin, nSigmaMax};
+  }
+
+  void clear()
+  {
+    mTpcInnerParam.clear();
+    mTpcSignal.clear();
+    mChargeIndex.clear();
+  }
+
+  /// Adds a track, chargeIndex is 0 for positive and 1 for negative tracks
+  /// \return index of the track in the kernel
+  int add(float tpcInnerParam, float tpcSignal, int chargeIndex)
+  {
+    mTpcInnerParam.push_back(tpcInnerParam);
+    mTpcSignal.push_back(tpcSignal);
+    mChargeIndex.push_back(chargeIndex);
+    return mTpcInnerParam.size() - 1;
+  }
+
+  std::size_t size() const { return mTpcInnerParam.size(); }
+
+  /// Computes the nsigma and selection bits of all the tracks
+  void evaluate()
+  {
+    const std::size_t nTracks = size();
+    mBits.assign(nTracks, 0);
+    for (int iS{0}; iS < NSpecies; ++iS) {
+      const Hypothesis& hyp = mHypotheses[iS];
+      auto& nSigma = mNsigma[iS];
+      nSigma.resize(nTracks);
+      for (std::size_t i{0}; i < nTracks; ++i) {
+        const double expBethe{o2::tpc::BetheBlochAleph(static_cast<double>(mTpcInnerParam[i] * hyp.bgScalings[mChargeIndex[i]]), hyp.betheBloch[0], hyp.betheBloch[1], hyp.betheBloch[2], hyp.betheBloch[3], hyp.betheBloch[4])};
+        const double expSigma{expBethe * hyp.resolution};
+        nSigma[i] = static_cast<float>((mTpcSignal[i] - expBethe) / expSigma);
+      }
+      const uint8_t bit = 1 << iS;
+      for (std::size_t i{0}; i < nTracks; ++i) {
+        mBits[i] |= (nSigma[i] > hyp.nSigmaMin && nSigma[i] < hyp.nSigmaMax) ? bit : 0;
+      }
+    }
+  }
+
+  float getTpcInnerParam(int i) const { return mTpcInnerParam[i]; }
+  float getNsigma(int iS, int i) const { return mNsigma[iS][i]; }
+  uint8_t getBits(int i) const { return mBits[i]; }
+  bool isSelected(int i) const { return mBits[i] != 0; }
+  bool isSelected(int i, int iS) const { return mBits[i] & (1 << iS); }
+
+ private:
+  struct Hypothesis {
+    std::array<double, 2> bgScalings{1., 1.};
+    std::array<double, 5> betheBloch{};
+    double resolution{1.};
+    float nSigmaMin{0.f};
+    float nSigmaMax{0.f};
+  };
+
+  std::array<Hypothesis, NSpecies> mHypotheses;
+  std::vector<float> mTpcInnerParam;
+  std::vector<float> mTpcSignal;
+  std::vector<uint8_t> mChargeIndex;
+  std::array<std::vector<float>, NSpecies> mNsigma;
+  std::vector<uint8_t> mBits;
+};
+} // namespace nuclei
+
+#endif // PWGLF_UTILS_NUCLEIUTILS_H_
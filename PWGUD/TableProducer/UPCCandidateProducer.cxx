@@ -16,6 +16,7 @@
 #include "Framework/AnalysisTask.h"
 #include "Framework/AnalysisDataModel.h"
 #include "Common/CCDB/EventSelectionParams.h"
+#include "Common/Core/BcLookup.h"
 #include "Common/DataModel/EventSelection.h"
 #include "CommonConstants/LHCConstants.h"
 #include "DataFormatsFIT/Triggers.h"
@@ -217,19 +218,6 @@ struct UpcCandProducer {
     return true;
   }
 
-  auto findClosestBC(uint64_t globalBC, std::map<uint64_t, int32_t>& bcs)
-  {
-    auto it = bcs.lower_bound(globalBC);
-    auto bc1 = it->first;
-    if (it != bcs.begin())
-      --it;
-    auto bc2 = it->first;
-    auto dbc1 = bc1 >= globalBC ? bc1 - globalBC : globalBC - bc1;
-    auto dbc2 = bc2 >= globalBC ? bc2 - globalBC : globalBC - bc2;
-    auto bc = (dbc1 <= dbc2) ? bc1 : bc2;
-    return bc;
-  }
-
   auto findClosestTrackBCiter(uint64_t globalBC, std::vector<BCTracksPair>& bcs)
   {
     auto it = std::lower_bound(bcs.begin(), bcs.end(), globalBC,
@@ -757,16 +745,16 @@ struct UpcCandProducer {
     std::sort(bcsMatchedTrIdsITSTPC.begin(), bcsMatchedTrIdsITSTPC.end(),
               [](const auto& left, const auto& right) { return left.first < right.first; });
 
-    std::map<uint64_t, int32_t> mapGlobalBcWithTOR{};
-    std::map<uint64_t, int32_t> mapGlobalBcWithTVX{};
-    std::map<uint64_t, int32_t> mapGlobalBcWithTSC{};
+    bclookup::BcLookup<int32_t> bcsWithTOR;
+    bclookup::BcLookup<int32_t> bcsWithTVX;
+    bclookup::BcLookup<int32_t> bcsWithTSC;
     for (const auto& ft0 : ft0s) {
       uint64_t globalBC = ft0.bc_as<TBCs>().globalBC();
       int32_t globalIndex = ft0.globalIndex();
       if (!(std::abs(ft0.timeA()) > 2.f && std::abs(ft0.timeC()) > 2.f))
-        mapGlobalBcWithTOR[globalBC] = globalIndex;
+        bcsWithTOR.add(globalBC, globalIndex);
       if (TESTBIT(ft0.triggerMask(), o2::fit::Triggers::bitVertex)) { // TVX
-        mapGlobalBcWithTVX[globalBC] = globalIndex;
+        bcsWithTVX.add(globalBC, globalIndex);
       }
       if (TESTBIT(ft0.triggerMask(), o2::fit::Triggers::bitCen)) { // TVX & TCE
         histRegistry.get<TH1>(HIST("hCountersTrg"))->Fill("TCE", 1);
@@ -774,19 +762,19 @@ struct UpcCandProducer {
       if (TESTBIT(ft0.triggerMask(), o2::fit::Triggers::bitVertex) &&
           (TESTBIT(ft0.triggerMask(), o2::fit::Triggers::bitCen) ||
            TESTBIT(ft0.triggerMask(), o2::fit::Triggers::bitSCen))) { // TVX & (TSC | TCE)
-        mapGlobalBcWithTSC[globalBC] = globalIndex;
+        bcsWithTSC.add(globalBC, globalIndex);
       }
     }
 
-    std::map<uint64_t, int32_t> mapGlobalBcWithV0A{};
+    bclookup::BcLookup<int32_t> bcsWithV0A;
     for (const auto& fv0a : fv0as) {
       if (std::abs(fv0a.time()) > 15.f)
         continue;
       uint64_t globalBC = fv0a.bc_as<TBCs>().globalBC();
-      mapGlobalBcWithV0A[globalBC] = fv0a.globalIndex();
+      bcsWithV0A.add(globalBC, fv0a.globalIndex());
     }
 
-    std::map<uint64_t, int32_t> mapGlobalBcWithZdc{};
+    bclookup::BcLookup<int32_t> bcsWithZdc;
     for (const auto& zdc : zdcs) {
       if (std::abs(zdc.timeZNA()) > 2.f && std::abs(zdc.timeZNC()) > 2.f)
         continue;
@@ -795,14 +783,18 @@ struct UpcCandProducer {
       if (!(std::abs(zdc.timeZNC()) > 2.f))
         histRegistry.get<TH1>(HIST("hCountersTrg"))->Fill("ZNC", 1);
       auto globalBC = zdc.bc_as<TBCs>().globalBC();
-      mapGlobalBcWithZdc[globalBC] = zdc.globalIndex();
+      bcsWithZdc.add(globalBC, zdc.globalIndex());
+    }
+
+    for (auto* lookup : {&bcsWithTOR, &bcsWithTVX, &bcsWithTSC, &bcsWithV0A, &bcsWithZdc}) {
+      lookup->build();
     }
 
-    auto nTORs = mapGlobalBcWithTOR.size();
-    auto nTSCs = mapGlobalBcWithTSC.size();
-    auto nTVXs = mapGlobalBcWithTVX.size();
-    auto nFV0As = mapGlobalBcWithV0A.size();
-    auto nZdcs = mapGlobalBcWithZdc.size();
+    auto nTORs = bcsWithTOR.size();
+    auto nTSCs = bcsWithTSC.size();
+    auto nTVXs = bcsWithTVX.size();
+    auto nFV0As = bcsWithV0A.size();
+    auto nZdcs = bcsWithZdc.size();
     auto nBcsWithITSTPC = bcsMatchedTrIdsITSTPC.size();
 
     // todo: calculate position of UD collision?
@@ -826,11 +818,11 @@ struct UpcCandProducer {
       fitInfo.distClosestBcTVX = 999;
       fitInfo.distClosestBcV0A = 999;
       if (nTORs > 0) {
-        uint64_t closestBcTOR = findClosestBC(globalBC, mapGlobalBcWithTOR);
-        fitInfo.distClosestBcTOR = globalBC - static_cast<int64_t>(closestBcTOR);
+        int closestBcTOR = bcsWithTOR.findClosest(globalBC);
+        fitInfo.distClosestBcTOR = static_cast<int64_t>(globalBC) - bcsWithTOR.getGlobalBC(closestBcTOR);
         if (std::abs(fitInfo.distClosestBcTOR) <= fFilterFT0)
           return false;
-        auto ft0Id = mapGlobalBcWithTOR.at(closestBcTOR);
+        auto ft0Id = bcsWithTOR.getValue(closestBcTOR);
         auto ft0 = ft0s.iteratorAt(ft0Id);
         fitInfo.timeFT0A = ft0.timeA();
         fitInfo.timeFT0C = ft0.timeC();
@@ -842,23 +834,23 @@ struct UpcCandProducer {
           fitInfo.ampFT0C += amp;
       }
       if (nTSCs > 0) {
-        uint64_t closestBcTSC = findClosestBC(globalBC, mapGlobalBcWithTSC);
-        fitInfo.distClosestBcTSC = globalBC - static_cast<int64_t>(closestBcTSC);
+        int closestBcTSC = bcsWithTSC.findClosest(globalBC);
+        fitInfo.distClosestBcTSC = static_cast<int64_t>(globalBC) - bcsWithTSC.getGlobalBC(closestBcTSC);
         if (std::abs(fitInfo.distClosestBcTSC) <= fFilterTSC)
           return false;
       }
       if (nTVXs > 0) {
-        uint64_t closestBcTVX = findClosestBC(globalBC, mapGlobalBcWithTVX);
-        fitInfo.distClosestBcTVX = globalBC - static_cast<int64_t>(closestBcTVX);
+        int closestBcTVX = bcsWithTVX.findClosest(globalBC);
+        fitInfo.distClosestBcTVX = static_cast<int64_t>(globalBC) - bcsWithTVX.getGlobalBC(closestBcTVX);
         if (std::abs(fitInfo.distClosestBcTVX) <= fFilterTVX)
           return false;
       }
       if (nFV0As > 0) {
-        uint64_t closestBcV0A = findClosestBC(globalBC, mapGlobalBcWithV0A);
-        fitInfo.distClosestBcV0A = globalBC - static_cast<int64_t>(closestBcV0A);
+        int closestBcV0A = bcsWithV0A.findClosest(globalBC);
+        fitInfo.distClosestBcV0A = static_cast<int64_t>(globalBC) - bcsWithV0A.getGlobalBC(closestBcV0A);
         if (std::abs(fitInfo.distClosestBcV0A) <= fFilterFV0)
           return false;
-        auto fv0aId = mapGlobalBcWithV0A.at(closestBcV0A);
+        auto fv0aId = bcsWithV0A.getValue(closestBcV0A);
         auto fv0a = fv0as.iteratorAt(fv0aId);
         fitInfo.timeFV0A = fv0a.time();
         const auto& v0Amps = fv0a.amplitude();
@@ -897,9 +889,9 @@ struct UpcCandProducer {
       if (!updateFitInfo(globalBC, fitInfo))
         continue;
       if (nZdcs > 0) {
-        auto itZDC = mapGlobalBcWithZdc.find(globalBC);
-        if (itZDC != mapGlobalBcWithZdc.end()) {
-          const auto& zdc = zdcs.iteratorAt(itZDC->second);
+        int posZDC = bcsWithZdc.find(globalBC);
+        if (posZDC >= 0) {
+          const auto& zdc = zdcs.iteratorAt(bcsWithZdc.getValue(posZDC));
           float timeZNA = zdc.timeZNA();
           float timeZNC = zdc.timeZNC();
           float eComZNA = zdc.energyCommonZNA();
@@ -966,9 +958,9 @@ struct UpcCandProducer {
       if (!updateFitInfo(globalBC, fitInfo))
         continue;
       if (nZdcs > 0) {
-        auto itZDC = mapGlobalBcWithZdc.find(globalBC);
-        if (itZDC != mapGlobalBcWithZdc.end()) {
-          const auto& zdc = zdcs.iteratorAt(itZDC->second);
+        int posZDC = bcsWithZdc.find(globalBC);
+        if (posZDC >= 0) {
+          const auto& zdc = zdcs.iteratorAt(bcsWithZdc.getValue(posZDC));
           float timeZNA = zdc.timeZNA();
           float timeZNC = zdc.timeZNC();
           float eComZNA = zdc.energyCommonZNA();
@@ -1194,17 +1186,16 @@ struct UpcCandProducer {
 
   template <typename T>
   void fillAmplitudes(const T& t,
-                      const std::map<uint64_t, int32_t>& mapBCs,
+                      const bclookup::BcLookup<int32_t>& bcsWithSignal,
                       std::vector<float>& amps,
                       std::vector<int8_t>& relBCs,
                       int64_t gbc)
   {
     auto s = gbc - fBCWindowFITAmps;
     auto e = gbc + (fBCWindowFITAmps - 1);
-    auto it = mapBCs.lower_bound(s);
-    while (it->first <= e && it != mapBCs.end()) {
-      int i = it->first - s;
-      auto id = it->second;
+    for (int pos = bcsWithSignal.lowerBound(s); pos < bcsWithSignal.size() && bcsWithSignal.getGlobalBC(pos) <= e; ++pos) {
+      int i = bcsWithSignal.getGlobalBC(pos) - s;
+      auto id = bcsWithSignal.getValue(pos);
       const auto& row = t.iteratorAt(id);
       float totalAmp = 0.f;
       if constexpr (std::is_same_v<T, o2::aod::FT0s>) {
@@ -1219,7 +1210,6 @@ struct UpcCandProducer {
         amps.push_back(totalAmp);
         relBCs.push_back(gbc - (i + s));
       }
-      ++it;
     }
   }
 
@@ -1259,7 +1249,7 @@ struct UpcCandProducer {
     std::sort(bcsMatchedTrIdsMCH.begin(), bcsMatchedTrIdsMCH.end(),
               [](const auto& left, const auto& right) { return left.first < right.first; });
 
-    std::map<uint64_t, int32_t> mapGlobalBcWithT0A{};
+    bclookup::BcLookup<int32_t> bcsWithT0A;
     for (const auto& ft0 : ft0s) {
       if (!TESTBIT(ft0.triggerMask(), o2::fit::Triggers::bitVertex))
         continue;
@@ -1269,20 +1259,20 @@ struct UpcCandProducer {
       if (std::abs(ft0.timeA()) > 2.f)
         continue;
       uint64_t globalBC = ft0.bc_as<TBCs>().globalBC();
-      mapGlobalBcWithT0A[globalBC] = ft0.globalIndex();
+      bcsWithT0A.add(globalBC, ft0.globalIndex());
     }
 
-    std::map<uint64_t, int32_t> mapGlobalBcWithV0A{};
+    bclookup::BcLookup<int32_t> bcsWithV0A;
     for (const auto& fv0a : fv0as) {
       if (!TESTBIT(fv0a.triggerMask(), o2::fit::Triggers::bitA))
         continue;
       if (std::abs(fv0a.time()) > 15.f)
         continue;
       uint64_t globalBC = fv0a.bc_as<TBCs>().globalBC();
-      mapGlobalBcWithV0A[globalBC] = fv0a.globalIndex();
+      bcsWithV0A.add(globalBC, fv0a.globalIndex());
     }
 
-    std::map<uint64_t, int32_t> mapGlobalBcWithZdc{};
+    bclookup::BcLookup<int32_t> bcsWithZdc;
     for (const auto& zdc : zdcs) {
       if (std::abs(zdc.timeZNA()) > 2.f && std::abs(zdc.timeZNC()) > 2.f)
         continue;
@@ -1291,12 +1281,16 @@ struct UpcCandProducer {
       if (!(std::abs(zdc.timeZNC()) > 2.f))
         histRegistry.get<TH1>(HIST("hCountersTrg"))->Fill("ZNC", 1);
       auto globalBC = zdc.bc_as<TBCs>().globalBC();
-      mapGlobalBcWithZdc[globalBC] = zdc.globalIndex();
+      bcsWithZdc.add(globalBC, zdc.globalIndex());
     }
 
-    auto nFT0s = mapGlobalBcWithT0A.size();
-    auto nFV0As = mapGlobalBcWithV0A.size();
-    auto nZdcs = mapGlobalBcWithZdc.size();
+    for (auto* lookup : {&bcsWithT0A, &bcsWithV0A, &bcsWithZdc}) {
+      lookup->build();
+    }
+
+    auto nFT0s = bcsWithT0A.size();
+    auto nFV0As = bcsWithV0A.size();
+    auto nZdcs = bcsWithZdc.size();
     auto nBcsWithMCH = bcsMatchedTrIdsMCH.size();
 
     // todo: calculate position of UD collision?
@@ -1347,12 +1341,12 @@ struct UpcCandProducer {
       std::vector<int8_t> relBCsT0A{};
       std::vector<int8_t> relBCsV0A{};
       if (nFT0s > 0) {
-        uint64_t closestBcT0A = findClosestBC(globalBC, mapGlobalBcWithT0A);
-        int64_t distClosestBcT0A = globalBC - static_cast<int64_t>(closestBcT0A);
+        int closestBcT0A = bcsWithT0A.findClosest(globalBC);
+        int64_t distClosestBcT0A = static_cast<int64_t>(globalBC) - bcsWithT0A.getGlobalBC(closestBcT0A);
         if (std::abs(distClosestBcT0A) <= fFilterFT0)
           continue;
         fitInfo.distClosestBcT0A = distClosestBcT0A;
-        auto ft0Id = mapGlobalBcWithT0A.at(closestBcT0A);
+        auto ft0Id = bcsWithT0A.getValue(closestBcT0A);
         auto ft0 = ft0s.iteratorAt(ft0Id);
         fitInfo.timeFT0A = ft0.timeA();
         fitInfo.timeFT0C = ft0.timeC();
@@ -1360,25 +1354,25 @@ struct UpcCandProducer {
         const auto& t0AmpsC = ft0.amplitudeC();
         fitInfo.ampFT0A = std::accumulate(t0AmpsA.begin(), t0AmpsA.end(), 0.f);
         fitInfo.ampFT0C = std::accumulate(t0AmpsC.begin(), t0AmpsC.end(), 0.f);
-        fillAmplitudes(ft0s, mapGlobalBcWithT0A, amplitudesT0A, relBCsT0A, globalBC);
+        fillAmplitudes(ft0s, bcsWithT0A, amplitudesT0A, relBCsT0A, globalBC);
       }
       if (nFV0As > 0) {
-        uint64_t closestBcV0A = findClosestBC(globalBC, mapGlobalBcWithV0A);
-        int64_t distClosestBcV0A = globalBC - static_cast<int64_t>(closestBcV0A);
+        int closestBcV0A = bcsWithV0A.findClosest(globalBC);
+        int64_t distClosestBcV0A = static_cast<int64_t>(globalBC) - bcsWithV0A.getGlobalBC(closestBcV0A);
         if (std::abs(distClosestBcV0A) <= fFilterFV0)
           continue;
         fitInfo.distClosestBcV0A = distClosestBcV0A;
-        auto fv0aId = mapGlobalBcWithV0A.at(closestBcV0A);
+        auto fv0aId = bcsWithV0A.getValue(closestBcV0A);
         auto fv0a = fv0as.iteratorAt(fv0aId);
         fitInfo.timeFV0A = fv0a.time();
         const auto& v0Amps = fv0a.amplitude();
         fitInfo.ampFV0A = std::accumulate(v0Amps.begin(), v0Amps.end(), 0.f);
-        fillAmplitudes(fv0as, mapGlobalBcWithV0A, amplitudesV0A, relBCsV0A, globalBC);
+        fillAmplitudes(fv0as, bcsWithV0A, amplitudesV0A, relBCsV0A, globalBC);
       }
       if (nZdcs > 0) {
-        auto itZDC = mapGlobalBcWithZdc.find(globalBC);
-        if (itZDC != mapGlobalBcWithZdc.end()) {
-          const auto& zdc = zdcs.iteratorAt(itZDC->second);
+        int posZDC = bcsWithZdc.find(globalBC);
+        if (posZDC >= 0) {
+          const auto& zdc = zdcs.iteratorAt(bcsWithZdc.getValue(posZDC));
           float timeZNA = zdc.timeZNA();
           float timeZNC = zdc.timeZNC();
           float eComZNA = zdc.energyCommonZNA();
@@ -1423,8 +1417,8 @@ struct UpcCandProducer {
     ambFwdTrBCs.clear();
     bcsMatchedTrIdsMID.clear();
     bcsMatchedTrIdsMCH.clear();
-    mapGlobalBcWithT0A.clear();
-    mapGlobalBcWithV0A.clear();
+    bcsWithT0A.clear();
+    bcsWithV0A.clear();
   }
 
   template <typename TBCs>
@@ -1472,7 +1466,7 @@ struct UpcCandProducer {
     std::sort(bcsMatchedTrIdsGlobal.begin(), bcsMatchedTrIdsGlobal.end(),
               [](const auto& left, const auto& right) { return left.first < right.first; });
 
-    std::map<uint64_t, int32_t> mapGlobalBcWithT0A{};
+    bclookup::BcLookup<int32_t> bcsWithT0A;
     for (const auto& ft0 : ft0s) {
       if (!TESTBIT(ft0.triggerMask(), o2::fit::Triggers::bitVertex))
         continue;
@@ -1482,20 +1476,20 @@ struct UpcCandProducer {
       if (std::abs(ft0.timeA()) > 2.f)
         continue;
       uint64_t globalBC = ft0.bc_as<TBCs>().globalBC();
-      mapGlobalBcWithT0A[globalBC] = ft0.globalIndex();
+      bcsWithT0A.add(globalBC, ft0.globalIndex());
     }
 
-    std::map<uint64_t, int32_t> mapGlobalBcWithV0A{};
+    bclookup::BcLookup<int32_t> bcsWithV0A;
     for (const auto& fv0a : fv0as) {
       if (!TESTBIT(fv0a.triggerMask(), o2::fit::Triggers::bitA))
         continue;
       if (std::abs(fv0a.time()) > 15.f)
         continue;
       uint64_t globalBC = fv0a.bc_as<TBCs>().globalBC();
-      mapGlobalBcWithV0A[globalBC] = fv0a.globalIndex();
+      bcsWithV0A.add(globalBC, fv0a.globalIndex());
     }
 
-    std::map<uint64_t, int32_t> mapGlobalBcWithZdc{};
+    bclookup::BcLookup<int32_t> bcsWithZdc;
     for (const auto& zdc : zdcs) {
       if (std::abs(zdc.timeZNA()) > 2.f && std::abs(zdc.timeZNC()) > 2.f)
         continue;
@@ -1504,12 +1498,16 @@ struct UpcCandProducer {
       if (!(std::abs(zdc.timeZNC()) > 2.f))
         histRegistry.get<TH1>(HIST("hCountersTrg"))->Fill("ZNC", 1);
       auto globalBC = zdc.bc_as<TBCs>().globalBC();
-      mapGlobalBcWithZdc[globalBC] = zdc.globalIndex();
+      bcsWithZdc.add(globalBC, zdc.globalIndex());
+    }
+
+    for (auto* lookup : {&bcsWithT0A, &bcsWithV0A, &bcsWithZdc}) {
+      lookup->build();
     }
 
-    auto nFT0s = mapGlobalBcWithT0A.size();
-    auto nFV0As = mapGlobalBcWithV0A.size();
-    auto nZdcs = mapGlobalBcWithZdc.size();
+    auto nFT0s = bcsWithT0A.size();
+    auto nFV0As = bcsWithV0A.size();
+    auto nZdcs = bcsWithZdc.size();
 
     // todo: calculate position of UD collision?
     float dummyX = 0.;
@@ -1547,12 +1545,12 @@ struct UpcCandProducer {
       std::vector<int8_t> relBCsT0A{};
       std::vector<int8_t> relBCsV0A{};
       if (nFT0s > 0) {
-        uint64_t closestBcT0A = findClosestBC(globalBC, mapGlobalBcWithT0A);
-        int64_t distClosestBcT0A = globalBC - static_cast<int64_t>(closestBcT0A);
+        int closestBcT0A = bcsWithT0A.findClosest(globalBC);
+        int64_t distClosestBcT0A = static_cast<int64_t>(globalBC) - bcsWithT0A.getGlobalBC(closestBcT0A);
         if (std::abs(distClosestBcT0A) <= fFilterFT0)
           continue;
         fitInfo.distClosestBcT0A = distClosestBcT0A;
-        auto ft0Id = mapGlobalBcWithT0A.at(closestBcT0A);
+        auto ft0Id = bcsWithT0A.getValue(closestBcT0A);
         auto ft0 = ft0s.iteratorAt(ft0Id);
         fitInfo.timeFT0A = ft0.timeA();
         fitInfo.timeFT0C = ft0.timeC();
@@ -1560,25 +1558,25 @@ struct UpcCandProducer {
         const auto& t0AmpsC = ft0.amplitudeC();
         fitInfo.ampFT0A = std::accumulate(t0AmpsA.begin(), t0AmpsA.end(), 0.f);
         fitInfo.ampFT0C = std::accumulate(t0AmpsC.begin(), t0AmpsC.end(), 0.f);
-        fillAmplitudes(ft0s, mapGlobalBcWithT0A, amplitudesT0A, relBCsT0A, globalBC);
+        fillAmplitudes(ft0s, bcsWithT0A, amplitudesT0A, relBCsT0A, globalBC);
       }
       if (nFV0As > 0) {
-        uint64_t closestBcV0A = findClosestBC(globalBC, mapGlobalBcWithV0A);
-        int64_t distClosestBcV0A = globalBC - static_cast<int64_t>(closestBcV0A);
+        int closestBcV0A = bcsWithV0A.findClosest(globalBC);
+        int64_t distClosestBcV0A = static_cast<int64_t>(globalBC) - bcsWithV0A.getGlobalBC(closestBcV0A);
         if (std::abs(distClosestBcV0A) <= fFilterFV0)
           continue;
         fitInfo.distClosestBcV0A = distClosestBcV0A;
-        auto fv0aId = mapGlobalBcWithV0A.at(closestBcV0A);
+        auto fv0aId = bcsWithV0A.getValue(closestBcV0A);
         auto fv0a = fv0as.iteratorAt(fv0aId);
         fitInfo.timeFV0A = fv0a.time();
         const auto& v0Amps = fv0a.amplitude();
         fitInfo.ampFV0A = std::accumulate(v0Amps.begin(), v0Amps.end(), 0.f);
-        fillAmplitudes(fv0as, mapGlobalBcWithV0A, amplitudesV0A, relBCsV0A, globalBC);
+        fillAmplitudes(fv0as, bcsWithV0A, amplitudesV0A, relBCsV0A, globalBC);
       }
       if (nZdcs > 0) {
-        auto itZDC = mapGlobalBcWithZdc.find(globalBC);
-        if (itZDC != mapGlobalBcWithZdc.end()) {
-          const auto& zdc = zdcs.iteratorAt(itZDC->second);
+        int posZDC = bcsWithZdc.find(globalBC);
+        if (posZDC >= 0) {
+          const auto& zdc = zdcs.iteratorAt(bcsWithZdc.getValue(posZDC));
           float timeZNA = zdc.timeZNA();
           float timeZNC = zdc.timeZNC();
           float eComZNA = zdc.energyCommonZNA();
@@ -1622,8 +1620,8 @@ struct UpcCandProducer {
     bcsMatchedTrIdsMID.clear();
     bcsMatchedTrIdsMCH.clear();
     bcsMatchedTrIdsGlobal.clear();
-    mapGlobalBcWithT0A.clear();
-    mapGlobalBcWithV0A.clear();
+    bcsWithT0A.clear();
+    bcsWithV0A.clear();
   }
 
   // data processors
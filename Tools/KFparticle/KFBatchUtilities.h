@@ -0,0 +1,245 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file KFBatchUtilities.h
+/// \brief Batched two-body KFParticle constructions with the SIMD types of the KFParticle package
+///
+/// The candidates are collected with their daughters and production vertex as scalar KFParticle objects (e.g. from
+/// createKFParticleFromTrackParCov), packed by float_vLen into KFParticleSIMD objects and constructed, constrained
+/// to their production vertex and measured lane by lane in vector registers. The results are returned per quantity
+/// (structure of arrays) with a validity flag per candidate, in the order in which the candidates were added.
+/// The construction method is set as for the scalar mother (SetConstructMethod), qaKFParticle compares both with
+/// validateBatchConstruction.
+
+#ifndef TOOLS_KFPARTICLE_KFBATCHUTILITIES_H_
+#define TOOLS_KFPARTICLE_KFBATCHUTILITIES_H_
+
+#ifndef HomogeneousField
+#define HomogeneousField
+#endif
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "KFParticle.h"
+#include "KFParticleDef.h"
+#include "KFParticleSIMD.h"
+
+/// @brief Results of a batch of two-body constructions, one entry per candidate
+struct KFTwoBodyBatchResults {
+  // mother at the decay vertex, without production-vertex constraint
+  std::vector<float> x, y, z;
+  std::vector<float> px, py, pz;
+  std::vector<float> mass, massErr;
+  std::vector<float> chi2Geo;           // chi2 / ndf of the construction
+  std::vector<float> distanceDaughters; // 3D distance between the daughters
+  std::vector<float> distanceToPV;      // 3D distance of the mother to the production vertex
+  std::vector<float> deviationFromPV;   // chi2 of the mother to the production vertex
+  // mother constrained to the production vertex
+  std::vector<float> chi2Topo; // chi2 / ndf after the constraint
+  std::vector<float> pxTopo, pyTopo, pzTopo;
+  // validity masks
+  std::vector<uint8_t> isValid;     // construction succeeded (finite parameters and covariance)
+  std::vector<uint8_t> isValidTopo; // production-vertex constraint succeeded
+
+  std::size_t size() const { return isValid.size(); }
+
+  void resize(std::size_t n)
+  {
+    for (auto* v : {&x, &y, &z, &px, &py, &pz, &mass, &massErr, &chi2Geo, &distanceDaughters, &distanceToPV, &deviationFromPV, &chi2Topo, &pxTopo, &pyTopo, &pzTopo}) {
+      v->resize(n);
+    }
+    isValid.resize(n);
+    isValidTopo.resize(n);
+  }
+};
+
+/// @brief Batch of two-body candidates constructed with KFParticleSIMD
+///
+/// KFParticleSIMD has its own static field, which KFParticle::SetField does not set. The Bz of the homogeneous field
+/// has therefore to be given with setField (applied to KFParticleSIMD in construct), otherwise the candidates are
+/// constructed in the field last set with KFParticleSIMD::SetField (0 if never set).
+///
+/// Usage:
+///   batch.setConstructMethod(2);
+///   batch.setField(bz); // e.g. once per run, with the value given to KFParticle::SetField
+///   batch.clear();
+///   for (...) { batch.add(kfPos, kfNeg, kfPV); }
+///   batch.construct();
+///   const auto& res = batch.getResults();
+///   for (std::size_t i = 0; i < res.size(); i++) { if (res.isValid[i]) { ... res.mass[i] ... } }
+///
+/// The scalar mother (and the mother constrained to the production vertex) of each candidate can be kept for the
+/// quantities not in the results, at the cost of a copy per candidate.
+class KFTwoBodyBatch
+{
+ public:
+  KFTwoBodyBatch() = default;
+
+  /// Construction method of the mother, as KFParticle::SetConstructMethod (the tasks use 2)
+  void setConstructMethod(int method) { mConstructMethod = method; }
+  /// Bz (kG) of the homogeneous field used in construct()
+  void setField(float bz)
+  {
+    mBz = bz;
+    mHasField = true;
+  }
+  /// Mass constraint of the mother in the construction, -1 for none
+  void setMassConstraint(float mass) { mMassConstraint = mass; }
+  /// Keep the scalar mother particles, see getMother() and getMotherTopo()
+  void setKeepParticles(bool keep) { mKeepParticles = keep; }
+
+  void clear()
+  {
+    mDaughters0.clear();
+    mDaughters1.clear();
+    mProductionVertices.clear();
+  }
+
+  std::size_t size() const { return mDaughters0.size(); }
+
+  /// Adds a candidate, its index in the results is the number of candidates added before
+  std::size_t add(const KFParticle& daughter0, const KFParticle& daughter1, const KFParticle& productionVertex)
+  {
+    mDaughters0.push_back(daughter0);
+    mDaughters1.push_back(daughter1);
+    mProductionVertices.push_back(productionVertex);
+    return mDaughters0.size() - 1;
+  }
+
+  /// Constructs all the candidates, with the production-vertex constraint if doTopoConstraint
+  void construct(bool doTopoConstraint = true)
+  {
+    const std::size_t n = size();
+    mResults.resize(n);
+    if (mHasField) {
+      KFParticleSIMD::SetField(mBz);
+    }
+    if (mKeepParticles) {
+      mMothers.resize(n);
+      mMothersTopo.resize(n);
+    }
+
+    KFParticle* lanes0[float_vLen];
+    KFParticle* lanes1[float_vLen];
+    KFParticle* lanesPV[float_vLen];
+    for (std::size_t first = 0; first < n; first += float_vLen) {
+      const int nLanes = (n - first < static_cast<std::size_t>(float_vLen)) ? n - first : float_vLen;
+      // unused lanes repeat the last candidate, their results are not stored
+      for (int iLane = 0; iLane < float_vLen; iLane++) {
+        std::size_t i = first + (iLane < nLanes ? iLane : nLanes - 1);
+        lanes0[iLane] = &mDaughters0[i];
+        lanes1[iLane] = &mDaughters1[i];
+        lanesPV[iLane] = &mProductionVertices[i];
+      }
+      KFParticleSIMD daughter0(lanes0, float_vLen);
+      KFParticleSIMD daughter1(lanes1, float_vLen);
+      KFParticleSIMD productionVertex(lanesPV, float_vLen);
+
+      KFParticleSIMD mother;
+      mother.SetConstructMethod(mConstructMethod);
+      const KFParticleSIMD* daughters[2] = {&daughter0, &daughter1};
+      mother.Construct(daughters, 2, nullptr, mMassConstraint);
+
+      float_v mass, massErr;
+      mother.GetMass(mass, massErr);
+      const float_v distanceDaughters = daughter0.GetDistanceFromParticle(daughter1);
+      const float_v distanceToPV = mother.GetDistanceFromVertex(productionVertex);
+      const float_v deviationFromPV = mother.GetDeviationFromVertex(productionVertex);
+
+      for (int iLane = 0; iLane < nLanes; iLane++) {
+        const std::size_t i = first + iLane;
+        mResults.x[i] = mother.GetX()[iLane];
+        mResults.y[i] = mother.GetY()[iLane];
+        mResults.z[i] = mother.GetZ()[iLane];
+        mResults.px[i] = mother.GetPx()[iLane];
+        mResults.py[i] = mother.GetPy()[iLane];
+        mResults.pz[i] = mother.GetPz()[iLane];
+        mResults.mass[i] = mass[iLane];
+        mResults.massErr[i] = massErr[iLane];
+        mResults.chi2Geo[i] = getChi2Ndf(mother, iLane);
+        mResults.distanceDaughters[i] = distanceDaughters[iLane];
+        mResults.distanceToPV[i] = distanceToPV[iLane];
+        mResults.deviationFromPV[i] = deviationFromPV[iLane];
+        mResults.isValid[i] = isValidLane(mother, iLane);
+        if (mKeepParticles) {
+          mother.GetKFParticle(mMothers[i], iLane);
+        }
+      }
+
+      if (!doTopoConstraint) {
+        for (int iLane = 0; iLane < nLanes; iLane++) {
+          mResults.isValidTopo[first + iLane] = false;
+        }
+        continue;
+      }
+      KFParticleSIMD motherTopo = mother;
+      motherTopo.SetProductionVertex(productionVertex);
+      for (int iLane = 0; iLane < nLanes; iLane++) {
+        const std::size_t i = first + iLane;
+        mResults.chi2Topo[i] = getChi2Ndf(motherTopo, iLane);
+        mResults.pxTopo[i] = motherTopo.GetPx()[iLane];
+        mResults.pyTopo[i] = motherTopo.GetPy()[iLane];
+        mResults.pzTopo[i] = motherTopo.GetPz()[iLane];
+        mResults.isValidTopo[i] = mResults.isValid[i] && isValidLane(motherTopo, iLane);
+        if (mKeepParticles) {
+          motherTopo.GetKFParticle(mMothersTopo[i], iLane);
+        }
+      }
+    }
+  }
+
+  const KFTwoBodyBatchResults& getResults() const { return mResults; }
+  /// Scalar mother of candidate i, only with setKeepParticles(true)
+  const KFParticle& getMother(std::size_t i) const { return mMothers[i]; }
+  /// Scalar mother of candidate i constrained to its production vertex, only with setKeepParticles(true)
+  const KFParticle& getMotherTopo(std::size_t i) const { return mMothersTopo[i]; }
+
+ private:
+  static float getChi2Ndf(const KFParticleSIMD& particle, int iLane)
+  {
+    const float ndf = particle.GetNDF()[iLane];
+    return ndf > 0.f ? particle.GetChi2()[iLane] / ndf : -1.f;
+  }
+
+  /// Finite parameters and non-negative diagonal of the covariance matrix
+  static bool isValidLane(const KFParticleSIMD& particle, int iLane)
+  {
+    for (int iPar = 0; iPar < 6; iPar++) {
+      if (!std::isfinite(particle.GetParameter(iPar)[iLane])) {
+        return false;
+      }
+    }
+    for (int iPar = 0; iPar < 6; iPar++) {
+      const float covDiag = particle.GetCovariance(iPar, iPar)[iLane];
+      if (!std::isfinite(covDiag) || covDiag < 0.f) {
+        return false;
+      }
+    }
+    return std::isfinite(particle.GetChi2()[iLane]);
+  }
+
+  int mConstructMethod = 0;
+  float mBz = 0.f;
+  bool mHasField = false;
+  float mMassConstraint = -1.f;
+  bool mKeepParticles = false;
+  std::vector<KFParticle> mDaughters0;
+  std::vector<KFParticle> mDaughters1;
+  std::vector<KFParticle> mProductionVertices;
+  KFTwoBodyBatchResults mResults;
+  std::vector<KFParticle> mMothers;
+  std::vector<KFParticle> mMothersTopo;
+};
+
+#endif // TOOLS_KFPARTICLE_KFBATCHUTILITIES_H_
@@ -43,6 +43,7 @@
 #include "Common/Core/TrackSelectionDefaults.h"
 #include "Common/Core/RecoDecay.h"
 #include "Tools/KFparticle/KFUtilities.h"
+#include "Tools/KFparticle/KFBatchUtilities.h"
 
 /// includes KFParticle
 #include "KFParticle.h"
@@ -121,6 +122,7 @@ struct qaKFParticle {
   Configurable<bool> writeTree{"writeTree", false, "write daughter variables in a tree"};
   Configurable<bool> writeHistograms{"writeHistograms", true, "write histograms"};
   Configurable<bool> writeQAHistograms{"writeQAHistograms", false, "write all QA histograms"};
+  Configurable<bool> validateBatchConstruction{"validateBatchConstruction", false, "construct the D0 candidates also with KFTwoBodyBatch (KFParticleSIMD) and write the differences to the scalar construction"};
 
   // Define which track selection should be used:
   // 0 -> No track selection is applied
@@ -154,6 +156,9 @@ struct qaKFParticle {
   HistogramRegistry histos;
   /// Table to be produced
   Produces<o2::aod::TreeKF> rowKF;
+  /// Batched construction of the D0 candidates of a collision and the scalar ones in the same order, for validateBatchConstruction
+  KFTwoBodyBatch batchDZero;
+  std::vector<KFParticle> scalarDZero;
 
   void initMagneticFieldCCDB(o2::aod::BCsWithTimestamps::iterator const& bc, int& mRunNumber,
                              o2::framework::Service<o2::ccdb::BasicCCDBManager> const& ccdb, std::string ccdbPathGrp, o2::base::MatLayerCylSet* lut,
@@ -321,6 +326,14 @@ struct qaKFParticle {
       histos.add("DZeroCandGeo/deviationDToPVXY", "deviation to PV in xy plane", kTH1D, {{100, 0., 5.}});
       histos.add("DZeroCandGeo/cosThetaStar", "cosine theta star", kTH1D, {{100, -1., 1.}});
     }
+    if (validateBatchConstruction) {
+      batchDZero.setConstructMethod(2);
+      histos.add("BatchValidation/isValid", "validity of the batched construction", kTH1D, {{2, -0.5, 1.5}});
+      histos.add("BatchValidation/deltaMass", "mass batched - scalar;#Delta#it{M} (GeV/#it{c}^{2})", kTH1D, {{200, -1.e-4, 1.e-4}});
+      histos.add("BatchValidation/deltaX", "X batched - scalar;#Delta#it{x} (cm)", kTH1D, {{200, -1.e-4, 1.e-4}});
+      histos.add("BatchValidation/deltaChi2Geo", "Chi2OverNDF batched - scalar", kTH1D, {{200, -1.e-3, 1.e-3}});
+      histos.add("BatchValidation/deltaChi2Topo", "Chi2OverNDF with PV constraint batched - scalar", kTH1D, {{200, -1.e-3, 1.e-3}});
+    }
     LOGF(info, "End of init");
     histos.print();
   } /// End init
@@ -648,6 +661,32 @@ struct qaKFParticle {
     }
   }
 
+  /// Constructs the D0 candidates of a collision with KFTwoBodyBatch and fills the differences to the scalar construction
+  void fillBatchValidation(const KFParticle& KFPV)
+  {
+    batchDZero.construct();
+    const auto& results = batchDZero.getResults();
+    for (std::size_t i = 0; i < results.size(); i++) {
+      histos.fill(HIST("BatchValidation/isValid"), results.isValid[i]);
+      if (!results.isValid[i]) {
+        continue;
+      }
+      const auto& KFDZero = scalarDZero[i];
+      float mass, massErr;
+      KFDZero.GetMass(mass, massErr);
+      histos.fill(HIST("BatchValidation/deltaMass"), results.mass[i] - mass);
+      histos.fill(HIST("BatchValidation/deltaX"), results.x[i] - KFDZero.GetX());
+      histos.fill(HIST("BatchValidation/deltaChi2Geo"), results.chi2Geo[i] - KFDZero.GetChi2() / KFDZero.GetNDF());
+      if (results.isValidTopo[i]) {
+        KFParticle KFDZero_PV = KFDZero;
+        KFDZero_PV.SetProductionVertex(KFPV);
+        histos.fill(HIST("BatchValidation/deltaChi2Topo"), results.chi2Topo[i] - KFDZero_PV.GetChi2() / KFDZero_PV.GetNDF());
+      }
+    }
+    batchDZero.clear();
+    scalarDZero.clear();
+  }
+
   /// Process function for data
   void processData(soa::Filtered<CollisionTableData>::iterator const& collision, soa::Filtered<TrackTableData> const& tracks, aod::BCsWithTimestamps const&)
   {
@@ -659,6 +698,7 @@ struct qaKFParticle {
 #ifdef HomogeneousField
       KFParticle::SetField(magneticField);
 #endif
+      batchDZero.setField(magneticField);
     }
 
     histos.fill(HIST("DZeroCandTopo/Selections"), 1.f);
@@ -790,6 +830,10 @@ struct qaKFParticle {
         KFDZero.SetConstructMethod(2);
         KFDZero.Construct(D0Daughters, NDaughters);
         histos.fill(HIST("DZeroCandTopo/Selections"), 10.f);
+        if (validateBatchConstruction) {
+          batchDZero.add(KFPosPion, KFNegKaon, KFPV);
+          scalarDZero.push_back(KFDZero);
+        }
         /// Apply daughter selection
         if (!isSelectedDaughters(KFPosPion, KFNegKaon, KFDZero, KFPV)) {
           continue;
@@ -825,6 +869,10 @@ struct qaKFParticle {
         KFDZeroBar.SetConstructMethod(2);
         KFDZeroBar.Construct(D0BarDaughters, NDaughters);
         histos.fill(HIST("DZeroCandTopo/Selections"), 10.f);
+        if (validateBatchConstruction) {
+          batchDZero.add(KFNegPion, KFPosKaon, KFPV);
+          scalarDZero.push_back(KFDZeroBar);
+        }
         /// Apply daughter selection
         if (!isSelectedDaughters(KFNegPion, KFPosKaon, KFDZeroBar, KFPV)) {
           continue;
@@ -855,6 +903,9 @@ struct qaKFParticle {
         writeVarTree(kfpTrackNegPi, kfpTrackPosKa, KFNegPion, KFPosKaon, KFDZeroBar_PV, KFDZeroBar, KFPV, KFDZeroBar_DecayVtx, TPCnSigmaNegPi, TOFnSigmaNegPi, TPCnSigmaPosKa, TOFnSigmaPosKa, TPCNclsNegPi, TPCNclsPosKa, cosThetaStar, track1, source);
       }
     }
+    if (validateBatchConstruction) {
+      fillBatchValidation(KFPV);
+    }
   }
   PROCESS_SWITCH(qaKFParticle, processData, "process data", true);
 
@@ -14,6 +14,7 @@
 
 #include <cmath>
 #include <memory>
+#include <vector>
 #include "Framework/AnalysisTask.h"
 #include "Framework/runDataProcessing.h"
 #include "Common/DataModel/EventSelection.h"
@@ -47,6 +48,8 @@ struct KaonPidTask {
   Preslice<aod::Tracks> perCol = aod::track::collisionId;
 
   std::shared_ptr<PidONNXModel> pidModel; // creates a shared pointer to a new instance 'pidmodel'.
+  std::vector<bool> acceptedPositive;     // model decisions of the positive tracks of the collision, in group order
+  std::vector<bool> acceptedNegative;     // model decisions of the negative tracks of the collision, in group order
   HistogramRegistry histos{"Histos", {}, OutputObjHandlingPolicy::AnalysisObject};
 
   Configurable<float> cfgZvtxCut{"cfgZvtxCut", 10, "Z vtx cut"};
@@ -96,37 +99,51 @@ struct KaonPidTask {
   {
     auto groupPositive = positive->sliceByCached(aod::track::collisionId, coll.globalIndex(), cache);
     auto groupNegative = negative->sliceByCached(aod::track::collisionId, coll.globalIndex(), cache);
+
+    // one batched inference per group, the decisions are indexed by the position of the track in the group
+    pidModel.get()->applyModelBooleanBatch(groupPositive, acceptedPositive);
+    int iTrack = 0;
     for (auto track : groupPositive) {
       histos.fill(HIST("hChargePos"), track.sign());
-      if (pidModel.get()->applyModelBoolean(track)) {
+      if (acceptedPositive[iTrack++]) {
         histos.fill(HIST("hdEdXvsMomentum"), track.p(), track.tpcSignal());
       }
     }
 
+    pidModel.get()->applyModelBooleanBatch(groupNegative, acceptedNegative);
+    iTrack = 0;
     for (auto track : groupNegative) {
       histos.fill(HIST("hChargeNeg"), track.sign());
-      if (pidModel.get()->applyModelBoolean(track)) {
+      if (acceptedNegative[iTrack++]) {
         histos.fill(HIST("hdEdXvsMomentum"), track.p(), track.tpcSignal());
       }
     }
 
-    for (auto& [pos, neg] : combinations(soa::CombinationsFullIndexPolicy(groupPositive, groupNegative))) {
-      if (!(pidModel.get()->applyModelBoolean(pos)) || !(pidModel.get()->applyModelBoolean(neg))) {
+    // all positive-negative pairs, as CombinationsFullIndexPolicy
+    int iPos = 0;
+    for (auto pos : groupPositive) {
+      if (!acceptedPositive[iPos++]) {
         continue;
       }
+      int iNeg = 0;
+      for (auto neg : groupNegative) {
+        if (!acceptedNegative[iNeg++]) {
+          continue;
+        }
 
-      TLorentzVector part1Vec;
-      TLorentzVector part2Vec;
-      float mMassOne = TDatabasePDG::Instance()->GetParticle(cfgPid.value)->Mass();
-      float mMassTwo = TDatabasePDG::Instance()->GetParticle(cfgPid.value)->Mass();
+        TLorentzVector part1Vec;
+        TLorentzVector part2Vec;
+        float mMassOne = TDatabasePDG::Instance()->GetParticle(cfgPid.value)->Mass();
+        float mMassTwo = TDatabasePDG::Instance()->GetParticle(cfgPid.value)->Mass();
 
-      part1Vec.SetPtEtaPhiM(pos.pt(), pos.eta(), pos.phi(), mMassOne);
-      part2Vec.SetPtEtaPhiM(neg.pt(), neg.eta(), neg.phi(), mMassTwo);
+        part1Vec.SetPtEtaPhiM(pos.pt(), pos.eta(), pos.phi(), mMassOne);
+        part2Vec.SetPtEtaPhiM(neg.pt(), neg.eta(), neg.phi(), mMassTwo);
 
-      TLorentzVector sumVec(part1Vec);
-      sumVec += part2Vec;
+        TLorentzVector sumVec(part1Vec);
+        sumVec += part2Vec;
 
-      histos.fill(HIST("hInvariantMass"), sumVec.M());
+        histos.fill(HIST("hInvariantMass"), sumVec.M());
+      }
     }
   }
 };
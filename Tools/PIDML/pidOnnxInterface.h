@@ -102,6 +102,33 @@ struct PidONNXInterface {
     return false;
   }
 
+  /// Certainties of the model of pid for all the tracks, in the order of iteration
+  template <typename T>
+  void applyModelBatch(const T& tracks, int pid, std::vector<float>& certainties)
+  {
+    for (std::size_t i = 0; i < mNPids; i++) {
+      if (mModels[i].mPid == pid) {
+        mModels[i].applyModelBatch(tracks, certainties);
+        return;
+      }
+    }
+    LOG(error) << "No suitable PID ML model found for expected pid: " << pid;
+    certainties.assign(tracks.size(), -1.0f);
+  }
+
+  template <typename T>
+  void applyModelBooleanBatch(const T& tracks, int pid, std::vector<bool>& accepted)
+  {
+    for (std::size_t i = 0; i < mNPids; i++) {
+      if (mModels[i].mPid == pid) {
+        mModels[i].applyModelBooleanBatch(tracks, accepted);
+        return;
+      }
+    }
+    LOG(error) << "No suitable PID ML model found for expected pid: " << pid;
+    accepted.assign(tracks.size(), false);
+  }
+
  private:
   void fillDefaultConfiguration(std::vector<double>& minCertainties)
   {
@@ -147,6 +147,23 @@ struct PidONNXModel {
     return getModelOutput(track) >= mMinCertainty;
   }
 
+  /// Certainties of all the tracks, in the order of iteration, with one inference per detector configuration
+  template <typename T>
+  void applyModelBatch(const T& tracks, std::vector<float>& certainties)
+  {
+    getModelOutputBatch(tracks, certainties);
+  }
+
+  template <typename T>
+  void applyModelBooleanBatch(const T& tracks, std::vector<bool>& accepted)
+  {
+    getModelOutputBatch(tracks, mBatchCertainties);
+    accepted.resize(mBatchCertainties.size());
+    for (std::size_t i = 0; i < mBatchCertainties.size(); i++) {
+      accepted[i] = mBatchCertainties[i] >= mMinCertainty;
+    }
+  }
+
   int mPid;
   double mMinCertainty;
 
@@ -213,15 +230,33 @@ struct PidONNXModel {
     }
   }
 
+  // Detector configuration of the inputs of a track: bit 0 if TOF is used, bit 1 if TRD is used.
+  // The signals of the unused detectors are passed as quiet_NaNs.
+  template <typename T>
+  int getInputConfig(const T& track)
+  {
+    bool useTRD = inPLimit(track, mPLimits[kTPCTOFTRD]) && !trdMissing(track);
+    bool useTOF = inPLimit(track, mPLimits[kTPCTOF]) && !tofMissing(track);
+    return (useTRD << 1) | useTOF;
+  }
+
   template <typename T>
   std::vector<float> createInputsSingle(const T& track)
+  {
+    std::vector<float> inputValues;
+    appendInputs(track, inputValues);
+    return inputValues;
+  }
+
+  template <typename T>
+  void appendInputs(const T& track, std::vector<float>& inputValues)
   {
     // TODO: Hardcoded for now. Planning to implement RowView extension to get runtime access to selected columns
     // sign is short, trackType and tpcNClsShared uint8_t
 
     float scaledTPCSignal = (track.tpcSignal() - mScalingParams.at("fTPCSignal").first) / mScalingParams.at("fTPCSignal").second;
 
-    std::vector<float> inputValues{scaledTPCSignal};
+    inputValues.push_back(scaledTPCSignal);
 
     // When TRD Signal shouldn't be used we pass quiet_NaNs to the network
     if (!inPLimit(track, mPLimits[kTPCTOFTRD]) || trdMissing(track)) {
@@ -253,22 +288,57 @@ struct PidONNXModel {
     float scaledDcaZ = (track.dcaZ() - mScalingParams.at("fDcaZ").first) / mScalingParams.at("fDcaZ").second;
 
     inputValues.insert(inputValues.end(), {track.p(), track.pt(), track.px(), track.py(), track.pz(), static_cast<float>(track.sign()), scaledX, scaledY, scaledZ, scaledAlpha, static_cast<float>(track.trackType()), scaledTPCNClsShared, scaledDcaXY, scaledDcaZ});
-
-    return inputValues;
   }
 
   template <typename T>
   float getModelOutput(const T& track)
   {
     // First rank of the expected model input is -1 which means that it is dynamic axis.
-    // Axis is exported as dynamic to make it possible to run model inference with the batch of
-    // tracks at once in the future (batch would need to have the same amount of quiet_NaNs in each row).
-    // For now we hardcode 1.
-    static constexpr int64_t batch_size = 1;
+    // Single tracks are run with batch size 1, see getModelOutputBatch() for batches.
+    std::vector<float> inputTensorValues = createInputsSingle(track);
+    float certainty = 0.0f;
+    runModel(inputTensorValues, 1, &certainty);
+    return certainty;
+  }
+
+  template <typename T>
+  void getModelOutputBatch(const T& tracks, std::vector<float>& certainties)
+  {
+    // The rows of a batch need to have the same amount of quiet_NaNs, so the tracks are grouped by
+    // the detectors whose signals are used and each group is run as one batch.
+    static constexpr int nInputConfigs = 4;
+    for (int iConfig = 0; iConfig < nInputConfigs; iConfig++) {
+      mBatchInputs[iConfig].clear();
+      mBatchRows[iConfig].clear();
+    }
+    int nTracks = 0;
+    for (const auto& track : tracks) {
+      int iConfig = getInputConfig(track);
+      appendInputs(track, mBatchInputs[iConfig]);
+      mBatchRows[iConfig].push_back(nTracks++);
+    }
+
+    certainties.assign(nTracks, 0.0f);
+    for (int iConfig = 0; iConfig < nInputConfigs; iConfig++) {
+      int64_t nRows = mBatchRows[iConfig].size();
+      if (nRows == 0) {
+        continue;
+      }
+      mBatchOutputs.resize(nRows);
+      if (runModel(mBatchInputs[iConfig], nRows, mBatchOutputs.data())) {
+        for (int64_t iRow = 0; iRow < nRows; iRow++) {
+          certainties[mBatchRows[iConfig][iRow]] = mBatchOutputs[iRow];
+        }
+      }
+    }
+  }
+
+  // Runs the model on nRows rows of input values, the first output value of each row is written to certainties
+  bool runModel(std::vector<float>& inputTensorValues, int64_t nRows, float* certainties)
+  {
     auto input_shape = mInputShapes[0];
-    input_shape[0] = batch_size;
+    input_shape[0] = nRows;
 
-    std::vector<float> inputTensorValues = createInputsSingle(track);
     std::vector<Ort::Value> inputTensors;
 
 #if __has_include(<onnxruntime/core/session/onnxruntime_cxx_api.h>)
@@ -304,12 +374,15 @@ struct PidONNXModel {
       LOG(debug) << "output tensor shape: " << printShape(outputTensors[0].GetTensorTypeAndShapeInfo().GetShape());
 
       const float* output_value = outputTensors[0].GetTensorData<float>();
-      float certainty = *output_value;
-      return certainty;
+      const std::size_t rowSize = outputTensors[0].GetTensorTypeAndShapeInfo().GetElementCount() / nRows;
+      for (int64_t iRow = 0; iRow < nRows; iRow++) {
+        certainties[iRow] = output_value[iRow * rowSize];
+      }
+      return true;
     } catch (const Ort::Exception& exception) {
       LOG(error) << "Error running model inference: " << exception.what();
     }
-    return false; // unreachable code
+    return false;
   }
 
   // Pretty prints a shape dimension vector
@@ -338,6 +411,12 @@ struct PidONNXModel {
   std::vector<std::vector<int64_t>> mInputShapes;
   std::vector<std::string> mOutputNames;
   std::vector<std::vector<int64_t>> mOutputShapes;
+
+  // Buffers of the batched inference, per detector configuration of the inputs
+  std::array<std::vector<float>, 4> mBatchInputs;
+  std::array<std::vector<int>, 4> mBatchRows;
+  std::vector<float> mBatchOutputs;
+  std::vector<float> mBatchCertainties;
 };
 
 #endif // TOOLS_PIDML_PIDONNXMODEL_H_
@@ -15,6 +15,7 @@
 /// \author Maja Kabus <mkabus@cern.ch>
 
 #include <string>
+#include <vector>
 
 #include "Framework/runDataProcessing.h"
 #include "Framework/AnalysisTask.h"
@@ -40,6 +41,7 @@ DECLARE_SOA_TABLE(MlPidResults, "AOD", "MLPIDRESULTS", o2::soa::Index<>, mlpidre
 
 struct SimpleApplyOnnxInterface {
   PidONNXInterface pidInterface; // One instance to manage all needed ONNX models
+  std::vector<std::vector<bool>> acceptedTracks; // model decisions per pid for the tracks of a DF, from batched inference
 
   Configurable<LabeledArray<double>> cfgPTCuts{"pT_cuts", {pidml_pt_cuts::cuts[0], pidml_pt_cuts::nPids, pidml_pt_cuts::nCutVars, pidml_pt_cuts::pidLabels, pidml_pt_cuts::cutVarLabels}, "pT cuts for each output pid and each detector configuration"};
   Configurable<std::vector<int>> cfgPids{"pids", std::vector<int>{pidml_pt_cuts::pids_v}, "PIDs to predict"};
@@ -82,26 +84,40 @@ struct SimpleApplyOnnxInterface {
       pidInterface = PidONNXInterface(cfgPathLocal.value, cfgPathCCDB.value, cfgUseCCDB.value, ccdbApi, timestamp, cfgPids.value, cfgPTCuts.value, cfgCertainties.value, cfgAutoMode.value);
     }
 
+    acceptedTracks.resize(cfgPids.value.size());
+    for (std::size_t iPid = 0; iPid < cfgPids.value.size(); iPid++) {
+      pidInterface.applyModelBooleanBatch(tracks, cfgPids.value[iPid], acceptedTracks[iPid]);
+    }
+    int iTrack = 0;
     for (auto& track : tracks) {
-      for (int pid : cfgPids.value) {
-        bool accepted = pidInterface.applyModelBoolean(track, pid);
+      for (std::size_t iPid = 0; iPid < cfgPids.value.size(); iPid++) {
+        int pid = cfgPids.value[iPid];
+        bool accepted = acceptedTracks[iPid][iTrack];
         LOGF(info, "collision id: %d track id: %d pid: %d accepted: %d p: %.3f; x: %.3f, y: %.3f, z: %.3f",
              track.collisionId(), track.index(), pid, accepted, track.p(), track.x(), track.y(), track.z());
         pidMLResults(track.index(), pid, accepted);
       }
+      iTrack++;
     }
   }
   PROCESS_SWITCH(SimpleApplyOnnxInterface, processCollisions, "Process with collisions and bcs for CCDB", true);
 
   void processTracksOnly(BigTracks const& tracks)
   {
+    acceptedTracks.resize(cfgPids.value.size());
+    for (std::size_t iPid = 0; iPid < cfgPids.value.size(); iPid++) {
+      pidInterface.applyModelBooleanBatch(tracks, cfgPids.value[iPid], acceptedTracks[iPid]);
+    }
+    int iTrack = 0;
     for (auto& track : tracks) {
-      for (int pid : cfgPids.value) {
-        bool accepted = pidInterface.applyModelBoolean(track, pid);
+      for (std::size_t iPid = 0; iPid < cfgPids.value.size(); iPid++) {
+        int pid = cfgPids.value[iPid];
+        bool accepted = acceptedTracks[iPid][iTrack];
         LOGF(info, "collision id: %d track id: %d pid: %d accepted: %d p: %.3f; x: %.3f, y: %.3f, z: %.3f",
              track.collisionId(), track.index(), pid, accepted, track.p(), track.x(), track.y(), track.z());
         pidMLResults(track.index(), pid, accepted);
       }
+      iTrack++;
     }
   }
   PROCESS_SWITCH(SimpleApplyOnnxInterface, processTracksOnly, "Process with tracks only -- faster but no CCDB", false);
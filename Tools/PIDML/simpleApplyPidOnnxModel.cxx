@@ -15,6 +15,7 @@
 /// \author Maja Kabus <mkabus@cern.ch>
 
 #include <string>
+#include <vector>
 
 #include "Framework/runDataProcessing.h"
 #include "Framework/AnalysisTask.h"
@@ -40,6 +41,7 @@ DECLARE_SOA_TABLE(MlPidResults, "AOD", "MLPIDRESULTS", o2::soa::Index<>, mlpidre
 
 struct SimpleApplyOnnxModel {
   PidONNXModel pidModel; // One instance per model, e.g., one per each pid to predict
+  std::vector<bool> acceptedTracks; // model decisions of the tracks of a DF, from one batched inference
   Configurable<int> cfgPid{"pid", 211, "PID to predict"};
   Configurable<double> cfgCertainty{"certainty", 0.5, "Min certainty of the model to accept given particle to be of given kind"};
 
@@ -79,8 +81,10 @@ struct SimpleApplyOnnxModel {
       pidModel = PidONNXModel(cfgPathLocal.value, cfgPathCCDB.value, cfgUseCCDB.value, ccdbApi, timestamp, cfgPid.value, cfgCertainty.value);
     }
 
+    pidModel.applyModelBooleanBatch(tracks, acceptedTracks);
+    int iTrack = 0;
     for (auto& track : tracks) {
-      bool accepted = pidModel.applyModelBoolean(track);
+      bool accepted = acceptedTracks[iTrack++];
       LOGF(info, "collision id: %d track id: %d accepted: %d p: %.3f; x: %.3f, y: %.3f, z: %.3f",
            track.collisionId(), track.index(), accepted, track.p(), track.x(), track.y(), track.z());
       pidMLResults(track.index(), cfgPid.value, accepted);
@@ -90,8 +94,10 @@ struct SimpleApplyOnnxModel {
 
   void processTracksOnly(BigTracks const& tracks)
   {
+    pidModel.applyModelBooleanBatch(tracks, acceptedTracks);
+    int iTrack = 0;
     for (auto& track : tracks) {
-      bool accepted = pidModel.applyModelBoolean(track);
+      bool accepted = acceptedTracks[iTrack++];
       LOGF(info, "collision id: %d track id: %d accepted: %d p: %.3f; x: %.3f, y: %.3f, z: %.3f",
            track.collisionId(), track.index(), accepted, track.p(), track.x(), track.y(), track.z());
       pidMLResults(track.index(), cfgPid.value, accepted);